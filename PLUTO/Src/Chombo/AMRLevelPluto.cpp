@@ -9,6 +9,8 @@
 #endif
 
 #include <iomanip>
+#include <algorithm>
+#include <sys/time.h>
 
 #include "parstream.H"
 #include "ParmParse.H"
@@ -25,6 +27,107 @@
 
 #include "NamespaceHeader.H"
 
+#ifndef CHOMBO_TAG_BITMAP_RATIO
+ #define CHOMBO_TAG_BITMAP_RATIO  8  /* max ratio between the bounding box
+                                        of the local grids and their zones
+                                        for a level-wide tag bitmap */
+#endif
+
+#ifndef CHOMBO_H5_CHUNK
+ #define CHOMBO_H5_CHUNK  65536  /* chunk size (in elements) of deflated
+                                    datasets */
+#endif
+
+#ifndef SELF_GRAVITY_TOL
+ #define SELF_GRAVITY_TOL  1.e-8  /* multigrid stops when the residual is
+                                     smaller than SELF_GRAVITY_TOL times the
+                                     largest right hand side (or the initial
+                                     residual) */
+#endif
+
+#ifdef CH_USE_HDF5
+Vector<int> AMRLevelPluto::s_plotComps;
+bool AMRLevelPluto::s_plotSingle   = false;
+int  AMRLevelPluto::s_plotDeflate  = 0;
+int  AMRLevelPluto::s_plotMaxLevel = -1;
+bool AMRLevelPluto::s_plotRegion   = false;
+Real AMRLevelPluto::s_plotBeg[CH_SPACEDIM];
+Real AMRLevelPluto::s_plotEnd[CH_SPACEDIM];
+int  AMRLevelPluto::s_chkDeflate   = 0;
+#endif
+
+bool AMRLevelPluto::s_regridAdaptive = false;
+bool AMRLevelPluto::s_regridSkip     = false;
+Real AMRLevelPluto::s_regridStart    = -1.0;
+Real AMRLevelPluto::s_regridCost     = 0.0;
+
+#if SELF_GRAVITY == YES
+AMRMultiGrid<LevelData<FArrayBox> >* AMRLevelPluto::s_gravSolver  = NULL;
+AMRPoissonOpFactory*                 AMRLevelPluto::s_gravFactory = NULL;
+RelaxSolver<LevelData<FArrayBox> > AMRLevelPluto::s_gravBottom;
+bool AMRLevelPluto::s_gravRedefine = true;
+
+// Mean density (periodic domain), total mass and center of mass
+// (isolated domain) on the base level
+static Real s_gravRhoMean = 0.0;
+static Real s_gravMass    = 0.0;
+static Real s_gravCenter[CH_SPACEDIM];
+
+// Potential of the total mass placed at the center of mass
+static void GravityMonopole(Real*           a_pos,
+                            int*            a_dir,
+                            Side::LoHiSide* a_side,
+                            Real*           a_value)
+{
+  Real r2 = 0.0;
+  for (int dir = 0; dir < CH_SPACEDIM; dir++)
+  {
+    Real x = g_domBeg[dir] + a_pos[dir] - s_gravCenter[dir];
+    r2 += x*x;
+  }
+
+ #if DIMENSIONS == 1
+  a_value[0] = 2.0*CONST_PI*SELF_GRAVITY_G*s_gravMass*sqrt(r2);
+ #elif DIMENSIONS == 2
+  a_value[0] = SELF_GRAVITY_G*s_gravMass*log(r2);
+ #else
+  a_value[0] = -SELF_GRAVITY_G*s_gravMass/sqrt(r2);
+ #endif
+}
+
+// Boundary conditions for the potential: the monopole term at the
+// non-periodic boundaries of the domain
+static void GravityBC(FArrayBox&           a_state,
+                      const Box&           a_valid,
+                      const ProblemDomain& a_domain,
+                      Real                 a_dx,
+                      bool                 a_homogeneous)
+{
+  for (int dir = 0; dir < CH_SPACEDIM; dir++)
+  {
+    if (a_domain.isPeriodic(dir)) continue;
+
+    for (SideIterator sit; sit.ok(); ++sit)
+    {
+      Box ghostBox = adjCellBox(a_valid, dir, sit(), 1);
+      if (!a_domain.domainBox().contains(ghostBox))
+      {
+        DiriBC(a_state, a_valid, a_dx, a_homogeneous,
+               BCValueHolder(GravityMonopole), dir, sit(), 2);
+      }
+    }
+  }
+}
+#endif
+
+// Wall clock time in seconds
+static Real WallClock()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (Real)tv.tv_sec + 1.e-6*(Real)tv.tv_usec;
+}
+
 // Constructor
 AMRLevelPluto::AMRLevelPluto()
 {
@@ -36,6 +139,15 @@ AMRLevelPluto::AMRLevelPluto()
   m_patchPlutoFactory = NULL;
   m_patchPluto = NULL;
   m_paramsDefined = false;
+
+  m_tagDrift      = true;
+  m_tagCovered    = 0.0;
+  m_zoneCost      = 0.0;
+  m_stepsSinceTag = 0;
+
+ #if SELF_GRAVITY == YES
+  m_phiTime = -1.0;
+ #endif
 }
 
 // Destructor
@@ -245,6 +357,26 @@ Real AMRLevelPluto::advance()
 
   g_intStage = 1;
 
+  Real wallStart = (s_regridAdaptive ? WallClock():0.0);
+
+ #if SELF_GRAVITY == YES
+  // Potential at the beginning of the step: composite solve from the
+  // base level, level solve on the steps of the finer levels that do
+  // not start with it
+  if (m_level == 0)
+  {
+    int finest = 0;
+    Vector<AMRLevel*> hierarchy = getAMRLevelHierarchy();
+    while (finest + 1 < hierarchy.size() &&
+           hierarchy[finest + 1]->boxes().size() > 0) finest++;
+    solveSelfGravity(0, finest);
+  }
+  else if (Abs(m_time - m_phiTime) > 1.e-12*m_time)
+  {
+    solveSelfGravity(m_level, m_level);
+  }
+ #endif
+
   // Advance the solve one timestep
   newDt = m_levelPluto.step(m_UNew,
                             flux,
@@ -261,6 +393,9 @@ Real AMRLevelPluto::advance()
 
  #if (TIME_STEPPING == RK2)
   g_intStage = 2;
+  #if SELF_GRAVITY == YES
+   solveSelfGravity(m_level, m_level);
+  #endif
   Real DtCool; // The predictor returns the advective/diffusive timestep
                // The corrector returns the cooling timestep
   DtCool = m_levelPluto.step(m_UNew,
@@ -279,6 +414,15 @@ Real AMRLevelPluto::advance()
   newDt = Min(newDt,DtCool);
  #endif
 
+  // Measure the cost of a zone update for the regrid scheduler
+  if (s_regridAdaptive)
+  {
+    long numPts = 0;
+    for (dit.begin(); dit.ok(); ++dit) numPts += m_grids[dit()].numPts();
+    if (numPts > 0) m_zoneCost = (WallClock() - wallStart)/numPts;
+    m_stepsSinceTag++;
+  }
+
   // Update the time and store the new timestep
   m_time += m_dt;
   Real returnDt = m_cfl * newDt;
@@ -388,6 +532,9 @@ void AMRLevelPluto::tagCells(IntVectSet& a_tags)
     pout() << "AMRLevelPluto::tagCells " << m_level << endl;
   }
 
+  // Regrid cost is measured from the first tagging
+  if (s_regridStart < 0.0) s_regridStart = WallClock();
+
   // Create tags based on undivided gradient of density
   const DisjointBoxLayout& levelDomain = m_UNew.disjointBoxLayout();
   IntVectSet localTags;
@@ -420,11 +567,26 @@ void AMRLevelPluto::tagCells(IntVectSet& a_tags)
    const LevelData<FArrayBox>& dV = m_levelPluto.getdV();
   #endif
 
-  // Compute relative gradient
+  // Tags are collected into a bitmap (one bit per zone) covering all
+  // the boxes of this process, unless the boxes are so sparse that
+  // a bitmap per box is more economical
   DataIterator dit = levelDomain.dataIterator();
+  Box  localBox;
+  long localPts = 0;
+  for (dit.begin(); dit.ok(); ++dit){
+    const Box& b = levelDomain[dit()];
+    if (localBox.isEmpty()) localBox = b;
+    else                    localBox.minBox(b);
+    localPts += b.numPts();
+  }
+  bool levelBitmap = (localBox.numPts() <= CHOMBO_TAG_BITMAP_RATIO*localPts);
+  DenseIntVectSet levelTags(levelBitmap ? localBox:Box(), false);
+
+  // Compute relative gradient
+  FArrayBox gradFab;
   for (dit.begin(); dit.ok(); ++dit){
     const Box& b = levelDomain[dit()];
-    FArrayBox gradFab(b,1);
+    gradFab.resize(b,1);
     FArrayBox& UFab = m_UNew[dit()];
 
     #if GEOMETRY != CARTESIAN
@@ -436,13 +598,37 @@ void AMRLevelPluto::tagCells(IntVectSet& a_tags)
     m_patchPluto->computeRefGradient(gradFab, UFab, curdV, b); 
 
     // Tag where gradient exceeds threshold
-    BoxIterator bit(b);
-    for (bit.begin(); bit.ok(); ++bit){
-      const IntVect& iv = bit();
-      if (gradFab(iv) >= m_refineThresh) {
-        localTags |= iv;
+    DenseIntVectSet boxTags(levelBitmap ? Box():b, false);
+    DenseIntVectSet& tags = (levelBitmap ? levelTags:boxTags);
+    const Real *grad = gradFab.dataPtr(0);
+    for (BoxIterator bit(b); bit.ok(); ++bit, ++grad){
+      if (*grad >= m_refineThresh) tags |= bit();
+    }
+    if (!levelBitmap && !boxTags.isEmpty()) localTags |= IntVectSet(boxTags);
+  }
+  if (levelBitmap) localTags = IntVectSet(levelTags);
+
+  // Compare the tags with the grids of the next finer level: record
+  // whether any tag has left them and how many buffered tags they
+  // still cover (see preRegrid())
+  Vector<Box> finerBoxes;
+  if (s_regridAdaptive)
+  {
+    const AMRLevelPluto* amrGodFinerPtr = getFinerLevel();
+    if (amrGodFinerPtr != NULL)
+    {
+      finerBoxes = amrGodFinerPtr->m_level_grids;
+      for (int n = 0; n < finerBoxes.size(); n++)
+      {
+        finerBoxes[n].coarsen(m_ref_ratio);
       }
     }
+    IntVectSet outside(localTags);
+    for (int n = 0; n < finerBoxes.size() && !outside.isEmpty(); n++)
+    {
+      outside -= finerBoxes[n];
+    }
+    m_tagDrift = !outside.isEmpty();
   }
 
   localTags.grow(m_tagBufferSize);
@@ -453,6 +639,16 @@ void AMRLevelPluto::tagCells(IntVectSet& a_tags)
   localTagsBox &= m_problem_domain;
   localTags &= localTagsBox;
 
+  if (s_regridAdaptive)
+  {
+    IntVectSet outside(localTags);
+    for (int n = 0; n < finerBoxes.size(); n++)
+    {
+      outside -= finerBoxes[n];
+    }
+    m_tagCovered = (Real)(localTags.numPts() - outside.numPts());
+  }
+
   a_tags = localTags;
 }
 
@@ -479,6 +675,9 @@ void AMRLevelPluto::regrid(const Vector<Box>& a_newGrids)
     pout() << "AMRLevelPluto::regrid " << m_level << endl;
   }
 
+  // Keep grids and data if preRegrid() decided so
+  if (s_regridSkip) return;
+
   // Save original grids and load balance
   m_level_grids = a_newGrids;
   m_grids = loadBalance(a_newGrids);
@@ -503,6 +702,12 @@ void AMRLevelPluto::regrid(const Vector<Box>& a_newGrids)
 	m_UOld[dit()].copy(m_UNew[dit()]);
   }
 
+ #if SELF_GRAVITY == YES
+  // The old potential is the initial guess of the next solve
+  LevelData<FArrayBox> phiOld;
+  if (m_phi.isDefined()) phiOld.define(m_phi);
+ #endif
+
   // Reshape state with new grids
   IntVect ivGhost = m_numGhost*IntVect::Unit;
   m_UNew.define(m_grids,m_numStates,ivGhost);
@@ -524,8 +729,125 @@ void AMRLevelPluto::regrid(const Vector<Box>& a_newGrids)
                 m_UNew.interval());
 
   m_UOld.define(m_grids,m_numStates,ivGhost);
+
+ #if SELF_GRAVITY == YES
+  if (m_hasCoarser)
+  {
+    m_phiInterp.interpToFine(m_phi,getCoarserLevel()->m_phi);
+  }
+  if (phiOld.isDefined())
+  {
+    phiOld.copyTo(phiOld.interval(), m_phi, m_phi.interval());
+  }
+  if (m_level_grids.size() > 0) fillPhiGhosts();
+ #endif
 } 
 
+// Decide whether the new grids can be ignored
+void AMRLevelPluto::preRegrid(int a_base_level, const Vector<Vector<Box> >& a_newGrids)
+{
+  CH_assert(allDefined());
+
+  // The base level is the last one called
+  if (m_level != a_base_level) return;
+
+  s_regridSkip = false;
+
+  // Compare the old and new grids of the finer levels; regrid() is
+  // always needed to add or remove a level
+  bool sameGrids  = true;
+  bool sameLevels = true;
+  const Vector<Box> noBoxes;
+  for (AMRLevelPluto* lev = getFinerLevel(); lev != NULL; lev = lev->getFinerLevel())
+  {
+    int l = lev->m_level;
+    const Vector<Box>& newBoxes = (l < a_newGrids.size() ? a_newGrids[l]:noBoxes);
+    const Vector<Box>& oldBoxes = lev->m_level_grids;
+    if ((newBoxes.size() > 0) != (oldBoxes.size() > 0)) sameLevels = false;
+    if (newBoxes.constStdVector() != oldBoxes.constStdVector()) sameGrids = false;
+  }
+
+  if (sameGrids)
+  {
+    s_regridSkip = true;
+  }
+  else if (s_regridAdaptive && sameLevels)
+  {
+    // Regrid if any tag has left the finer grids; otherwise predict
+    // the cost of updating the zones that the buffered tags no longer
+    // need (with r substeps of level l+1 for every step of level l)
+    // until the next regrid of this level
+    bool drift = false;
+    Real waste = 0.0;
+    for (AMRLevelPluto* lev = this; lev->getFinerLevel() != NULL; lev = lev->getFinerLevel())
+    {
+      AMRLevelPluto* fine = lev->getFinerLevel();
+      if (fine->m_level_grids.size() == 0) break;
+
+      Real local[3], global[3];
+      local[0] = (lev->m_tagDrift ? 1.0:0.0);
+      local[1] = lev->m_tagCovered;
+      local[2] = fine->m_zoneCost;
+     #ifdef CH_MPI
+      int result = MPI_Allreduce(local, global, 3, MPI_CH_REAL,
+                                 MPI_SUM, Chombo_MPI::comm);
+      if (result != MPI_SUCCESS)
+      {
+        MayDay::Error("AMRLevelPluto::preRegrid: communication error");
+      }
+     #else
+      for (int n = 0; n < 3; n++) global[n] = local[n];
+     #endif
+      if (global[0] > 0.0) drift = true;
+
+      Real finePts = 0.0;
+      for (int n = 0; n < fine->m_level_grids.size(); n++)
+      {
+        finePts += fine->m_level_grids[n].numPts();
+      }
+      Real r    = lev->m_ref_ratio;
+      Real over = finePts - global[1]*pow(r, SpaceDim);
+      waste += Max(over, 0.0)*r*global[2]/numProc()*Max(lev->m_stepsSinceTag, 1);
+    }
+    s_regridSkip = !drift && waste < s_regridCost;
+
+    if (s_verbosity >= 2)
+    {
+      pout() << "AMRLevelPluto::preRegrid: tags "
+             << (drift ? "outside":"inside") << " the finer grids, "
+             << "predicted over-refinement cost = " << waste << " s" << endl;
+    }
+  }
+
+  for (AMRLevelPluto* lev = this; lev != NULL; lev = lev->getFinerLevel())
+  {
+    lev->m_stepsSinceTag = 0;
+  }
+}
+
+// Report the cost of the regrid in the step log
+void AMRLevelPluto::postRegrid(int a_base_level)
+{
+  CH_assert(allDefined());
+
+  if (m_level != a_base_level) return;
+
+  if (s_regridStart >= 0.0)
+  {
+    Real cost = WallClock() - s_regridStart;
+    if (!s_regridSkip) s_regridCost = cost;
+    if (s_verbosity >= 1)
+    {
+      pout() << "regrid from level " << a_base_level << ": "
+             << (s_regridSkip ? "grids kept":"new grids")
+             << ";  wallclocktime = " << cost << endl;
+    }
+  }
+
+  s_regridStart = -1.0;
+  s_regridSkip  = false;
+}
+
 // Initialize grids
 void AMRLevelPluto::initialGrid(const Vector<Box>& a_newGrids)
 {
@@ -584,6 +906,9 @@ void AMRLevelPluto::postInitialize()
     pout() << "AMRLevelPluto::postInitialize " << m_level << endl;
   }
 
+  // Initial tagging is not part of a regrid
+  s_regridStart = -1.0;
+
   if (m_hasFiner)
   {
     // Volume weighted average from finer level data
@@ -736,8 +1061,12 @@ void AMRLevelPluto::writeCheckpointLevel(HDF5Handle& a_handle) const
      #endif
     #endif
    }
-   write(a_handle,tmp_U.boxLayout());
-   write(a_handle,tmp_U,"data");
+   if (s_chkDeflate > 0) {
+     writeLevelData(a_handle, tmp_U, false, s_chkDeflate);
+   } else {
+     write(a_handle,tmp_U.boxLayout());
+     write(a_handle,tmp_U,"data");
+   }
   #else
    if (g_stretch_fact != 1.) {
     LevelData<FArrayBox> tmp_U;
@@ -749,8 +1078,14 @@ void AMRLevelPluto::writeCheckpointLevel(HDF5Handle& a_handle) const
      tmp_U[dit()].copy(m_UNew[dit()]);    
      tmp_U[dit()] /= g_stretch_fact;
     }
-    write(a_handle,tmp_U.boxLayout());
-    write(a_handle,tmp_U,"data");
+    if (s_chkDeflate > 0) {
+     writeLevelData(a_handle, tmp_U, false, s_chkDeflate);
+    } else {
+     write(a_handle,tmp_U.boxLayout());
+     write(a_handle,tmp_U,"data");
+    }
+   } else if (s_chkDeflate > 0) {
+    writeLevelData(a_handle, m_UNew, false, s_chkDeflate);
    } else {
     write(a_handle,m_UNew.boxLayout());
     write(a_handle,m_UNew,"data");
@@ -1046,16 +1381,18 @@ void AMRLevelPluto::writePlotHeader(HDF5Handle& a_handle) const
     pout() << "AMRLevelPluto::writePlotHeader" << endl;
   }
 
-  // Setup the number of components
+  // Setup the number of components (all of them unless Plot_vars is given)
   HDF5HeaderData header;
-  header.m_int["num_components"] = m_numStates;
+  int numPlot = (s_plotComps.size() > 0 ? s_plotComps.size():m_numStates);
+  header.m_int["num_components"] = numPlot;
 
   // Setup the component names
   char compStr[30];
-  for (int comp = 0; comp < m_numStates; ++comp)
+  for (int comp = 0; comp < numPlot; ++comp)
   {
     sprintf(compStr,"component_%d",comp);
-    header.m_string[compStr] = m_PrimStateNames[comp];
+    int ivar = (s_plotComps.size() > 0 ? s_plotComps[comp]:comp);
+    header.m_string[compStr] = m_PrimStateNames[ivar];
   }
 
   // Write the header
@@ -1076,6 +1413,64 @@ void AMRLevelPluto::writePlotLevel(HDF5Handle& a_handle) const
 {
   CH_assert(allDefined());
 
+  // Levels above Plot_max_level are not written
+  if (s_plotMaxLevel >= 0 && m_level > s_plotMaxLevel) return;
+
+  // Restrict the output boxes to the region of interest, if any.
+  // Since finer grids are nested in coarser ones, an empty
+  // intersection on this level is empty on all finer levels too.
+  DisjointBoxLayout plotGrids;
+  if (!s_plotRegion)
+  {
+    plotGrids = m_grids;
+  }
+  else
+  {
+    Box region = m_problem_domain.domainBox();
+    for (int dir = 0; dir < DIMENSIONS; dir++)
+    {
+      Real dx = m_dx, beg = s_plotBeg[dir], end = s_plotEnd[dir];
+      if (dir == JDIR) dx *= g_x2stretch;
+      if (dir == KDIR) dx *= g_x3stretch;
+     #if CHOMBO_LOGR == YES
+      if (dir == IDIR)
+      {
+        beg = g_domBeg[IDIR] + log(beg/g_domBeg[IDIR]);
+        end = g_domBeg[IDIR] + log(end/g_domBeg[IDIR]);
+      }
+     #endif
+      int ibeg = (int)floor((beg - g_domBeg[dir])/dx);
+      int iend = (int)ceil ((end - g_domBeg[dir])/dx) - 1;
+      region.setSmall(dir, Max(ibeg, region.smallEnd(dir)));
+      region.setBig  (dir, Min(iend, region.bigEnd(dir)));
+    }
+
+    Vector<Box> boxes;
+    Vector<int> procs;
+    if (!region.isEmpty())
+    {
+      for (LayoutIterator lit = m_grids.layoutIterator(); lit.ok(); ++lit)
+      {
+        Box b = m_grids[lit()] & region;
+        if (b.isEmpty()) continue;
+        boxes.push_back(b);
+        procs.push_back(m_grids.procID(lit()));
+      }
+    }
+    if (boxes.size() == 0) return;
+    plotGrids.define(boxes, procs, m_problem_domain);
+  }
+
+  // The plotfile header written by AMR counts all levels:
+  // lower it to the finest level actually written
+  if (s_plotMaxLevel >= 0 || s_plotRegion)
+  {
+    a_handle.setGroup("/");
+    HDF5HeaderData root;
+    root.m_int["num_levels"] = m_level + 1;
+    root.writeToFile(a_handle);
+  }
+
   // Setup the level string
   char levelStr[20];
   sprintf(levelStr,"%d",m_level);
@@ -1149,11 +1544,327 @@ void AMRLevelPluto::writePlotLevel(HDF5Handle& a_handle) const
 
     m_patchPluto->convertFArrayBox(curU); /* -- convert data to primitive -- */
   }
-  write(a_handle,tmp_U.boxLayout());
-  write(a_handle,tmp_U,"data");
 
+  if (s_plotComps.size() == 0 && !s_plotRegion &&
+      !s_plotSingle && s_plotDeflate == 0)
+  {
+    write(a_handle,tmp_U.boxLayout());
+    write(a_handle,tmp_U,"data");
+    return;
+  }
+
+  // Extract the selected variables on the (possibly restricted) grids
+  int numPlot = (s_plotComps.size() > 0 ? s_plotComps.size():m_numStates);
+  LevelData<FArrayBox> plot_U(plotGrids, numPlot);
+  Copier copier(m_grids, plotGrids);
+  for (int comp = 0; comp < numPlot; comp++)
+  {
+    int ivar = (s_plotComps.size() > 0 ? s_plotComps[comp]:comp);
+    tmp_U.copyTo(Interval(ivar,ivar), plot_U, Interval(comp,comp), copier);
+  }
+
+  if (s_plotSingle || s_plotDeflate > 0)
+  {
+    writeLevelData(a_handle, plot_U, s_plotSingle, s_plotDeflate);
+  }
+  else
+  {
+    write(a_handle,plot_U.boxLayout());
+    write(a_handle,plot_U,"data");
+  }
+}
+
+// Order (layout index, data index) pairs by layout index
+static bool lessIndex(const std::pair<int,DataIndex>& a_x,
+                      const std::pair<int,DataIndex>& a_y)
+{
+  return a_x.first < a_y.first;
+}
+
+// Write a_U (valid zones only) in the same layout as Chombo's write()
+// for LevelData<FArrayBox>, optionally converting to single precision
+// and storing the data in chunked, deflated datasets.
+// Every process writes all of its boxes with a single H5Dwrite().
+void AMRLevelPluto::writeLevelData(HDF5Handle&                 a_handle,
+                                   const LevelData<FArrayBox>& a_U,
+                                   bool                        a_single,
+                                   int                         a_deflate) const
+{
+  const DisjointBoxLayout& grids = a_U.getBoxes();
+  int  ncomp = a_U.nComp();
+  int  nbox  = grids.size();
+  herr_t err;
+
+  // Boxes and processor map
+  write(a_handle, grids);
+
+  // Offsets of each box in the flat data array
+  Vector<long long> offsets(nbox+1);
+  offsets[0] = 0;
+  int index = 0;
+  for (LayoutIterator lit = grids.layoutIterator(); lit.ok(); ++lit, ++index)
+  {
+    offsets[index+1] = offsets[index] + (long long)grids[lit()].numPts()*ncomp;
+  }
+
+ #if defined(CH_MPI) && !H5_VERSION_GE(1,10,2)
+  // Parallel writes to filtered datasets need HDF5 >= 1.10.2
+  a_deflate = 0;
+ #endif
+
+  // Create the datasets
+  hsize_t dims[1];
+  hid_t   ftype = (a_single ? H5T_NATIVE_FLOAT:H5T_NATIVE_DOUBLE);
+  hid_t   dcpl  = H5Pcreate(H5P_DATASET_CREATE);
+  dims[0] = offsets[nbox];
+  if (a_deflate > 0 && dims[0] > 0)
+  {
+    hsize_t chunk[1];
+    chunk[0] = Min((hsize_t)CHOMBO_H5_CHUNK, dims[0]);
+    H5Pset_chunk(dcpl, 1, chunk);
+    H5Pset_deflate(dcpl, a_deflate);
+  }
+  hid_t dspace = H5Screate_simple(1, dims, NULL);
+ #ifdef H516
+  hid_t dset = H5Dcreate(a_handle.groupID(), "data:datatype=0", ftype,
+                         dspace, dcpl);
+ #else
+  hid_t dset = H5Dcreate2(a_handle.groupID(), "data:datatype=0", ftype,
+                          dspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+ #endif
+  if (dset < 0)
+  {
+    MayDay::Error("AMRLevelPluto::writeLevelData: cannot create dataset");
+  }
+
+  hsize_t odims[1];
+  odims[0] = nbox + 1;
+  hid_t ospace = H5Screate_simple(1, odims, NULL);
+ #ifdef H516
+  hid_t oset = H5Dcreate(a_handle.groupID(), "data:offsets=0",
+                         H5T_NATIVE_LLONG, ospace, H5P_DEFAULT);
+ #else
+  hid_t oset = H5Dcreate2(a_handle.groupID(), "data:offsets=0",
+                          H5T_NATIVE_LLONG, ospace, H5P_DEFAULT,
+                          H5P_DEFAULT, H5P_DEFAULT);
+ #endif
+  if (procID() == 0)
+  {
+    err = H5Dwrite(oset, H5T_NATIVE_LLONG, ospace, ospace,
+                   H5P_DEFAULT, &(offsets[0]));
+    CH_assert(err >= 0);
+  }
+  H5Dclose(oset);
+  H5Sclose(ospace);
+
+  HDF5HeaderData info;
+  info.m_int    ["comps"]       = ncomp;
+  info.m_string ["objectType"]  = "FArrayBox";
+  info.m_intvect["ghost"]       = a_U.ghostVect();
+  info.m_intvect["outputGhost"] = IntVect::Zero;
+  std::string group = a_handle.getGroup();
+  a_handle.setGroup(group + "/data_attributes");
+  info.writeToFile(a_handle);
+  a_handle.setGroup(group);
+
+  // Linearize local boxes (component by component, valid zones only)
+  // in increasing layout index, which is the order in which HDF5
+  // traverses a union of hyperslabs
+  Vector<std::pair<int,DataIndex> > local;
+  for (DataIterator dit = a_U.dataIterator(); dit.ok(); ++dit)
+  {
+    local.push_back(std::pair<int,DataIndex>(grids.index(dit()), dit()));
+  }
+  std::sort(local.stdVector().begin(), local.stdVector().end(), lessIndex);
+
+  long long npts = 0;
+  for (int n = 0; n < local.size(); n++)
+  {
+    npts += offsets[local[n].first+1] - offsets[local[n].first];
+  }
+
+  Vector<double> dbuf(a_single ? 0:npts);
+  Vector<float>  fbuf(a_single ? npts:0);
+  long long m = 0;
+  for (int n = 0; n < local.size(); n++)
+  {
+    const Box& b = grids[local[n].second];
+    const FArrayBox& U = a_U[local[n].second];
+    for (int comp = 0; comp < ncomp; comp++)
+    {
+      for (BoxIterator bit(b); bit.ok(); ++bit, ++m)
+      {
+        if (a_single) fbuf[m] = (float)U(bit(),comp);
+        else          dbuf[m] = U(bit(),comp);
+      }
+    }
+  }
+
+  // Select this process's part of the file and write it at once
+  hid_t mspace;
+  if (npts > 0)
+  {
+    dims[0] = npts;
+    mspace  = H5Screate_simple(1, dims, NULL);
+    for (int n = 0; n < local.size(); n++)
+    {
+      hsize_t start[1], count[1];
+      start[0] = offsets[local[n].first];
+      count[0] = offsets[local[n].first+1] - offsets[local[n].first];
+      H5Sselect_hyperslab(dspace, n == 0 ? H5S_SELECT_SET:H5S_SELECT_OR,
+                          start, NULL, count, NULL);
+    }
+  }
+  else
+  {
+    dims[0] = 1;
+    mspace  = H5Screate_simple(1, dims, NULL);
+    H5Sselect_none(mspace);
+    H5Sselect_none(dspace);
+  }
+
+  hid_t dxpl = H5P_DEFAULT;
+ #ifdef CH_MPI
+  dxpl = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+ #endif
+  void *buf = (npts == 0 ? NULL:(a_single ? (void *)&(fbuf[0])
+                                          : (void *)&(dbuf[0])));
+  err = H5Dwrite(dset, a_single ? H5T_NATIVE_FLOAT:H5T_NATIVE_DOUBLE,
+                 mspace, dspace, dxpl, buf);
+  if (err < 0)
+  {
+    MayDay::Error("AMRLevelPluto::writeLevelData: H5Dwrite failed");
+  }
+ #ifdef CH_MPI
+  H5Pclose(dxpl);
+ #endif
+
+  H5Sclose(mspace);
+  H5Sclose(dspace);
+  H5Dclose(dset);
+  H5Pclose(dcpl);
 }
 
+// Read the optional plot and checkpoint file keywords from pluto.ini
+void AMRLevelPluto::readOutputParams(const Vector<string>& a_primNames)
+{
+  // Plot_vars  name1 name2 ...  (written in the same order as the solver's)
+  s_plotComps.resize(0);
+  if (ParamExist("Plot_vars"))
+  {
+    for (int ivar = 0; ivar < a_primNames.size(); ivar++)
+    {
+      if (ParamFileHasBoth("Plot_vars", a_primNames[ivar].c_str()))
+      {
+        s_plotComps.push_back(ivar);
+      }
+    }
+    if (s_plotComps.size() == 0)
+    {
+      MayDay::Error("AMRLevelPluto::readOutputParams: no valid variable in Plot_vars");
+    }
+  }
+
+  // Plot_precision  single | double
+  s_plotSingle = false;
+  if (ParamExist("Plot_precision"))
+  {
+    string prec = ParamFileGet("Plot_precision", 1);
+    if      (prec == "single") s_plotSingle = true;
+    else if (prec != "double")
+    {
+      MayDay::Error("AMRLevelPluto::readOutputParams: Plot_precision must be single or double");
+    }
+  }
+
+  // Plot_compression / Checkpoint_compression  0..9
+  s_plotDeflate = s_chkDeflate = 0;
+  if (ParamExist("Plot_compression"))
+  {
+    s_plotDeflate = atoi(ParamFileGet("Plot_compression", 1));
+  }
+  if (ParamExist("Checkpoint_compression"))
+  {
+    s_chkDeflate = atoi(ParamFileGet("Checkpoint_compression", 1));
+  }
+  if (s_plotDeflate < 0 || s_plotDeflate > 9 ||
+      s_chkDeflate  < 0 || s_chkDeflate  > 9)
+  {
+    MayDay::Error("AMRLevelPluto::readOutputParams: compression level must be in [0,9]");
+  }
+
+  // Plot_max_level  L
+  s_plotMaxLevel = -1;
+  if (ParamExist("Plot_max_level"))
+  {
+    s_plotMaxLevel = atoi(ParamFileGet("Plot_max_level", 1));
+  }
+
+  // Plot_region  x1beg x1end  [x2beg x2end  [x3beg x3end]]
+  s_plotRegion = false;
+  if (ParamExist("Plot_region"))
+  {
+    s_plotRegion = true;
+    for (int dir = 0; dir < DIMENSIONS; dir++)
+    {
+      s_plotBeg[dir] = atof(ParamFileGet("Plot_region", 2*dir + 1));
+      s_plotEnd[dir] = atof(ParamFileGet("Plot_region", 2*dir + 2));
+      if (s_plotBeg[dir] >= s_plotEnd[dir] ||
+          s_plotEnd[dir] <= g_domBeg[dir]  ||
+          s_plotBeg[dir] >= g_domEnd[dir])
+      {
+        MayDay::Error("AMRLevelPluto::readOutputParams: Plot_region does not overlap the domain");
+      }
+    }
+  }
+
+  if (s_plotComps.size() > 0)
+  {
+    pout() << "plot variables = ";
+    for (int n = 0; n < s_plotComps.size(); n++)
+    {
+      pout() << a_primNames[s_plotComps[n]] << " ";
+    }
+    pout() << endl;
+  }
+  if (s_plotSingle)       pout() << "plot precision = single" << endl;
+  if (s_plotDeflate > 0)  pout() << "plot compression = " << s_plotDeflate << endl;
+  if (s_chkDeflate > 0)   pout() << "checkpoint compression = " << s_chkDeflate << endl;
+  if (s_plotMaxLevel >= 0) pout() << "plot max level = " << s_plotMaxLevel << endl;
+  if (s_plotRegion)
+  {
+    pout() << "plot region = ";
+    for (int dir = 0; dir < DIMENSIONS; dir++)
+    {
+      pout() << "[" << s_plotBeg[dir] << ", " << s_plotEnd[dir] << "] ";
+    }
+    pout() << endl;
+  }
+}
+
+#endif
+
+// Read the optional regrid scheduler keyword from pluto.ini
+void AMRLevelPluto::readRegridParams()
+{
+  // Regrid_adaptive  yes | no
+  s_regridAdaptive = false;
+  if (ParamExist("Regrid_adaptive"))
+  {
+    string adapt = ParamFileGet("Regrid_adaptive", 1);
+    if      (adapt == "yes") s_regridAdaptive = true;
+    else if (adapt != "no")
+    {
+      MayDay::Error("AMRLevelPluto::readRegridParams: Regrid_adaptive must be yes or no");
+    }
+  }
+
+  if (s_regridAdaptive) pout() << "adaptive regrid = yes" << endl;
+}
+
+#ifdef CH_USE_HDF5
+
 void AMRLevelPluto::DefineExpressions(HDF5HeaderData& a_expressions) const
 {
 
@@ -1421,6 +2132,40 @@ void AMRLevelPluto::levelSetup()
                         m_hasCoarser,
                         m_hasFiner);
   }
+
+#if SELF_GRAVITY == YES
+  // The potential has the ghost zones of the level integrator
+  int numGhostPhi = GetNghost();
+
+  m_phi.define(m_grids,1,numGhostPhi*IntVect::Unit);
+  for (DataIterator dit = m_phi.dataIterator(); dit.ok(); ++dit)
+  {
+    m_phi[dit()].setVal(0.0);
+  }
+  m_levelPluto.setPotential(&m_phi);
+
+  if (m_hasCoarser)
+  {
+    int nRefCrse = m_coarser_level_ptr->refRatio();
+
+    m_phiPatcher.define(m_grids,
+                        amrGodCoarserPtr->m_grids,
+                        1,
+                        amrGodCoarserPtr->m_problem_domain,
+                        nRefCrse,
+                        m_dx,
+                        numGhostPhi);
+
+    m_phiInterp.define(m_grids,
+                       1,
+                       nRefCrse,
+                       m_dx,
+                       m_problem_domain);
+  }
+
+  // The multigrid solver must be defined on the new hierarchy
+  s_gravRedefine = true;
+#endif
 }
 
 // Get the next coarser level
@@ -1463,6 +2208,210 @@ AMRLevelPluto* AMRLevelPluto::getFinerLevel() const
   return amrGodFinerPtr;
 }
 
+#if SELF_GRAVITY == YES
+// Solve Poisson's equation for the potential on levels a_lbase ...
+// a_lmax (with the potential of level a_lbase-1 as boundary condition)
+void AMRLevelPluto::solveSelfGravity(int a_lbase, int a_lmax)
+{
+  CH_TIME("AMRLevelPluto::solveSelfGravity");
+
+  Vector<AMRLevel*> hierarchy = getAMRLevelHierarchy();
+  Vector<LevelData<FArrayBox>*> phi(a_lmax+1,NULL);
+  Vector<LevelData<FArrayBox>*> rhs(a_lmax+1,NULL);
+  AMRLevelPluto* lev;
+  AMRLevelPluto* lev0 = dynamic_cast<AMRLevelPluto*>(hierarchy[0]);
+  const ProblemDomain& domain0 = lev0->m_problem_domain;
+  int  dir, l;
+  bool periodic = domain0.isPeriodic(0);
+
+  // Rebuild the solver after a regrid
+  if (s_gravRedefine)
+  {
+    for (dir = 0; dir < SpaceDim; dir++)
+    {
+      if (domain0.isPeriodic(dir) != periodic)
+      {
+        MayDay::Error("AMRLevelPluto::solveSelfGravity: boundaries must be all periodic or none");
+      }
+    }
+    if (g_x2stretch != 1.0 || g_x3stretch != 1.0)
+    {
+      MayDay::Error("AMRLevelPluto::solveSelfGravity: zones must be cubic");
+    }
+
+    int numLevels = a_lmax + 1;
+    while (numLevels < hierarchy.size() &&
+           hierarchy[numLevels]->boxes().size() > 0) numLevels++;
+
+    Vector<DisjointBoxLayout> grids(numLevels);
+    Vector<int> refRatios(numLevels);
+    for (l = 0; l < numLevels; l++)
+    {
+      lev = dynamic_cast<AMRLevelPluto*>(hierarchy[l]);
+      grids[l]     = lev->m_grids;
+      refRatios[l] = lev->m_ref_ratio;
+    }
+
+    delete s_gravSolver;
+    delete s_gravFactory;
+
+    s_gravFactory = new AMRPoissonOpFactory;
+    s_gravFactory->define(domain0, grids, refRatios, lev0->m_dx,
+                          BCHolder(GravityBC), 0.0, 1.0);
+
+    s_gravBottom.m_verbosity = 0;
+    s_gravSolver = new AMRMultiGrid<LevelData<FArrayBox> >;
+    s_gravSolver->define(domain0, *s_gravFactory, &s_gravBottom, numLevels);
+    s_gravSolver->m_verbosity = (s_verbosity >= 3 ? 3:0);
+
+    s_gravRedefine = false;
+  }
+
+  // Mean density or total mass and center of mass from the base level
+  if (a_lbase == 0)
+  {
+    Real sums[CH_SPACEDIM+2];
+    for (dir = 0; dir < CH_SPACEDIM+2; dir++) sums[dir] = 0.0;
+
+    for (DataIterator dit = lev0->m_grids.dataIterator(); dit.ok(); ++dit)
+    {
+      const FArrayBox& U = lev0->m_UNew[dit()];
+      for (BoxIterator bit(lev0->m_grids[dit()]); bit.ok(); ++bit)
+      {
+        const IntVect& iv = bit();
+        Real rho = U(iv,RHO);
+        sums[0] += rho;
+        for (dir = 0; dir < CH_SPACEDIM; dir++)
+        {
+          sums[dir+1] += rho*(g_domBeg[dir] + (iv[dir] + 0.5)*lev0->m_dx);
+        }
+        sums[CH_SPACEDIM+1] += 1.0;
+      }
+    }
+   #ifdef CH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, sums, CH_SPACEDIM+2, MPI_CH_REAL, MPI_SUM,
+                  Chombo_MPI::comm);
+   #endif
+
+    Real dV = 1.0;
+    for (dir = 0; dir < CH_SPACEDIM; dir++) dV *= lev0->m_dx;
+
+    s_gravMass = sums[0]*dV;
+    for (dir = 0; dir < CH_SPACEDIM; dir++)
+    {
+      s_gravCenter[dir] = (sums[0] != 0.0 ? sums[dir+1]/sums[0]:0.0);
+    }
+    s_gravRhoMean = (periodic ? sums[0]/sums[CH_SPACEDIM+1]:0.0);
+  }
+
+  // Right hand side: 4 pi G (rho - <rho>)
+  Real rhsMax = 0.0;
+  for (l = 0; l <= a_lmax; l++)
+  {
+    lev = dynamic_cast<AMRLevelPluto*>(hierarchy[l]);
+    phi[l] = &lev->m_phi;
+    if (l < a_lbase) continue;
+
+    rhs[l] = new LevelData<FArrayBox>(lev->m_grids,1,IntVect::Zero);
+    for (DataIterator dit = lev->m_grids.dataIterator(); dit.ok(); ++dit)
+    {
+      FArrayBox& rhsFab = (*rhs[l])[dit()];
+      rhsFab.copy(lev->m_UNew[dit()],RHO,0,1);
+      rhsFab.plus(-s_gravRhoMean);
+      rhsFab *= 4.0*CONST_PI*SELF_GRAVITY_G;
+      rhsMax = Max(rhsMax, rhsFab.norm(0,0,1));
+    }
+  }
+ #ifdef CH_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &rhsMax, 1, MPI_CH_REAL, MPI_MAX,
+                Chombo_MPI::comm);
+ #endif
+
+  // Start from the current potential
+  s_gravSolver->setSolverParameters(2, 2, 8, 1, 30, SELF_GRAVITY_TOL,
+                                    1.e-15, SELF_GRAVITY_TOL*rhsMax);
+  s_gravSolver->solve(phi, rhs, a_lmax, a_lbase, false);
+
+  // The potential in a periodic domain is defined up to a constant:
+  // remove the mean value on the base level
+  if (periodic && a_lbase == 0)
+  {
+    Real sums[2] = {0.0, 0.0};
+    for (DataIterator dit = lev0->m_grids.dataIterator(); dit.ok(); ++dit)
+    {
+      const Box& b = lev0->m_grids[dit()];
+      sums[0] += lev0->m_phi[dit()].sum(b,0,1);
+      sums[1] += b.numPts();
+    }
+   #ifdef CH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_CH_REAL, MPI_SUM,
+                  Chombo_MPI::comm);
+   #endif
+    for (l = 0; l <= a_lmax; l++)
+    {
+      for (DataIterator dit = phi[l]->dataIterator(); dit.ok(); ++dit)
+      {
+        (*phi[l])[dit()].plus(-sums[0]/sums[1]);
+      }
+    }
+  }
+
+  for (l = a_lbase; l <= a_lmax; l++)
+  {
+    lev = dynamic_cast<AMRLevelPluto*>(hierarchy[l]);
+    lev->fillPhiGhosts();
+    if (g_intStage == 1) lev->m_phiTime = lev->m_time;
+    delete rhs[l];
+  }
+}
+
+// Fill the ghost zones of the potential: from the neighbouring grids,
+// from the coarser level and, at the physical boundaries, by linear
+// extrapolation
+void AMRLevelPluto::fillPhiGhosts()
+{
+  int numGhostPhi = m_phi.ghostVect()[0];
+
+  m_phi.exchange();
+
+  if (m_hasCoarser)
+  {
+    const LevelData<FArrayBox>& phiCoarse = getCoarserLevel()->m_phi;
+    m_phiPatcher.fillInterp(m_phi,phiCoarse,phiCoarse,0.0,0,0,1);
+  }
+
+  const Box& domainBox = m_problem_domain.domainBox();
+  for (DataIterator dit = m_grids.dataIterator(); dit.ok(); ++dit)
+  {
+    FArrayBox& phi = m_phi[dit()];
+    Box validBox = m_grids[dit()];
+
+    for (int dir = 0; dir < SpaceDim; dir++)
+    {
+      if (m_problem_domain.isPeriodic(dir)) continue;
+
+      for (SideIterator sit; sit.ok(); ++sit)
+      {
+        int s = sign(sit());
+        Box ghostBox = adjCellBox(validBox, dir, sit(), 1);
+        if (domainBox.contains(ghostBox)) continue;
+
+        for (int n = 0; n < numGhostPhi; n++)
+        {
+          for (BoxIterator bit(ghostBox); bit.ok(); ++bit)
+          {
+            const IntVect& iv = bit();
+            phi(iv) = 2.0*phi(iv - s*BASISV(dir)) - phi(iv - 2*s*BASISV(dir));
+          }
+          ghostBox.shift(dir, s);
+        }
+      }
+      validBox.grow(dir, numGhostPhi);
+    }
+  }
+}
+#endif
+
 // Mark Split/unsplit cells of this level
 void AMRLevelPluto::mark_split(const DisjointBoxLayout& finerLevelDomain)
 {
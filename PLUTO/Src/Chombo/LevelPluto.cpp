@@ -28,6 +28,9 @@ LevelPluto::LevelPluto()
   m_refineCoarse = 0;
   m_patchPluto   = NULL;
   m_isDefined    = false;
+ #if SELF_GRAVITY == YES
+  m_phi          = NULL;
+ #endif
 }
 
 // Destructor - free up storage
@@ -303,9 +306,20 @@ Real LevelPluto::step(LevelData<FArrayBox>&       a_U,
     Dts.cfl     = a_cfl;
     Where(-1, grid); /* -- store grid for subsequent calls -- */
 
+   #if SELF_GRAVITY == YES
+    // The gravitational potential of this grid (same box as curU)
+    double ***phi = ArrayMap(NX3_TOT, NX2_TOT, NX1_TOT,
+                             (*m_phi)[dit].dataPtr(0));
+    SelfGravitySetPotential (phi);
+   #endif
+
     // Take one step
     m_patchPluto->advanceStep (curU, curUtmp, curdV, split_tags, flags, flux,
                                &Dts, curBox, grid);
+
+   #if SELF_GRAVITY == YES
+    FreeArrayMap(phi);
+   #endif
  
     inv_dt = Dts.inv_dta + 2.0*Dts.inv_dtp;
     maxWaveSpeed = Max(maxWaveSpeed, inv_dt); // Now the inverse of the timestep
@@ -441,6 +455,13 @@ const LevelData<FArrayBox>& LevelPluto::getdV() const
 }
 #endif
 
+#if SELF_GRAVITY == YES
+void LevelPluto::setPotential(LevelData<FArrayBox>* a_phi)
+{
+  m_phi = a_phi;
+}
+#endif
+
 Real LevelPluto::getDlMin()
 {
 
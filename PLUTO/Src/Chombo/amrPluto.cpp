@@ -435,6 +435,14 @@ void amrPluto(int argc, char *argv[], char *ini_file, Cmd_Line *cmd_line)
   prefix = runtime.output_dir+string("/")+prefix;
   amr.checkpointPrefix(prefix);
 
+  // Plot and checkpoint file options (variables, precision, compression...)
+#ifdef CH_USE_HDF5
+  AMRLevelPluto::readOutputParams(patchPluto->PrimStateNames());
+#endif
+
+  // Regrid scheduler options
+  AMRLevelPluto::readRegridParams();
+
   amr.verbosity(verbosity);
 
   // Setup input files
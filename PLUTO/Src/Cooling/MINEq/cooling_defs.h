@@ -108,11 +108,13 @@ extern COOL_COEFF CoolCoeffs;
            notice that we must have \sum Ni = N
    **************************************************** */
 
+#define ION_MAX_LEVELS  16  /* max number of levels in a ion */
+
 typedef struct ION {
    int      nlev, nTom, isMAP, isCV, isH, isCHEB;                 
    double   N;  
-   double   wght[16];    /* max number of levels in a ion is 16 */    
-   double   Ni[16];
+   double   wght[ION_MAX_LEVELS];    
+   double   Ni[ION_MAX_LEVELS];
    double   **A, **dE;  
    double   ***omega, Tom[8];
 } Ion;
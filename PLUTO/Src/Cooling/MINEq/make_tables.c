@@ -1,6 +1,17 @@
 #include "pluto.h"
 #include "cooling_defs.h"
 
+#ifndef MINEQ_TABLE_CACHE
+ #define MINEQ_TABLE_CACHE  YES
+#endif
+
+static void   Level_Rates (Ion *, double, double **);
+static void   Level_Populations (Ion *, double, double **);
+static double Line_Losses (Ion *, int, double, double);
+static int    ReadLossesTable  (char *, double ***, int, int);
+static void   WriteLossesTable (char *, double ***, int, int);
+static void   FreeAtoms (Ion *);
+
 /* ********************************************************************* */
 void Solve_System (Ion *X, double Ne, double T)
 /*!
@@ -9,26 +20,28 @@ void Solve_System (Ion *X, double Ne, double T)
  *
  *********************************************************************** */
 {
-  int    i, j, k, nlev;
-  double scrh,tmpx, d;
-  double **q;
-  double **M, *rhs;
-  int *p;  
-  
+  static double **q;
+
+  if (q == NULL) q = ARRAY_2D(ION_MAX_LEVELS, ION_MAX_LEVELS, double);
+
+  Level_Rates (X, T, q);
+  Level_Populations (X, Ne, q);
+}
+
+/* ********************************************************************* */
+void Level_Rates (Ion *X, double T, double **q)
+/*!
+ *  Compute the collisional rate coefficients q[i][j] between the 
+ *  levels of ion X at temperature T.
+ *  They do not depend on the electron density and can be shared by
+ *  all the level-population solves at the same temperature.
+ *
+ *********************************************************************** */
+{
+  int    i, j, nlev;
+  double scrh, tmpx;
+
   nlev = X->nlev;
-  M    = ARRAY_2D(nlev, nlev, double);
-  rhs  = ARRAY_1D(nlev, double);
-  p    = ARRAY_1D(nlev, int);
-  q    = ARRAY_2D (nlev, nlev, double);
-
-  for (i = 0; i < nlev; i++)  {
-    rhs[i] = 0.0;
-    p[i] = 0.0;
-    for (j = 0; j < nlev; j++)  {
-      M[i][j] = 0.0;
-      q[i][j] = 0.0;
-    }
-  }
 
 /* -------------------------------------------
                 Define qij
@@ -55,6 +68,28 @@ void Solve_System (Ion *X, double Ne, double T)
     q[i][j]  = (X->wght[j]/X->wght[i])*q[j][i]*exp( - X->dE[i][j]/(kB*T)); 
   }}               
   for (i = 0; i < nlev; i++) q[i][i] = 0.0;
+}
+
+/* ********************************************************************* */
+void Level_Populations (Ion *X, double Ne, double **q)
+/*!
+ *  Solve for the level populations X->Ni given the electron density
+ *  and the rate coefficients computed by Level_Rates().
+ *  Work arrays are allocated only once.
+ *
+ *********************************************************************** */
+{
+  int    i, j, k, nlev;
+  double scrh, d;
+  static int    *p;
+  static double **M, *rhs;
+
+  if (M == NULL){
+    M   = ARRAY_2D(ION_MAX_LEVELS, ION_MAX_LEVELS, double);
+    rhs = ARRAY_1D(ION_MAX_LEVELS, double);
+    p   = ARRAY_1D(ION_MAX_LEVELS, int);
+  }
+  nlev = X->nlev;
 
 /* -----------------------------------------
        compute coefficient matrix 
@@ -840,78 +875,246 @@ continue;
 /* ********************************************************************* */
 int Create_Losses_Tables(double ***losstables, int *nT, int *nN)
 /*!
- *  Compute and save to disk the radiative 
- *  losses tables function of Ne and T
+ *  Compute the radiative losses tables function of Ne and T.
+ *  For each ion, the collisional rates are evaluated once per 
+ *  temperature and shared by all the level-population solves along 
+ *  the Ne direction.
+ *  With ::MINEQ_TABLE_CACHE set to YES, tables are saved to 
+ *  \c mineq_losses.cache and restored at the next start after 
+ *  checking a few nodes of every ion.
  *
  *********************************************************************** */
 {
-  int    ib, ie, first_time, atom_id, i, j;
-  double Ne, T, erg;
-  double tmpN, tmpT;
-  double line_1, line_2, d;
-  char fname[100],fnn[10];
+  int    atom_id, i, j, ic, jc, match;
+  double Ne, T;
+  double *Tgrid, *Negrid, **q;
   Ion atoms[NIONS], *X;   
   
-  erg = 1.602177e-12;
-
   Ne = C_NeMIN;
   *nN = 0;
   while (Ne < C_NeMAX) {
     T   = C_TMIN;
     *nT = 0;
     while (T  < C_TMAX)  {
-      tmpT = T;
       T    = T*exp(C_TSTEP);   /* should be *exp(0.02)  */
       *nT  = *nT + 1;
     }
-    tmpN = Ne;
     Ne   = Ne*exp(C_NeSTEP);   /* should be *exp(0.06)  */
     *nN  = *nN + 1;
   }
 
+/* -------------------------------------------------------
+    Store the nodes (obtained by repeated multiplication, 
+    as before) to be reused by every ion.
+   ------------------------------------------------------- */
+
+  Tgrid  = ARRAY_1D(*nT, double);
+  Negrid = ARRAY_1D(*nN, double);
+  q      = ARRAY_2D(ION_MAX_LEVELS, ION_MAX_LEVELS, double);
+
+  T = C_TMIN;
+  for (i = 0; i < *nT; i++) {
+    Tgrid[i] = T;
+    T = T*exp(C_TSTEP);
+  }
+  Ne = C_NeMIN;
+  for (j = 0; j < *nN; j++) {
+    Negrid[j] = Ne;
+    Ne = Ne*exp(C_NeSTEP);
+  }
+
   for (i = 0; i < NIONS; i++) atoms[i].dE = NULL;
 
-  first_time = 1; 
+/* -------------------------------------------------------
+    Try to restore the tables from cache. Nodes at the 
+    corners and at the center must match for all ions.
+   ------------------------------------------------------- */
+
+  #if MINEQ_TABLE_CACHE == YES
+  match = (ReadLossesTable("mineq_losses.cache", losstables, *nN, *nT) == 0);
+  if (match){
+    for (atom_id = 0; atom_id < NIONS && match; atom_id++) {
+      X = &atoms[atom_id];
+      INIT_ATOM(X,atom_id);
+      for (jc = 0; jc < 3; jc++){
+      for (ic = 0; ic < 3; ic++){
+        i = ic*(*nT - 1)/2;
+        j = jc*(*nN - 1)/2;
+        Solve_System (X, Negrid[j], Tgrid[i]);
+        match = match && 
+               (Line_Losses(X, atom_id, Negrid[j], Tgrid[i]) == losstables[atom_id][j][i]);
+      }}
+    }
+  }
+
+/* -- take the same decision on all procs, once all are done reading -- */
+
+  #ifdef PARALLEL
+  {
+    int match_all;
+    MPI_Allreduce (&match, &match_all, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    match = match_all;
+  }
+  #endif
+  if (match){
+    print1("> MINEq radiative losses tables read from mineq_losses.cache\n");
+    FreeAtoms (atoms);
+    FreeArray1D((void *)Tgrid);
+    FreeArray1D((void *)Negrid);
+    FreeArray2D((void *)q);
+    return(0);
+  }
+
+/* -- release the ions set up for the check before rebuilding -- */
+
+  FreeAtoms (atoms);
+  #endif
+
   for (atom_id = 0; atom_id < NIONS; atom_id++) {
     X = &atoms[atom_id];
     INIT_ATOM(X,atom_id);
-    Ne = C_NeMIN;
-    *nN = 0;
-    while (Ne < C_NeMAX) {
-      T  = C_TMIN;
-      *nT = 0;
-      while (T < C_TMAX)  {
-      
-        line_2 = 0.0;
-        Solve_System (X, Ne, T);
-        for (ib = 1; ib < X->nlev; ib++) { 
-        for (ie = 0; ie < ib; ie++) {
-          if ( (X->Ni[ib] != X->Ni[ib]) || (X->A[ib][ie] != X->A[ib][ie]) || 
-               (X->dE[ib][ie] != X->dE[ib][ie]) || 
-               (X->Ni[ib] * X->A[ib][ie] * X->dE[ib][ie] > 1.0e+200) ){
-            printf (" Nan found  atom = %d   ib,ie = %d, %d\n", atom_id,ib,ie);
-            printf (" T, ne = %12.6e  %12.6e   %12.6e   %12.6e   %12.6e  %12.6e\n",T, Ne,X->Ni[ib],X->A[ib][ie],X->dE[ib][ie], X->omega[ib][ie][0] );
-            QUIT_PLUTO(1);
-          }      
-
-          if (X->A[ib][ie] > 0.0 && X->Ni[ib] > 0.0) 
-            line_2 += X->Ni[ib] * X->A[ib][ie] * X->dE[ib][ie] / Ne ;
-                  /* cooling / ion in eV, should be multiplied by ion abundance and Ne to obtain energy/cmc/s*/
-        }}
-        line_2 = line_2*erg;
-
-        losstables[atom_id][*nN][*nT] = line_2;
-        tmpT = T;
-        T    = T*exp(C_TSTEP);   /* should be *exp(0.02)  */
-        *nT  = *nT + 1;
+    for (i = 0; i < *nT; i++) {
+      Level_Rates (X, Tgrid[i], q);
+      for (j = 0; j < *nN; j++) {
+        Level_Populations (X, Negrid[j], q);
+        losstables[atom_id][j][i] = Line_Losses(X, atom_id, Negrid[j], Tgrid[i]);
       }
-      first_time = 0;
-      tmpN = Ne;
-      Ne   = Ne*exp(C_NeSTEP);   /* should be *exp(0.06)  */
-      *nN  = *nN + 1;
     }
   }
   
+  #if MINEQ_TABLE_CACHE == YES
+  if (prank == 0) WriteLossesTable("mineq_losses.cache", losstables, *nN, *nT);
+  #endif
+
+  FreeAtoms (atoms);
+  FreeArray1D((void *)Tgrid);
+  FreeArray1D((void *)Negrid);
+  FreeArray2D((void *)q);
+
   print1("> MINEq radiative losses tables generated and saved to memory.\n");
   return(0);
 }
+
+/* ********************************************************************* */
+void FreeAtoms (Ion *atoms)
+/*!
+ *  Free the level data allocated by INIT_ATOM() for all ions.
+ *
+ *********************************************************************** */
+{
+  int n;
+
+  for (n = 0; n < NIONS; n++){
+    if (atoms[n].dE == NULL) continue;
+    FreeArray2D((void *)atoms[n].dE);
+    FreeArray2D((void *)atoms[n].A);
+    FreeArray3D((void *)atoms[n].omega);
+    atoms[n].dE = NULL;
+  }
+}
+
+/* ********************************************************************* */
+double Line_Losses (Ion *X, int atom_id, double Ne, double T)
+/*!
+ *  Return the line emission (in erg) per ion and per electron 
+ *  from the level populations X->Ni computed by the last solve.
+ *
+ *********************************************************************** */
+{
+  int    ib, ie;
+  double line_2, erg = 1.602177e-12;
+
+  line_2 = 0.0;
+  for (ib = 1; ib < X->nlev; ib++) { 
+  for (ie = 0; ie < ib; ie++) {
+    if ( (X->Ni[ib] != X->Ni[ib]) || (X->A[ib][ie] != X->A[ib][ie]) || 
+         (X->dE[ib][ie] != X->dE[ib][ie]) || 
+         (X->Ni[ib] * X->A[ib][ie] * X->dE[ib][ie] > 1.0e+200) ){
+      printf (" Nan found  atom = %d   ib,ie = %d, %d\n", atom_id,ib,ie);
+      printf (" T, ne = %12.6e  %12.6e   %12.6e   %12.6e   %12.6e  %12.6e\n",T, Ne,X->Ni[ib],X->A[ib][ie],X->dE[ib][ie], X->omega[ib][ie][0] );
+      QUIT_PLUTO(1);
+    }      
+
+    if (X->A[ib][ie] > 0.0 && X->Ni[ib] > 0.0) 
+      line_2 += X->Ni[ib] * X->A[ib][ie] * X->dE[ib][ie] / Ne ;
+            /* cooling / ion in eV, should be multiplied by ion abundance and Ne to obtain energy/cmc/s*/
+  }}
+  return line_2*erg;
+}
+
+/* ********************************************************************* */
+int ReadLossesTable (char *fname, double ***tab, int nN, int nT)
+/*!
+ *  Read radiative losses tables previously saved by 
+ *  WriteLossesTable().
+ *  Return 0 on success, 1 if the file does not exist or if it was 
+ *  produced with a different ion network or table grid.
+ *
+ *********************************************************************** */
+{
+  int    n, hdr[9];
+  double par[6];
+  char   magic[16];
+  FILE  *fp;
+
+  fp = fopen(fname, "rb");
+  if (fp == NULL) return 1;
+
+  if (   fread(magic, sizeof(char), 16, fp) != 16
+      || strncmp(magic, "PLUTO_MINEQ_v1", 16) != 0
+      || fread(hdr, sizeof(int), 9, fp) != 9
+      || fread(par, sizeof(double), 6, fp) != 6
+      || hdr[0] != NIONS || hdr[1] != C_IONS  || hdr[2] != N_IONS 
+      || hdr[3] != O_IONS || hdr[4] != Ne_IONS || hdr[5] != S_IONS
+      || hdr[6] != Fe_IONS || hdr[7] != nN || hdr[8] != nT
+      || par[0] != C_NeMIN || par[1] != C_NeMAX || par[2] != C_NeSTEP
+      || par[3] != C_TMIN  || par[4] != C_TMAX  || par[5] != C_TSTEP){
+    fclose(fp);
+    return 1;
+  }
+
+  for (n = 0; n < NIONS; n++){
+    if (fread(tab[n][0], sizeof(double), nN*nT, fp) != (size_t)(nN*nT)){
+      fclose(fp);
+      return 1;
+    }
+  }
+  fclose(fp);
+  return 0;
+}
+
+/* ********************************************************************* */
+void WriteLossesTable (char *fname, double ***tab, int nN, int nT)
+/*!
+ *  Save radiative losses tables in binary format, preceded by a 
+ *  header identifying the ion network and the table grid.
+ *
+ *********************************************************************** */
+{
+  int    n, hdr[9];
+  double par[6];
+  char   magic[16];
+  FILE  *fp;
+
+  fp = fopen(fname, "wb");
+  if (fp == NULL){
+    print1 ("! WriteLossesTable: cannot open %s\n", fname);
+    return;
+  }
+
+  memset(magic, 0, 16);
+  strcpy(magic, "PLUTO_MINEQ_v1");
+
+  hdr[0] = NIONS;   hdr[1] = C_IONS;  hdr[2] = N_IONS;
+  hdr[3] = O_IONS;  hdr[4] = Ne_IONS; hdr[5] = S_IONS;
+  hdr[6] = Fe_IONS; hdr[7] = nN;      hdr[8] = nT;
+
+  par[0] = C_NeMIN; par[1] = C_NeMAX; par[2] = C_NeSTEP;
+  par[3] = C_TMIN;  par[4] = C_TMAX;  par[5] = C_TSTEP;
+
+  fwrite(magic, sizeof(char), 16, fp);
+  fwrite(hdr, sizeof(int), 9, fp);
+  fwrite(par, sizeof(double), 6, fp);
+  for (n = 0; n < NIONS; n++) fwrite(tab[n][0], sizeof(double), nN*nT, fp);
+  fclose(fp);
+}
@@ -7,8 +7,18 @@
 
    ############################################################ */
 
+#ifndef COOLING_EXACT
+ #define COOLING_EXACT  NO   /**< Set to YES to integrate the tabulated
+                                  cooling function exactly (see
+                                  townsend.c) rather than with the
+                                  ODE solvers of CoolingSource(). */
+#endif
+
 double GetMaxRate (double *, double *, double);
 void Radiat (double *, double *);
+#if COOLING_EXACT == YES
+ void TownsendCooling (const Data *, double, Time_Step *, Grid *);
+#endif
 
 
 
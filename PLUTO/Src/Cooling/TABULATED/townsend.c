@@ -0,0 +1,215 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief  Take a source step using exact integration of tabulated cooling.
+
+  When ::COOLING_EXACT is set to \c YES, the tabulated cooling function
+  is not integrated with the adaptive ODE solvers of CoolingSource().
+  Since density is constant during the source step and the mean
+  molecular weight does not depend on the state, the internal energy
+  equation can be written as an equation for the temperature alone:
+  \f[
+      \frac{dT}{dt} = -A\,\Lambda(T)\,,\qquad
+      A = (\Gamma - 1)\frac{\rho}{\mu}\,{\rm KELVIN}\,
+          \left(\frac{\rho_0}{m_u}\right)^2\frac{L_0}{\rho_0V_0^3}
+  \f]
+  where \c A is constant in each cell.
+  Following Townsend (2009), we introduce the temporal evolution function
+  \f[
+      F(T) = \int_T^{T_N}\frac{dT'}{\Lambda(T')}
+  \f]
+  so that \f$ F(T^{n+1}) = F(T^n) + A\Delta t\f$.
+  Between two consecutive entries of \c cooltable.dat, \f$\Lambda\f$ is
+  taken to be a power law in \c T and \c F can be integrated and
+  inverted analytically.
+  The values of \c F at the table nodes are computed once when the
+  table is read.
+
+  The cost of the update does not depend on the cooling time, so no
+  sub-stepping is needed and the cooling time step ::Time_Step::dt_cool
+  is not limited.
+  As with the ODE integration, cooling stops at ::g_minCoolingTemp and
+  the temperature must not exceed the last entry in the table.
+
+  \b Reference
+    - "An exact integration scheme for radiative cooling in
+       hydrodynamical simulations", Townsend, ApJS (2009) 181, 391
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#if COOLING_EXACT == YES
+
+#if EOS != IDEAL
+ #error COOLING_EXACT requires the IDEAL equation of state
+#endif
+
+static int     ntab;
+static double *T_tab, *L_tab;  /**< temperature and cooling function */
+static double *a_tab;          /**< power-law index in [T(k), T(k+1)] */
+static double *F_tab;          /**< evolution function at T(k) */
+
+static void   TownsendTable (void);
+static double TownsendIntegral (int, double);
+
+/* ********************************************************************* */
+void TownsendCooling (const Data *d, double dt, Time_Step *Dts, Grid *grid)
+/*!
+ * Update pressure by integrating exactly the tabulated cooling
+ * function over the time step \c dt.
+ *
+ * \param [in,out]  d     pointer to Data structure
+ * \param [in]      dt    the current integration time step
+ * \param [in]      Dts   a pointer to the Time_Step structure
+ *                        (unused, the time step is not limited)
+ * \param [in]      grid  pointer to an array of Grid structures
+ *
+ *********************************************************************** */
+{
+  int    i, j, k, nv, klo, khi, kmid;
+  double rho, mu, T0, T1, F1, A;
+  double E_cost, n_cost, cost, v[NVAR];
+
+  if (T_tab == NULL) TownsendTable();
+
+  E_cost = UNIT_LENGTH/UNIT_DENSITY/pow(UNIT_VELOCITY, 3.0);
+  n_cost = UNIT_DENSITY/CONST_amu;
+  cost   = (g_gamma - 1.0)*KELVIN*E_cost*n_cost*n_cost;
+
+  DOM_LOOP(k,j,i){
+
+    #if INTERNAL_BOUNDARY == YES
+     if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) continue;
+    #endif
+    if (d->flag[k][j][i] & FLAG_SPLIT_CELL) continue;
+
+    NVAR_LOOP(nv) v[nv] = d->Vc[nv][k][j][i];
+    rho = v[RHO];
+    mu  = MeanMolecularWeight(v);
+    T0  = v[PRS]/rho*KELVIN*mu;
+
+    if (T0 < g_minCoolingTemp) continue;
+
+    if (T0 > T_tab[ntab-1] || T0 < T_tab[0]){
+      print ("! TownsendCooling: T out of range   %12.6e\n",T0);
+      QUIT_PLUTO(1);
+    }
+
+  /* -- locate T0 in the table: T(klo) <= T0 <= T(klo+1) -- */
+
+    klo = 0;
+    khi = ntab - 1;
+    while (klo != (khi - 1)){
+      kmid = (klo + khi)/2;
+      if (T0 <= T_tab[kmid]) khi = kmid;
+      else                   klo = kmid;
+    }
+
+  /* -- advance the evolution function -- */
+
+    A  = cost*rho/mu;
+    F1 = F_tab[klo+1] + TownsendIntegral(klo, T0) + A*dt;
+
+  /* -- find the interval F(k+1) <= F1 < F(k) below T0 -- */
+
+    if (F1 >= F_tab[0]){
+      T1 = T_tab[0];
+    }else{
+      khi = klo + 1;
+      klo = 0;
+      while (klo != (khi - 1)){
+        kmid = (klo + khi)/2;
+        if (F1 >= F_tab[kmid]) khi = kmid;
+        else                   klo = kmid;
+      }
+
+    /* -- invert F in [T(klo), T(klo+1)] -- */
+
+      F1 -= F_tab[klo+1];
+      if (fabs(a_tab[klo] - 1.0) < 1.e-12){
+        T1 = T_tab[klo+1]*exp(-F1*L_tab[klo]/T_tab[klo]);
+      }else{
+        T1  = pow(T_tab[klo+1]/T_tab[klo], 1.0 - a_tab[klo]);
+        T1 -= (1.0 - a_tab[klo])*F1*L_tab[klo]/T_tab[klo];
+        T1  = T_tab[klo]*pow(MAX(T1, 0.0), 1.0/(1.0 - a_tab[klo]));
+      }
+      T1 = MAX(T1, T_tab[klo]);
+      T1 = MIN(T1, T0);
+    }
+    T1 = MAX(T1, g_minCoolingTemp);
+
+    d->Vc[PRS][k][j][i] = T1*rho/(KELVIN*mu);
+  }
+}
+
+/* ********************************************************************* */
+void TownsendTable (void)
+/*!
+ * Read the cooling table from disk, compute the power-law index of
+ * each interval and the evolution function at the table nodes.
+ *
+ *********************************************************************** */
+{
+  int   k;
+  FILE *fcool;
+
+  print1 (" > Reading table from disk...\n");
+  fcool = fopen("cooltable.dat","r");
+  if (fcool == NULL){
+    print1 ("! TownsendTable: cooltable.dat could not be found.\n");
+    QUIT_PLUTO(1);
+  }
+  L_tab = ARRAY_1D(20000, double);
+  T_tab = ARRAY_1D(20000, double);
+
+  ntab = 0;
+  while (fscanf(fcool, "%lf  %lf\n", T_tab + ntab,
+                                     L_tab + ntab)!=EOF) {
+    if (L_tab[ntab] <= 0.0){
+      print1 ("! TownsendTable: cooling function must be positive\n");
+      QUIT_PLUTO(1);
+    }
+    ntab++;
+  }
+  fclose(fcool);
+
+  a_tab = ARRAY_1D(ntab, double);
+  F_tab = ARRAY_1D(ntab, double);
+
+  for (k = 0; k < ntab - 1; k++){
+    if (T_tab[k+1] > T_tab[k]){
+      a_tab[k] = log(L_tab[k+1]/L_tab[k])/log(T_tab[k+1]/T_tab[k]);
+    }else{   /* -- repeated entries give an empty interval -- */
+      a_tab[k] = 0.0;
+    }
+  }
+  a_tab[ntab-1] = 0.0;
+
+  F_tab[ntab-1] = 0.0;
+  for (k = ntab - 2; k >= 0; k--){
+    F_tab[k] = F_tab[k+1] + TownsendIntegral(k, T_tab[k]);
+  }
+}
+
+/* ********************************************************************* */
+double TownsendIntegral (int k, double T)
+/*!
+ * Return the integral of 1/Lambda between \c T and T(k+1),
+ * with T(k) <= T <= T(k+1).
+ *
+ *********************************************************************** */
+{
+  double a = a_tab[k], scrh;
+
+  if (T >= T_tab[k+1]) return 0.0;
+
+  scrh = T_tab[k]/L_tab[k];
+  if (fabs(a - 1.0) < 1.e-12) return scrh*log(T_tab[k+1]/T);
+
+  return scrh/(1.0 - a)*(  pow(T_tab[k+1]/T_tab[k], 1.0 - a)
+                         - pow(T/T_tab[k], 1.0 - a));
+}
+
+#endif /* COOLING_EXACT == YES */
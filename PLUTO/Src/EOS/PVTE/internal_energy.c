@@ -35,6 +35,10 @@
   MakeInternalEnergyTable() so that internal energy and temperature can 
   be found by a combination of lookup table and bilinear (direct or inverse)
   interpolation.
+  Since the table depends only on the EoS and the units, it is saved
+  to the file \c rhoe_tab.cache (::TV_ENERGY_TABLE_CACHE) and
+  restored at the next startup, after checking a few nodes against 
+  InternalEnergyFunc().
   
   \author A. Mignone (mignone@ph.unito.it)\n
           B. Vaidya
@@ -49,6 +53,9 @@
 #ifndef TV_ENERGY_TABLE_NY   
  #define TV_ENERGY_TABLE_NY    512
 #endif
+#ifndef TV_ENERGY_TABLE_CACHE
+ #define TV_ENERGY_TABLE_CACHE  YES
+#endif
 
 static double rhoeFunc(double, void *);
 static double InternalEnergyDeriv (double rho, double T);
@@ -73,11 +80,47 @@ void MakeInternalEnergyTable()
   double x, y, q;
   double T, rho, v[NVAR];
 
+  InitializeTable2D(&rhoe_tab, 1.0, 1.e8, TV_ENERGY_TABLE_NX, 
+                               1.e-6, 1.e6, TV_ENERGY_TABLE_NY);  
+
+/* ----------------------------------------------------------------
+    Try to restore the table from cache. Nodes at the corners and 
+    at the center must match the current EoS exactly.
+   ---------------------------------------------------------------- */
+
+  #if TV_ENERGY_TABLE_CACHE == YES
+  {
+    int ic, jc, match;
+
+    match = (ReadTable2D("rhoe_tab.cache", &rhoe_tab) == 0);
+    for (jc = 0; jc < 3 && match; jc++){
+    for (ic = 0; ic < 3 && match; ic++){
+      i = ic*(rhoe_tab.nx - 1)/2;
+      j = jc*(rhoe_tab.ny - 1)/2;
+      v[RHO] = rhoe_tab.y[j];
+      match  = (InternalEnergyFunc(v, rhoe_tab.x[i]) == rhoe_tab.f[j][i]);
+    }}
+
+  /* -- take the same decision on all procs, once all are done reading -- */
+
+    #ifdef PARALLEL
+    {
+      int match_all;
+      MPI_Allreduce (&match, &match_all, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+      match = match_all;
+    }
+    #endif
+    if (match){
+      print1 ("> MakeInternalEnergyTable(): table read from rhoe_tab.cache\n");
+      FinalizeTable2D(&rhoe_tab);
+      return;
+    }
+  }
+  #endif
+
   print1 ("> MakeInternalEnergyTable(): Generating table (%d x %d points)\n",
            TV_ENERGY_TABLE_NX, TV_ENERGY_TABLE_NY);
 
-  InitializeTable2D(&rhoe_tab, 1.0, 1.e8, TV_ENERGY_TABLE_NX, 
-                               1.e-6, 1.e6, TV_ENERGY_TABLE_NY);  
   for (j = 0; j < rhoe_tab.ny; j++){
   for (i = 0; i < rhoe_tab.nx; i++){
     T   = rhoe_tab.x[i];
@@ -140,7 +183,12 @@ fclose(fp);
 
 
   FinalizeTable2D(&rhoe_tab);
-  if (prank == 0) WriteBinaryTable2D("rhoe_tab.bin",&rhoe_tab);  
+  if (prank == 0) {
+    WriteBinaryTable2D("rhoe_tab.bin",&rhoe_tab);  
+    #if TV_ENERGY_TABLE_CACHE == YES
+     WriteTable2D("rhoe_tab.cache",&rhoe_tab);  
+    #endif
+  }
 }
 
 /* ********************************************************************* */
@@ -24,6 +24,10 @@
   and the vector v. The result containing the characteristic
   variables is stored in the vector w = L.v
 
+  The function CharToPrim() performs the inverse projection,
+  v = R.w, using only the nonzero entries of the right primitive
+  eigenvectors.
+
   \author A. Mignone (mignone@ph.unito.it)
   \date   April 02, 2015
 */
@@ -633,3 +637,36 @@ void PrimToChar (double **L, double *v, double *w)
   NSCL_LOOP(nv)  w[nv] = v[nv];
 #endif   
 }
+
+/* ********************************************************************* */
+void CharToPrim (double **R, double *w, double *v)
+/*!
+ *  Compute the matrix-vector multiplication between the R matrix
+ *  (containing primitive right eigenvectors) and the vector w of
+ *  characteristic variables, v = R.w, for the first NFLX components.
+ *
+ *  For efficiency purpose, multiplication is done explicitly, so
+ *  that only nonzero entries of the right primitive eigenvectors
+ *  are considered.
+ *
+ * \param [in]   R   Right eigenvectors
+ * \param [in]   w   (difference of) characteristic variables
+ * \param [out]  v   (difference of) primitive variables
+ *
+ *********************************************************************** */
+{
+  #if HAVE_ENERGY
+   v[RHO] = w[0]*R[RHO][0] + w[1]*R[RHO][1] + w[2];
+   v[VXn] = w[0]*R[VXn][0] + w[1]*R[VXn][1];
+   EXPAND(                 ,
+          v[VXt] = w[3];   ,
+          v[VXb] = w[4];)
+   v[PRS] = w[0]*R[PRS][0] + w[1]*R[PRS][1];
+  #elif EOS == ISOTHERMAL
+   v[RHO] = w[0]*R[RHO][0] + w[1]*R[RHO][1];
+   v[VXn] = w[0]*R[VXn][0] + w[1]*R[VXn][1];
+   EXPAND(                 ,
+          v[VXt] = w[2];   ,
+          v[VXb] = w[3];)
+  #endif
+}
@@ -96,7 +96,7 @@ void PrimSource (const State_1D *state, int beg, int end,
  *********************************************************************** */
 {
   int    nv, i, j, k;
-  double tau, dA_dV, th;
+  double tau, dA_dV;
   double hscale; /* scale factor */
   double *v, *vp, *A, *dV, r_inv, ct;
   double *x1,  *x2,  *x3;
@@ -230,7 +230,12 @@ void PrimSource (const State_1D *state, int beg, int end,
    if (g_dir == IDIR) {
      i = beg-1;
      #if BODY_FORCE & POTENTIAL
-      phi_p[i] = BodyForcePotential(x1p[i], x2[j], x3[k]);
+      for (i = beg-1; i <= end; i++){
+        phi_p[i] = BodyForcePotential(x1p[i], x2[j], x3[k]);
+      }
+      #if SELF_GRAVITY == YES
+       SelfGravityAddPotential (phi_p, beg-1, end);
+      #endif
      #endif
      for (i = beg; i <= end; i++){
        #if BODY_FORCE & VECTOR
@@ -239,7 +244,6 @@ void PrimSource (const State_1D *state, int beg, int end,
         src[i][VX1] += g[IDIR];
        #endif
        #if BODY_FORCE & POTENTIAL
-        phi_p[i]     = BodyForcePotential(x1p[i], x2[j], x3[k]); 
         src[i][VX1] -= (phi_p[i] - phi_p[i-1])/(hscale*dx1[i]);
        #endif
 
@@ -254,7 +258,12 @@ void PrimSource (const State_1D *state, int beg, int end,
    }else if (g_dir == JDIR){
      j = beg - 1;
      #if BODY_FORCE & POTENTIAL
-      phi_p[j] = BodyForcePotential(x1[i], x2p[j], x3[k]);
+      for (j = beg-1; j <= end; j++){
+        phi_p[j] = BodyForcePotential(x1[i], x2p[j], x3[k]);
+      }
+      #if SELF_GRAVITY == YES
+       SelfGravityAddPotential (phi_p, beg-1, end);
+      #endif
      #endif
      #if GEOMETRY == POLAR || GEOMETRY == SPHERICAL
       hscale = x1[i];
@@ -266,7 +275,6 @@ void PrimSource (const State_1D *state, int beg, int end,
         src[j][VX2] += g[JDIR];
        #endif
        #if BODY_FORCE & POTENTIAL
-        phi_p[j]     = BodyForcePotential(x1[i], x2p[j], x3[k]);
         src[j][VX2] -= (phi_p[j] - phi_p[j-1])/(hscale*dx2[j]);
        #endif
 
@@ -279,11 +287,15 @@ void PrimSource (const State_1D *state, int beg, int end,
    }else if (g_dir == KDIR){
      k = beg - 1;
      #if BODY_FORCE & POTENTIAL
-      phi_p[k] = BodyForcePotential(x1[i], x2[j], x3p[k]);
+      for (k = beg-1; k <= end; k++){
+        phi_p[k] = BodyForcePotential(x1[i], x2[j], x3p[k]);
+      }
+      #if SELF_GRAVITY == YES
+       SelfGravityAddPotential (phi_p, beg-1, end);
+      #endif
      #endif
      #if GEOMETRY == SPHERICAL
-      th     = x2[j];
-      hscale = x1[i]*sin(th);
+      hscale = x1[i]*grid[JDIR].st[j];
      #endif
      for (k = beg; k <= end; k++){
        #if BODY_FORCE & VECTOR
@@ -292,7 +304,6 @@ void PrimSource (const State_1D *state, int beg, int end,
         src[k][VX3] += g[KDIR];
        #endif
        #if BODY_FORCE & POTENTIAL
-        phi_p[k]     = BodyForcePotential(x1[i], x2[j], x3p[k]); 
         src[k][VX3] -= (phi_p[k] - phi_p[k-1])/(hscale*dx3[k]);
        #endif
      }
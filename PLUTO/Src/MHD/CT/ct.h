@@ -98,7 +98,10 @@ typedef struct ElectroMotiveForce{
   double ***SzR;
 /**@} */
 
-/*! \name Edge-centered fields   */
+/*! \name Edge-centered fields
+    Except for the UCT_HLL average, these share memory with the
+    face-centered arrays (ez = ezi, ex = exj, ey = eyi) and are
+    valid only after CT_GetEMF().   */
 /**@{ */
   double ***ex;
   double ***ey;
@@ -132,6 +135,7 @@ void CT_Update(const Data *, Data_Arr, double, Grid *);
 void CT_CheckDivB (double ***b[], Grid *);
 void CT_GetStagSlopes (const Data_Arr, EMF *, Grid *);
 void CT_StoreEMF (const State_1D *, int, int, Grid *);
+void CT_SetEMFRange (int, int, int);
 
 EMF *CT_GetEMF (const Data *, Grid *);
 void CT_AddResistiveEMF (const Data *d, Grid *grid);
@@ -58,22 +58,24 @@ void CT_StoreEMF (const State_1D *state, int beg, int end, Grid *grid)
     emf.jbeg = emf.jend = 0;
     emf.kbeg = emf.kend = 0;
 
-  /* -- memory allocation -- */
+  /* -----------------------------------------------------------
+      memory allocation.
+      The UCT_HLL average builds edge values from the signal 
+      speeds and slopes only, so face-centered components are 
+      not needed.
+      The other averages combine faces into edges in a single
+      pass that can overwrite one of the face arrays 
+      (ez -> ezi, ex -> exj, ey -> eyi), so no separate 
+      edge-centered arrays are kept.
+     ----------------------------------------------------------- */
 
-    D_EXPAND(                                          ;  ,
-      emf.ez = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);  ,
-      emf.ex = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
-      emf.ey = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
-    )
-
-    #if CT_EMF_AVERAGE == UCT_CONTACT
-     D_EXPAND(
-       emf.svx = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, signed char);  ,
-       emf.svy = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, signed char);  ,
-       emf.svz = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, signed char);
+    #if CT_EMF_AVERAGE == UCT_HLL
+     D_EXPAND(                                          ;  ,
+       emf.ez = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);  ,
+       emf.ex = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+       emf.ey = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
      )
-    #endif
-
+    #else
      D_EXPAND(                                           ;  ,
        emf.ezi = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double); 
        emf.ezj = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);  ,
@@ -84,6 +86,20 @@ void CT_StoreEMF (const State_1D *state, int beg, int end, Grid *grid)
        emf.eyi = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
        emf.eyk = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
      )
+     D_EXPAND(                                           ;  ,
+       emf.ez = emf.ezi;                                     ,
+       emf.ex = emf.exj;
+       emf.ey = emf.eyi;
+     )
+    #endif
+
+    #if CT_EMF_AVERAGE == UCT_CONTACT
+     D_EXPAND(
+       emf.svx = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, signed char);  ,
+       emf.svy = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, signed char);  ,
+       emf.svz = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, signed char);
+     )
+    #endif
 
     #if CT_EMF_AVERAGE == UCT_HLL
 
@@ -109,9 +125,11 @@ void CT_StoreEMF (const State_1D *state, int beg, int end, Grid *grid)
     emf.ibeg = beg; emf.iend = end;
     for (i = beg; i <= end; i++) { 
 
-      D_EXPAND(emf.ezi[g_k][g_j][i] = -state->flux[i][BX2];  ,
-                                                              ,
-               emf.eyi[g_k][g_j][i] =  state->flux[i][BX3]; ) 
+      #if CT_EMF_AVERAGE != UCT_HLL
+       D_EXPAND(emf.ezi[g_k][g_j][i] = -state->flux[i][BX2];  ,
+                                                               ,
+                emf.eyi[g_k][g_j][i] =  state->flux[i][BX3]; ) 
+      #endif
 
       #if CT_EMF_AVERAGE == UCT_CONTACT
        if      (state->flux[i][RHO] >  eps_UCT_CONTACT) s = 1;
@@ -138,9 +156,11 @@ void CT_StoreEMF (const State_1D *state, int beg, int end, Grid *grid)
     emf.jbeg = beg; emf.jend = end;
     for (j = beg; j <= end; j++) {
 
-      D_EXPAND(                                           ;   ,
-               emf.ezj[g_k][j][g_i] =  state->flux[j][BX1];   ,
-               emf.exj[g_k][j][g_i] = -state->flux[j][BX3]; )
+      #if CT_EMF_AVERAGE != UCT_HLL
+       D_EXPAND(                                           ;   ,
+                emf.ezj[g_k][j][g_i] =  state->flux[j][BX1];   ,
+                emf.exj[g_k][j][g_i] = -state->flux[j][BX3]; )
+      #endif
 
       #if CT_EMF_AVERAGE == UCT_CONTACT
        if      (state->flux[j][RHO] >  eps_UCT_CONTACT) s = 1;
@@ -166,8 +186,10 @@ void CT_StoreEMF (const State_1D *state, int beg, int end, Grid *grid)
     emf.kbeg = beg; emf.kend = end;
     for (k = beg; k <= end; k++) {
 
-      emf.eyk[k][g_j][g_i] = -state->flux[k][BX1]; 
-      emf.exk[k][g_j][g_i] =  state->flux[k][BX2]; 
+      #if CT_EMF_AVERAGE != UCT_HLL
+       emf.eyk[k][g_j][g_i] = -state->flux[k][BX1]; 
+       emf.exk[k][g_j][g_i] =  state->flux[k][BX2]; 
+      #endif
 
       #if CT_EMF_AVERAGE == UCT_CONTACT
        if      (state->flux[k][RHO] >  eps_UCT_CONTACT) s = 1;
@@ -201,6 +223,25 @@ void CT_StoreEMF (const State_1D *state, int beg, int end, Grid *grid)
 
 }
 
+/* ********************************************************************* */
+void CT_SetEMFRange (int dir, int beg, int end)
+/*!
+ * Set the index range over which EMF components have been stored
+ * along direction \c dir.
+ * Needed when the 1D sweeps do not span the whole range in a single
+ * call to CT_StoreEMF() (e.g. with the tiled traversal of UpdateStage()),
+ * since the range of the last sweep is otherwise retained.
+ *
+ * \param [in] dir   the sweep direction (IDIR, JDIR or KDIR)
+ * \param [in] beg   initial index of computation
+ * \param [in] end   final   index of computation
+ *********************************************************************** */
+{
+  if      (dir == IDIR) {emf.ibeg = beg; emf.iend = end;}
+  else if (dir == JDIR) {emf.jbeg = beg; emf.jend = end;}
+  else if (dir == KDIR) {emf.kbeg = beg; emf.kend = end;}
+}
+
 /* ********************************************************************* */
 EMF *CT_GetEMF (const Data *d, Grid *grid)
 /*!
@@ -266,17 +307,11 @@ EMF *CT_GetEMF (const Data *d, Grid *grid)
 
   #elif CT_EMF_AVERAGE == UCT_CONTACT
 
-   CT_EMF_ArithmeticAverage (&emf, 1.0);
+   #ifdef CTU
+    if (g_intStage == 1) CT_EMF_ArithmeticAverage (&emf, 0.25);
+    else
+   #endif
    CT_EMF_IntegrateToCorner (d, &emf, grid);
-   for (k = emf.kbeg; k <= emf.kend; k++){
-   for (j = emf.jbeg; j <= emf.jend; j++){
-   for (i = emf.ibeg; i <= emf.iend; i++){      
-     #if DIMENSIONS == 3
-      emf.ex[k][j][i] *= 0.25;
-      emf.ey[k][j][i] *= 0.25;
-     #endif
-     emf.ez[k][j][i] *= 0.25;
-   }}}
 
   #elif CT_EMF_AVERAGE == UCT_HLL
    #ifdef CTU
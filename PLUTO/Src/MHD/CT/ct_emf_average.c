@@ -59,8 +59,17 @@ void CT_EMF_IntegrateToCorner (const Data *d, const EMF *emf, Grid *grid)
 /*!
  * \details
  *
- *  Add derivatives to the 4-point arithmetic average of magnetic fields.
- *  Obtain the electric field at corners. 
+ *  Compute the edge-centered electric field by adding derivatives to 
+ *  the 4-point arithmetic average of the face-centered values.
+ *  Each edge gathers the contributions of the four faces sharing it
+ *  (with the upwind direction given by the sign of the mass flux), 
+ *  so that the arithmetic average, the corner integration and the 
+ *  final 1/4 weight are done in a single pass.
+ *  Contributions are added in the same order as the face-by-face 
+ *  (scatter) formulation.
+ *  Since an edge only reads faces with equal or larger indices, the 
+ *  result can overwrite the face array it shares memory with 
+ *  (see CT_StoreEMF()).
  *
  * \b References: 
  *  - "An unsplit Godunov method for ideal MHD via constrained transport"\n
@@ -95,94 +104,109 @@ void CT_EMF_IntegrateToCorner (const Data *d, const EMF *emf, Grid *grid)
 
 #define dEz_dxm(k,j,i) (EZ(k,j,i) - emf->ezi[k][j][i-1])
 #define dEz_dym(k,j,i) (EZ(k,j,i) - emf->ezj[k][j-1][i])
+
+/* -- upwind index along a face: the two zones are (n, n+1) -- */
+
+#define UPW(s,n)  ((s) > 0 ? (n):(n) + 1)
 {
   int    i, j, k;
-  int    iu, ju, ku;
-  signed char  sx, sy, sz;
+  signed char  s;
+  double e;
   double ***vx, ***vy, ***vz;
   double ***Bx, ***By, ***Bz;
 
-  #ifdef CTU
-   if (g_intStage == 1) return; /* -- not needed in predictor step of CTU -- */
-  #endif
-
   EXPAND(vx = d->Vc[VX1]; Bx = d->Vc[BX1];   ,
          vy = d->Vc[VX2]; By = d->Vc[BX2];   ,
          vz = d->Vc[VX3]; Bz = d->Vc[BX3];)
 
-  for (k = emf->kbeg; k <= emf->kend + KOFFSET; k++){
-  for (j = emf->jbeg; j <= emf->jend + 1      ; j++){
-  for (i = emf->ibeg; i <= emf->iend + 1      ; i++){      
-
-    D_EXPAND(sx = emf->svx[k][j][i];  ,
-             sy = emf->svy[k][j][i];  ,
-             sz = emf->svz[k][j][i];)
-
-    D_EXPAND(iu = sx > 0 ? i:i+1;  ,  /* -- upwind index -- */
-             ju = sy > 0 ? j:j+1;  ,
-             ku = sz > 0 ? k:k+1;)
-
- /* ----------------------------------------
-      Span X - Faces:    dEz/dy, dEy/dz
-    ---------------------------------------- */
-
-    if (sx == 0) {
-      emf->ez[k][j][i]   += 0.5*(dEz_dyp(k,j,i) + dEz_dyp(k,j,i+1));
-      emf->ez[k][j-1][i] -= 0.5*(dEz_dym(k,j,i) + dEz_dym(k,j,i+1));
-      #if DIMENSIONS == 3
-       emf->ey[k][j][i]   += 0.5*(dEy_dzp(k,j,i) + dEy_dzp(k,j,i+1));
-       emf->ey[k-1][j][i] -= 0.5*(dEy_dzm(k,j,i) + dEy_dzm(k,j,i+1));
-      #endif
-    }else{
-      emf->ez[k][j][i]   += dEz_dyp(k,j,iu);
-      emf->ez[k][j-1][i] -= dEz_dym(k,j,iu);
-      #if DIMENSIONS == 3
-       emf->ey[k][j][i]   += dEy_dzp(k,j,iu);
-       emf->ey[k-1][j][i] -= dEy_dzm(k,j,iu);
-      #endif
-    }
-
- /* ----------------------------------------
-      Span Y - Faces:    dEz/dx, dEx/dz
-    ---------------------------------------- */
-
-    if (sy == 0) {
-      emf->ez[k][j][i]   += 0.5*(dEz_dxp(k,j,i) + dEz_dxp(k,j+1,i));
-      emf->ez[k][j][i-1] -= 0.5*(dEz_dxm(k,j,i) + dEz_dxm(k,j+1,i));
-      #if DIMENSIONS == 3
-       emf->ex[k][j][i]   += 0.5*(dEx_dzp(k,j,i) + dEx_dzp(k,j+1,i));
-       emf->ex[k-1][j][i] -= 0.5*(dEx_dzm(k,j,i) + dEx_dzm(k,j+1,i));
-      #endif
-    }else{
-      emf->ez[k][j][i]   += dEz_dxp(k,ju,i);
-      emf->ez[k][j][i-1] -= dEz_dxm(k,ju,i);
-      #if DIMENSIONS == 3
-       emf->ex[k][j][i]   += dEx_dzp(k,ju,i);
-       emf->ex[k-1][j][i] -= dEx_dzm(k,ju,i);
-      #endif
-    }
-
- /* ----------------------------------------
-      Span Z - Faces:    dEx/dy, dEy/dx
-    ---------------------------------------- */
+  for (k = emf->kbeg; k <= emf->kend; k++){
+  for (j = emf->jbeg; j <= emf->jend; j++){
+  for (i = emf->ibeg; i <= emf->iend; i++){      
+
+  /* ---------------------------------------------------------
+      Ez at (i+1/2, j+1/2): x-face (j), y-face (i), 
+      y-face (i+1), x-face (j+1)
+     --------------------------------------------------------- */
+
+    e = emf->ezi[k][j][i] + emf->ezi[k][j + 1][i] 
+      + emf->ezj[k][j][i] + emf->ezj[k][j][i + 1];
+
+    s = emf->svx[k][j][i];
+    if (s == 0) e += 0.5*(dEz_dyp(k,j,i) + dEz_dyp(k,j,i+1));
+    else        e += dEz_dyp(k,j,UPW(s,i));
+
+    s = emf->svy[k][j][i];
+    if (s == 0) e += 0.5*(dEz_dxp(k,j,i) + dEz_dxp(k,j+1,i));
+    else        e += dEz_dxp(k,UPW(s,j),i);
+
+    s = emf->svy[k][j][i+1];
+    if (s == 0) e -= 0.5*(dEz_dxm(k,j,i+1) + dEz_dxm(k,j+1,i+1));
+    else        e -= dEz_dxm(k,UPW(s,j),i+1);
+
+    s = emf->svx[k][j+1][i];
+    if (s == 0) e -= 0.5*(dEz_dym(k,j+1,i) + dEz_dym(k,j+1,i+1));
+    else        e -= dEz_dym(k,j+1,UPW(s,i));
+
+    emf->ez[k][j][i] = e*0.25;
 
     #if DIMENSIONS == 3
 
-    if (sz == 0) {
-      emf->ex[k][j][i]   += 0.5*(dEx_dyp(k,j,i) + dEx_dyp(k+1,j,i));
-      emf->ex[k][j-1][i] -= 0.5*(dEx_dym(k,j,i) + dEx_dym(k+1,j,i));
-      emf->ey[k][j][i]   += 0.5*(dEy_dxp(k,j,i) + dEy_dxp(k+1,j,i));
-      emf->ey[k][j][i-1] -= 0.5*(dEy_dxm(k,j,i) + dEy_dxm(k+1,j,i));
-    }else{
-      emf->ex[k][j][i]   += dEx_dyp(ku,j,i);
-      emf->ex[k][j-1][i] -= dEx_dym(ku,j,i);
-      emf->ey[k][j][i]   += dEy_dxp(ku,j,i);
-      emf->ey[k][j][i-1] -= dEy_dxm(ku,j,i);
-    }
+  /* ---------------------------------------------------------
+      Ex at (j+1/2, k+1/2): y-face (k), z-face (j), 
+      z-face (j+1), y-face (k+1)
+     --------------------------------------------------------- */
+
+    e = emf->exk[k][j][i] + emf->exk[k][j + 1][i] 
+      + emf->exj[k][j][i] + emf->exj[k + 1][j][i];
+
+    s = emf->svy[k][j][i];
+    if (s == 0) e += 0.5*(dEx_dzp(k,j,i) + dEx_dzp(k,j+1,i));
+    else        e += dEx_dzp(k,UPW(s,j),i);
+
+    s = emf->svz[k][j][i];
+    if (s == 0) e += 0.5*(dEx_dyp(k,j,i) + dEx_dyp(k+1,j,i));
+    else        e += dEx_dyp(UPW(s,k),j,i);
+
+    s = emf->svz[k][j+1][i];
+    if (s == 0) e -= 0.5*(dEx_dym(k,j+1,i) + dEx_dym(k+1,j+1,i));
+    else        e -= dEx_dym(UPW(s,k),j+1,i);
+
+    s = emf->svy[k+1][j][i];
+    if (s == 0) e -= 0.5*(dEx_dzm(k+1,j,i) + dEx_dzm(k+1,j+1,i));
+    else        e -= dEx_dzm(k+1,UPW(s,j),i);
+
+    emf->ex[k][j][i] = e*0.25;
+
+  /* ---------------------------------------------------------
+      Ey at (i+1/2, k+1/2): x-face (k), z-face (i), 
+      z-face (i+1), x-face (k+1)
+     --------------------------------------------------------- */
+
+    e = emf->eyi[k][j][i] + emf->eyi[k + 1][j][i] 
+      + emf->eyk[k][j][i] + emf->eyk[k][j][i + 1];
+
+    s = emf->svx[k][j][i];
+    if (s == 0) e += 0.5*(dEy_dzp(k,j,i) + dEy_dzp(k,j,i+1));
+    else        e += dEy_dzp(k,j,UPW(s,i));
+
+    s = emf->svz[k][j][i];
+    if (s == 0) e += 0.5*(dEy_dxp(k,j,i) + dEy_dxp(k+1,j,i));
+    else        e += dEy_dxp(UPW(s,k),j,i);
+
+    s = emf->svz[k][j][i+1];
+    if (s == 0) e -= 0.5*(dEy_dxm(k,j,i+1) + dEy_dxm(k+1,j,i+1));
+    else        e -= dEy_dxm(UPW(s,k),j,i+1);
+
+    s = emf->svx[k+1][j][i];
+    if (s == 0) e -= 0.5*(dEy_dzm(k+1,j,i) + dEy_dzm(k+1,j,i+1));
+    else        e -= dEy_dzm(k+1,j,UPW(s,i));
+
+    emf->ey[k][j][i] = e*0.25;
 
     #endif
   }}}
 }
+#undef UPW
 #undef EX
 #undef EY
 #undef EZ
@@ -19,6 +19,7 @@
 #include "pluto.h"
 
 double glm_ch = -1.0;
+double glm_damping = 1.0;
 
 /* ********************************************************************* */
 void GLM_Solve (const State_1D *state, double **VL, double **VR,
@@ -146,22 +147,35 @@ void GLM_Source (const Data_Arr Q, double dt, Grid *grid)
  *********************************************************************** */
 {
   int    i,j,k;
-  double cr, cp, scrh;
-  double dx, dy, dz, dtdx;
+  double scrh;
+
+  scrh = GLM_Damping (dt, grid);
+  DOM_LOOP(k,j,i) Q[PSI_GLM][k][j][i] *= scrh;
+  return;
+}
+
+/* ********************************************************************* */
+double GLM_Damping (double dt, Grid *grid)
+/*!
+ * Return the factor by which $\psi$ decays during \c dt under the
+ * source term of the mixed GLM formulation,
+ * $\exp(-lpha\, c_h \Delta t/\Delta x)$.
+ *
+ * Outside Chombo, the factor is not applied by a separate sweep: the
+ * time stepping routines set ::glm_damping before the last
+ * conversion of a step and ConsToPrim3D() multiplies $\psi$ by it.
+ *
+ *********************************************************************** */
+{
+  double dtdx;
 
   #ifdef CHOMBO
    dtdx = dt;
   #else
-   dx   = grid[IDIR].dx[IBEG];
-   dtdx = dt/dx;
+   dtdx = dt/grid[IDIR].dx[IBEG];
   #endif
 
-  cp   = sqrt(dx*glm_ch/GLM_ALPHA);
-  scrh = dtdx*glm_ch*GLM_ALPHA; /* CFL*g_inputParam[ALPHA]; */
-
-  scrh = exp(-scrh);
-  DOM_LOOP(k,j,i) Q[PSI_GLM][k][j][i] *= scrh;
-  return;
+  return exp(-dtdx*glm_ch*GLM_ALPHA);
 }
 
 /* ********************************************************************* */
@@ -324,7 +338,10 @@ void GLM_ExtendedSource (const State_1D *state, double dt,
 void GLM_Init (const Data *d, const Time_Step *Dts, Grid *grid)
 /*!
  * Initialize the maximum propagation speed ::glm_ch.
- *
+ * This is done only before the first step: afterwards ::glm_ch is
+ * set by NextTimeStep() from the globally reduced time step and the
+ * (global) minimum cell length, so it has the same value on all
+ * processors and needs no further reduction.
  *
  *********************************************************************** */
 {
@@ -394,15 +411,14 @@ void GLM_Init (const Data *d, const Time_Step *Dts, Grid *grid)
      }
      #endif
 
+     #ifdef PARALLEL
+      MPI_Allreduce (&glm_ch, &gmaxc, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      glm_ch = gmaxc;
+     #endif
    }
   #elif PHYSICS == RMHD 
    if (glm_ch < 0.0) glm_ch = 1.0;
   #endif
-
-  #ifdef PARALLEL
-   MPI_Allreduce (&glm_ch, &gmaxc, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
-   glm_ch = gmaxc;
-  #endif
 }
 
 #if COMPUTE_DIVB == YES
@@ -37,6 +37,15 @@
 #endif
 
 
+/* Time over which psi is damped at the end of AdvanceStep()
+   (called once per direction with dimensional splitting) */
+
+#if DIMENSIONAL_SPLITTING == YES
+ #define GLM_DAMPING_DT  (g_dt/(double)DIMENSIONS)
+#else
+ #define GLM_DAMPING_DT  g_dt
+#endif
+
 #define COMPUTE_DIVB  NO
 
 /* with chombo, COMPUTE_DIVB must be 
@@ -48,11 +57,15 @@
 #endif
 
 extern double glm_ch; /**< The propagation speed of divergence error. */
+extern double glm_damping; /**< Factor by which ConsToPrim3D() multiplies
+                                psi (1 except for the last conversion
+                                of a step, see GLM_Damping()). */
     
 void  GLM_Solve (const State_1D *, double **, double **, int, int, Grid *);
 void  GLM_SolveNEW (const State_1D *state, int beg, int end, Grid *grid);
 void  GLM_Init      (const Data *, const Time_Step *, Grid *);
 void  GLM_Source (const Data_Arr, double, Grid *);
+double GLM_Damping (double, Grid *);
 void  GLM_ExtendedSource (const State_1D *, double, int, int, Grid *);
 
 #if COMPUTE_DIVB == YES
@@ -24,6 +24,10 @@
   and the vector v. The result containing the characteristic
   variables is stored in the vector w = L.v
 
+  The function CharToPrim() performs the inverse projection,
+  v = R.w, using only the nonzero entries of the right primitive
+  eigenvectors.
+
   \authors A. Mignone (mignone@ph.unito.it)\n
            P. Tzeferacos (petros.tzeferacos@ph.unito.it)
   \date    April 02, 2015
@@ -1394,3 +1398,122 @@ void PrimToChar (double **Lp, double *v, double *w)
 }
 #endif
 }
+
+/* ********************************************************************* */
+void CharToPrim (double **Rp, double *w, double *v)
+/*!
+ *  Compute the matrix-vector multiplication between the R matrix
+ *  (containing primitive right eigenvectors) and the vector w of
+ *  characteristic variables, v = R.w, for the first NFLX components.
+ *
+ *  Only the entries of the right primitive eigenvectors that can be
+ *  nonzero are considered.
+ *  Terms are summed in the same (ascending) order as the full
+ *  matrix-vector product, so that the result does not change.
+ *  
+ * \param [in]   Rp  Right eigenvectors
+ * \param [in]   w   (difference of) characteristic variables
+ * \param [out]  v   (difference of) primitive variables 
+ *
+ *********************************************************************** */
+{
+  int    n, ntr, tr[4];
+  double s, *R;
+
+/* -- density -- */
+
+  R = Rp[RHO];
+  s = w[KFASTM]*R[KFASTM] + w[KFASTP]*R[KFASTP];
+  #if HAVE_ENERGY
+   s += w[KENTRP]*R[KENTRP];
+  #endif
+  #if COMPONENTS > 1
+   s += w[KSLOWM]*R[KSLOWM];
+   s += w[KSLOWP]*R[KSLOWP];
+  #endif
+  v[RHO] = s;
+
+/* -- normal velocity -- */
+
+  R = Rp[VXn];
+  s = w[KFASTM]*R[KFASTM] + w[KFASTP]*R[KFASTP];
+  #if COMPONENTS > 1
+   s += w[KSLOWM]*R[KSLOWM];
+   s += w[KSLOWP]*R[KSLOWP];
+  #endif
+  v[VXn] = s;
+
+/* -- transverse velocity and magnetic field -- */
+
+  ntr = 0;
+  #if COMPONENTS > 1
+   tr[ntr++] = VXt;
+   tr[ntr++] = BXt;
+  #endif
+  #if COMPONENTS == 3
+   tr[ntr++] = VXb;
+   tr[ntr++] = BXb;
+  #endif
+  for (n = 0; n < ntr; n++){
+    R = Rp[tr[n]];
+    s = w[KFASTM]*R[KFASTM] + w[KFASTP]*R[KFASTP];
+    #if COMPONENTS > 1
+     s += w[KSLOWM]*R[KSLOWM];
+     s += w[KSLOWP]*R[KSLOWP];
+    #endif
+    #if COMPONENTS == 3
+     s += w[KALFVM]*R[KALFVM];
+     s += w[KALFVP]*R[KALFVP];
+    #endif
+    v[tr[n]] = s;
+  }
+
+/* -- normal magnetic field -- */
+
+  R = Rp[BXn];
+  #ifdef GLM_MHD
+   v[BXn] = w[KPSI_GLMM]*R[KPSI_GLMM] + w[KPSI_GLMP]*R[KPSI_GLMP];
+  #elif DIVB_CONTROL == EIGHT_WAVES
+   v[BXn] = w[KDIVB]*R[KDIVB];
+  #else
+   v[BXn] = 0.0;
+  #endif
+
+/* -- pressure -- */
+
+  #if HAVE_ENERGY
+   R = Rp[PRS];
+   s = w[KFASTM]*R[KFASTM] + w[KFASTP]*R[KFASTP];
+   #if COMPONENTS > 1
+    s += w[KSLOWM]*R[KSLOWM];
+    s += w[KSLOWP]*R[KSLOWP];
+   #endif
+   v[PRS] = s;
+  #endif
+
+  #ifdef GLM_MHD
+   R = Rp[PSI_GLM];
+   v[PSI_GLM] = w[KPSI_GLMM]*R[KPSI_GLMM] + w[KPSI_GLMP]*R[KPSI_GLMP];
+  #endif
+
+/* -------------------------------------------------
+    verify that the previous simplified expressions 
+    are indeed  v = Rp.w
+   ------------------------------------------------- */
+
+#if CHECK_EIGENVECTORS == YES
+{
+  int    k, nv;
+  double v2;
+
+  for (nv = 0; nv < NFLX; nv++){
+    v2 = 0.0;
+    for (k = 0; k < NFLX; k++) v2 += Rp[nv][k]*w[k];
+    if (fabs(v[nv] - v2) > 1.e-8){
+      printf ("! CharToPrim: projection not correct, nv = %d\n",nv);
+      QUIT_PLUTO(1);
+    }
+  }
+}
+#endif
+}
@@ -174,6 +174,9 @@ void RightHandSide (const State_1D *state, Time_Step *Dts,
       phi_p[k] = BodyForcePotential(x1[i], x2[j], x3p[k]);
     }
   }
+  #if SELF_GRAVITY == YES
+   SelfGravityAddPotential (phi_p, beg-1, end);
+  #endif
 #endif
   
 /* -----------------------------------------------------
@@ -523,7 +526,7 @@ void RightHandSide (const State_1D *state, Time_Step *Dts,
 }
 #elif GEOMETRY == SPHERICAL
 {
-  double r_1, th, s, s_1;
+  double r_1, s_1;
 
   if (g_dir == IDIR) { 
     double vc[NVAR], dVdx;
@@ -610,11 +613,9 @@ IF_DUST(rhs[i][MX3_D] *= r_1;)
     r_1 = 0.5*(x1p[i]*x1p[i] - x1p[i-1]*x1p[i-1])/dV1[i];
     scrh = dt*r_1;
     for (j = beg; j <= end; j++){
-      th   = x2[j];
       dtdV = scrh/dV2[j];
       dtdx = scrh/dx2[j];
-      s    = sin(th);
-      s_1  = 1.0/s;   
+      s_1  = grid[JDIR].st_1[j];
 
     /* -- J1. initialize rhs with flux difference -- */
 
@@ -819,7 +820,7 @@ void TotalFlux (const State_1D *state, double *phi_p,
       wp = 0.0;
       #if GEOMETRY == SPHERICAL
       IF_FARGO(wp = 0.5*(wA[j][i] + wA[j][i+1]);)
-      R = x1p[i]*sin(x2[j]);  /* -- cylindrical radius -- */
+      R = x1p[i]*grid[JDIR].st[j];  /* -- cylindrical radius -- */
       #else
       IF_FARGO(wp = 0.5*(wA[k][i] + wA[k][i+1]);)
       R = x1p[i];                   /* -- cylindrical radius -- */
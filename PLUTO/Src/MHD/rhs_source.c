@@ -83,7 +83,7 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
   int    i, j, k, nv;
   double r_1, g[3];
 
-  double dtdx, scrh, th, ct, s;
+  double dtdx, scrh, ct, s;
   double Sm;
   double *x1  = grid[IDIR].x,  *x2  = grid[JDIR].x,  *x3  = grid[KDIR].x;
   double *x1p = grid[IDIR].xr, *x2p = grid[JDIR].xr, *x3p = grid[KDIR].xr;
@@ -101,6 +101,9 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
   double **Bg0, **wA, w, wp, vphi, phi_c;
   double vphi_d, Sm_d;
   double vc[NVAR], *vg;
+#if SELF_GRAVITY == YES
+  double ***Phi = SelfGravityPotential();
+#endif
 
 #ifdef FARGO
   wA = FARGO_GetVelocity();
@@ -125,8 +128,7 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
   if (g_dir == IDIR){
 
 #if GEOMETRY == SPHERICAL
-    th = x2[j];
-    s  = sin(th);
+    s  = grid[JDIR].st[j];
 #endif
 
     for (i = beg; i <= end; i++) {
@@ -149,7 +151,7 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
   
 #elif GEOMETRY == CYLINDRICAL
 
-      r_1 = 1.0/x1[i];
+      r_1 = grid[IDIR].r_1[i];
       vg  = vc;
       NFLX_LOOP(nv) vc[nv] = 0.5*(vp[i][nv] + vm[i][nv]);       
       #if COMPONENTS == 3
@@ -182,7 +184,7 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
 
 #elif GEOMETRY == SPHERICAL
 
-      r_1 = 1.0/x1[i];
+      r_1 = grid[IDIR].r_1[i];
       vg  = vc;
       NFLX_LOOP(nv) vc[nv] = 0.5*(vp[i][nv] + vm[i][nv]);
       vphi = SELECT(0.0, 0.0, vc[iVPHI]);
@@ -231,6 +233,9 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
       IF_DUST  (rhs[i][MX1_D] -= dtdx*vg[RHO_D]*(phi_p[i] - phi_p[i-1]);)
       IF_ENERGY(phi_c       = BodyForcePotential(x1[i], x2[j], x3[k]); 
                 rhs[i][ENG] -= phi_c*rhs[i][RHO];)
+  #if (SELF_GRAVITY == YES) && (HAVE_ENERGY)
+      rhs[i][ENG] -= Phi[k][j][i]*rhs[i][RHO];
+  #endif
 #endif
 
 
@@ -240,7 +245,7 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
 
     scrh = 1.0;
 #if GEOMETRY == POLAR
-    scrh = 1.0/x1[i];
+    scrh = grid[IDIR].r_1[i];
 #elif GEOMETRY == SPHERICAL
     scrh = r_1 = 0.5*(x1p[i]*x1p[i] - x1p[i-1]*x1p[i-1])/dV1[i];
 #endif
@@ -266,8 +271,7 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
 
 #elif GEOMETRY == SPHERICAL
 
-      th = x2[j];
-      s  = sin(th);
+      s  = grid[JDIR].st[j];
       ct = grid[JDIR].ct[j];
 
       vg = vc;
@@ -319,6 +323,9 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
       IF_DUST   (rhs[j][MX2_D] -= dtdx*vg[RHO_D]*(phi_p[j] - phi_p[j-1]);)
       IF_ENERGY(phi_c        = BodyForcePotential(x1[i], x2[j], x3[k]); 
                 rhs[j][ENG] -= phi_c*rhs[j][RHO];)
+  #if (SELF_GRAVITY == YES) && (HAVE_ENERGY)
+      rhs[j][ENG] -= Phi[k][j][i]*rhs[j][RHO];
+  #endif
 #endif
     }
 
@@ -365,6 +372,9 @@ void RightHandSideSource (const State_1D *state, Time_Step *Dts,
       IF_DUST  (rhs[k][MX3_D] -= dtdx*vg[RHO_D]*(phi_p[k] - phi_p[k-1]);)
       IF_ENERGY(phi_c        = BodyForcePotential(x1[i], x2[j], x3[k]);
                 rhs[k][ENG] -= phi_c*rhs[k][RHO];)
+  #if (SELF_GRAVITY == YES) && (HAVE_ENERGY)
+      rhs[k][ENG] -= Phi[k][j][i]*rhs[k][RHO];
+  #endif
 #endif
     }
   }
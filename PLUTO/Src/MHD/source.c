@@ -126,7 +126,7 @@ void Roe_DivBSource (const State_1D *state, int is, int ie, Grid *grid)
      }
    }else if (g_dir == KDIR){  /* -- phi -- */
      r = grid[IDIR].x[g_i];
-     s = sin(grid[JDIR].x[g_j]);
+     s = grid[JDIR].st[g_j];
      for (i = is; i <= ie; i++) {
        divB[i] = (vp[i] - vm[i])/(r*s*GG->dx[i]);
      }
@@ -260,7 +260,7 @@ void HLL_DivBSource (const State_1D *state, double **Uhll,
      }
    }else if (g_dir == KDIR){  /* -- phi -- */
      r = grid[IDIR].x[g_i];
-     s = sin(grid[JDIR].x[g_j]);
+     s = grid[JDIR].st[g_j];
      for (i = beg; i <= end; i++) {
        divB[i] = (vp[i] - vm[i])/(r*s*GG->dx[i]);
      }
@@ -21,12 +21,16 @@ int LUDecompose (double **a, int n, int *indx, double *d)
  * 
  *********************************************************************** */
 #define TINY 1.0e-20;
+#define LU_NMAX_STACK  32
 {
   int i, imax, j, k;
   double big, dum, sum, temp;
-  double *vv;
+  double *vv, vv_stack[LU_NMAX_STACK];
 
-  vv = ARRAY_1D (n, double);
+/* -- avoid heap allocation for small systems (called once per zone) -- */
+
+  if (n <= LU_NMAX_STACK) vv = vv_stack;
+  else                    vv = ARRAY_1D (n, double);
   *d = 1.0;
   for (i = 0; i < n; i++) {
     big = 0.0;
@@ -35,6 +39,7 @@ int LUDecompose (double **a, int n, int *indx, double *d)
         big = temp;
     if (big == 0.0) {
 /*      print1 ("! Singular matrix in routine LUDecompose - (i=%d, j=%d)",i,j); */
+      if (vv != vv_stack) FreeArray1D(vv);
       return (0);
     }
     vv[i] = 1.0 / big;
@@ -75,10 +80,11 @@ int LUDecompose (double **a, int n, int *indx, double *d)
         a[i][j] *= dum;
     }
   }
-  FreeArray1D(vv);
+  if (vv != vv_stack) FreeArray1D(vv);
   return (1); /* -- success -- */
 }
 #undef TINY
+#undef LU_NMAX_STACK
 
 /* ********************************************************************* */
 void LUBackSubst (double **a, int n, int *indx, double b[])
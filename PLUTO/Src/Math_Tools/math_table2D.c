@@ -3,13 +3,32 @@
   \file
   \brief Miscellaneous functions for handling 2D tables.
 
+  Rows that are positive and strictly increasing are given, by 
+  FinalizeTable2D(), an auxiliary index built on ::TABLE2D_NF bins 
+  equally spaced in \c log10(f).
+  The bin of a given value is found by a simple division and 
+  brackets the corresponding column index, so that 
+  InverseLookupTable2D() needs to search only among the few nodes 
+  falling in that bin instead of the whole row.
+
+  Tables can be saved to and restored from a binary cache file with
+  WriteTable2D() and ReadTable2D() to avoid recomputing them at every
+  startup.
+
   \author A. Mignone (mignone@ph.unito.it)
   \date   March 16, 2015
 */
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
 
+#ifndef TABLE2D_NF
+ #define TABLE2D_NF  512  /* Number of log10(f) bins used by row index */
+#endif
+
+#define TABLE2D_MAGIC  "PLUTO_TABLE2D_v1"
+
 void PlotCubic(double a, double b, double c, double d);
+static int LocateRowIndex (Table2D *, int, double);
 
 /* ********************************************************************* */
 void InitializeTable2D (Table2D *tab, double xmin, double xmax, int nx,
@@ -77,6 +96,8 @@ void InitializeTable2D (Table2D *tab, double xmin, double xmax, int nx,
 
   tab->dfx  = ARRAY_2D(tab->ny, tab->nx, double);
   tab->dfy  = ARRAY_2D(tab->ny, tab->nx, double);
+
+  tab->i    = NULL;  /* -- row index is built by FinalizeTable2D() -- */
 /*
    -- (beta) function index bookeeping --
     tab->fmin = ARRAY_1D(tab->ny, double);
@@ -119,11 +140,17 @@ void InitializeTable2D (Table2D *tab, double xmin, double xmax, int nx,
 }
 /* ********************************************************************* */
 void FinalizeTable2D(Table2D *tab)
-/*
+/*!
+ * Compute forward differences and, for rows that are positive and 
+ * strictly increasing, the index <tt>tab->i[j][k]</tt> of the last 
+ * node with <tt> log10(f) <= fmin[j] + k*df[j] </tt>, where \c fmin 
+ * and \c df are the row minimum and bin width in \c log10(f).
+ * A row with <tt> df[j] <= 0 </tt> has no index.
  *
  *********************************************************************** */
 {
-  int i,j;
+  int i,j,k;
+  double lnf;
   
 /* -------------------------------------------------------
     Compute forward differences 
@@ -138,6 +165,65 @@ void FinalizeTable2D(Table2D *tab)
     tab->dfy[j][i] = tab->f[j+1][i] - tab->f[j][i];
   }}
 
+/* -------------------------------------------------------
+    Build row index on log10(f) bins
+   ------------------------------------------------------- */
+
+  if (tab->i == NULL){
+    tab->nf   = TABLE2D_NF;
+    tab->fmin = ARRAY_1D(tab->ny, double);
+    tab->fmax = ARRAY_1D(tab->ny, double);
+    tab->df   = ARRAY_1D(tab->ny, double);
+    tab->i    = ARRAY_2D(tab->ny, tab->nf + 1, int);
+  }
+
+  for (j = 0; j < tab->ny; j++){
+    tab->df[j] = -1.0;
+    if (tab->f[j][0] <= 0.0) continue;
+    for (i = 0; i < tab->nx-1; i++) if (tab->dfx[j][i] <= 0.0) break;
+    if (i < tab->nx-1) continue;   /* -- not strictly increasing -- */
+
+    tab->fmin[j] = log10(tab->f[j][0]);
+    tab->fmax[j] = log10(tab->f[j][tab->nx-1]);
+    tab->df[j]   = (tab->fmax[j] - tab->fmin[j])/(double)tab->nf;
+
+    i = 0;
+    for (k = 0; k <= tab->nf; k++){
+      lnf = tab->fmin[j] + k*tab->df[j];
+      while (i < tab->nx-1 && log10(tab->f[j][i+1]) <= lnf) i++;
+      tab->i[j][k] = i;
+    }
+  }
+}
+
+/* ********************************************************************* */
+int LocateRowIndex (Table2D *tab, int j, double f)
+/*!
+ * Return the column index \c i such that <tt>f[j][i] <= f < f[j][i+1]</tt>
+ * (same as LocateIndex() on row \c j) using, when available, the 
+ * row index to restrict the search to a single \c log10(f) bin.
+ *
+ *********************************************************************** */
+{
+  int k, ib, ie;
+  double *fr = tab->f[j];
+
+  if (tab->i == NULL || tab->df[j] <= 0.0) {
+    return LocateIndex(fr, 0, tab->nx-1, f);
+  }
+  if (f < fr[0] || f > fr[tab->nx-1]) return -1;
+
+  k  = INT_FLOOR((log10(f) - tab->fmin[j])/tab->df[j]);
+  k  = MAX(k, 0);
+  k  = MIN(k, tab->nf - 1);
+  ib = tab->i[j][k];
+  ie = MIN(tab->i[j][k+1] + 1, tab->nx-1);
+
+/* -- guard against round-off at the bin edges -- */
+
+  if (f < fr[ib] || f > fr[ie]) return LocateIndex(fr, 0, tab->nx-1, f);
+  if (f == fr[tab->nx-1]) return tab->nx-1;
+  return LocateIndex(fr, ib, ie, f);
 }
 
 /* ********************************************************************* */
@@ -257,8 +343,8 @@ int InverseLookupTable2D (Table2D *tab, double y, double f, double *x)
    yn  = (y - tab->y[j])/tab->dy[j];
   #endif
 
-  i0 = LocateIndex(tab->f[j],   0, tab->nx-1, f);
-  i1 = LocateIndex(tab->f[j+1], 0, tab->nx-1, f);
+  i0 = LocateRowIndex(tab, j,   f);
+  i1 = LocateRowIndex(tab, j+1, f);
 
   if (i0 < 0 || i1 < 0) return 2;
 
@@ -568,6 +654,91 @@ void WriteBinaryTable2D (char *fname, Table2D *tab)
   fclose(fp);
 }
 
+/* ********************************************************************* */
+void WriteTable2D (char *fname, Table2D *tab)
+/*!
+ * Save the table to the binary cache file \c fname so that it can be 
+ * restored with ReadTable2D().
+ * The file contains a short header (table size, bounds and 
+ * interpolation type) followed by the node values and the spline 
+ * coefficients, in the native byte order.
+ *
+ *********************************************************************** */
+{
+  int  hdr[3];
+  long n = (long)tab->nx*tab->ny;
+  double bnd[4];
+  FILE *fp;
+
+  fp = fopen(fname,"wb");
+  if (fp == NULL){
+    print1 ("! WriteTable2D(): cannot open %s\n",fname);
+    return;
+  }
+  hdr[0] = tab->nx; hdr[1] = tab->ny; hdr[2] = tab->interpolation;
+  bnd[0] = tab->lnxmin; bnd[1] = tab->lnxmax;
+  bnd[2] = tab->lnymin; bnd[3] = tab->lnymax;
+
+  fwrite (TABLE2D_MAGIC, sizeof(char), strlen(TABLE2D_MAGIC), fp);
+  fwrite (hdr, sizeof(int), 3, fp);
+  fwrite (bnd, sizeof(double), 4, fp);
+  fwrite (tab->f[0], sizeof(double), n, fp);
+  fwrite (tab->a[0], sizeof(double), n, fp);
+  fwrite (tab->b[0], sizeof(double), n, fp);
+  fwrite (tab->c[0], sizeof(double), n, fp);
+  fwrite (tab->d[0], sizeof(double), n, fp);
+  fclose(fp);
+}
+
+/* ********************************************************************* */
+int ReadTable2D (char *fname, Table2D *tab)
+/*!
+ * Restore node values and spline coefficients from a cache file 
+ * written by WriteTable2D().
+ * The table must have already been initialized with 
+ * InitializeTable2D() using the same size and bounds; 
+ * FinalizeTable2D() must be called afterwards.
+ *
+ * \return 0 on success, 1 if the file does not exist or does not 
+ *         match the table.
+ *********************************************************************** */
+{
+  int  hdr[3];
+  long n = (long)tab->nx*tab->ny, nr;
+  char magic[64];
+  double bnd[4];
+  FILE *fp;
+
+  fp = fopen(fname,"rb");
+  if (fp == NULL) return 1;
+
+  nr = fread (magic, sizeof(char), strlen(TABLE2D_MAGIC), fp);
+  magic[nr] = '\0';
+  if (strcmp(magic, TABLE2D_MAGIC) != 0 ||
+      fread (hdr, sizeof(int), 3, fp) != 3 ||
+      fread (bnd, sizeof(double), 4, fp) != 4){
+    fclose(fp);
+    return 1;
+  }
+
+  if (   hdr[0] != tab->nx     || hdr[1] != tab->ny
+      || bnd[0] != tab->lnxmin || bnd[1] != tab->lnxmax 
+      || bnd[2] != tab->lnymin || bnd[3] != tab->lnymax){
+    fclose(fp);
+    return 1;
+  }
+
+  tab->interpolation = hdr[2];
+  nr  = fread (tab->f[0], sizeof(double), n, fp);
+  nr += fread (tab->a[0], sizeof(double), n, fp);
+  nr += fread (tab->b[0], sizeof(double), n, fp);
+  nr += fread (tab->c[0], sizeof(double), n, fp);
+  nr += fread (tab->d[0], sizeof(double), n, fp);
+  fclose(fp);
+  
+  return (nr != 5*n);
+}
+
 void PlotCubic(double a, double b, double c, double d)
 {
   double t, f, dt = 1.e-1;
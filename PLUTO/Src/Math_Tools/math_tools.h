@@ -97,7 +97,9 @@ void InitializeTable2D (Table2D *, double, double, int, double, double, int);
 void FinalizeTable2D   (Table2D *);
 int  Table2DInterpolate   (Table2D *, double, double, double *);
 int  InverseLookupTable2D (Table2D *, double, double, double *);
+int  ReadTable2D (char *, Table2D *);
 void WriteBinaryTable2D (char *, Table2D *);
+void WriteTable2D (char *, Table2D *);
 
 /* -- Functions containd in math_interp.c -- */
 
@@ -0,0 +1,1097 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Nested static grids: initialization, subcycling, interpolation,
+         restriction and refluxing.
+
+  Level \c l (1 <= l <= ::NESTED_LEVELS) is a box of
+  <tt> NX1/2 x NX2/2 x NX3/2 </tt> zones of level <tt> l-1 </tt>
+  discretized with \c NX1 x \c NX2 x \c NX3 zones.
+  Since all levels have the same global size, they share the
+  domain decomposition: every processor owns the same index range on
+  every level, although the physical region is different.
+  Inter-level operations (gathering parent data around a box,
+  restriction and flux registers) are therefore carried out on small
+  buffers addressed by global indices.
+  In parallel, each processor only exchanges the portion of these
+  buffers overlapping the zones it owns with the processors that
+  need it (point-to-point), so the communication volume per
+  processor does not grow with the box size.
+
+  The recursive time step on level \c l with time step \c dt is:
+  -# set boundary conditions at \c t and store the parent primitive
+     variables around the child box (\c vold);
+  -# advance level \c l with Integrate();
+  -# set boundary conditions at <tt> t + dt </tt> and store the
+     parent variables again (\c vnew);
+  -# advance level <tt> l+1 </tt> twice with <tt> dt/2 </tt>;
+     child ghost zones are interpolated linearly in time between
+     \c vold and \c vnew;
+  -# replace parent zones covered by the child with the average of
+     the child conservative variables and correct the parent zones
+     adjacent to the box using the difference between the fine and
+     coarse fluxes accumulated on the coarse-fine interfaces.
+
+  The time step of the next cycle is computed on the base level using
+  the most restrictive constraint among all levels.
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+/* ---------------------------------------------------------------
+    With the finite volume schemes (USE_PR_GRADIENT == YES in
+    rhs.c) pressure is not included in the normal momentum flux
+    and must be added explicitly to the flux registers.
+   --------------------------------------------------------------- */
+
+#ifdef FINITE_DIFFERENCE
+ #define NESTED_ADD_PRESSURE  NO
+#else
+ #define NESTED_ADD_PRESSURE  YES
+#endif
+
+typedef struct NESTED_LEVEL{
+  Data      d;
+  Grid      grid[3];
+  Time_Step Dts;
+  Data      *dp;         /* pointers to the structures of this level  */
+  Grid      *gp;         /* (level 0 points to those of main)         */
+  Time_Step *Dtsp;
+  int    ib[3], ie[3];   /* box extent in parent zones (global interior
+                            indices, ib = ie = 0 for unused dims)     */
+  int    phys[3][2];     /* 1 if the side lies on a physical boundary */
+  int    hs[3];          /* box size in parent zones                  */
+  int    rb[3], nb[3];   /* rim width and size of parent buffers      */
+  double time, t0, dt0;
+  double ****vold;       /* parent primitive variables at t0          */
+  double ****vnew;       /* parent primitive variables at t0 + dt0    */
+  double *freg[3][2][2]; /* flux registers [dir][side][coarse/fine]   */
+  int    nreg[3];
+} NestedLevel;
+
+static NestedLevel nest[NESTED_MAX_LEVELS + 1];
+static int nest_nlev = 0;
+
+static Riemann_Solver *nest_solver;
+static int (*nest_integrate)(Data *, Riemann_Solver *, Time_Step *, Grid *);
+
+static double *nest_rbuf;   /* scratch buffer for restriction/reductions */
+static double **nest_v, **nest_u;
+static unsigned char *nest_flag;
+
+#ifdef PARALLEL
+static int nest_nproc;
+static int ***nest_dom;     /* global interior index range [p][dir][0/1]
+                               owned by processor p on every level     */
+static int ***nest_src;     /* regions contributed [p][dir][0/1] ...   */
+static int ***nest_dst;     /* ... and needed by processor p           */
+#endif
+
+static void MakeLevel (int, Runtime *);
+static void GatherParent (int, double ****, int);
+static void Prolong (int, const Data *, int);
+static void Restrict (int);
+static void Reflux (int);
+static int  NestedStep (int, double);
+static void NestedBoxSum (double *, int *, int, int, int);
+#ifdef PARALLEL
+static void Overlap3D (int **, int **, int *, int *, int *);
+static void SetRange (int ***, int, int, int, int, int);
+#endif
+
+#define GLOB_INDEX(n, G)  ((n) - (G)->lbeg + (G)->beg - (G)->gbeg)
+#define FLOOR2(n)         (((n) < 0 ? (n) - 1:(n))/2)
+
+/* ********************************************************************* */
+void Nested_Init (Data *d, Runtime *ini, Grid *grid)
+/*!
+ * Build the refined levels, assign their initial conditions and
+ * restrict them onto the coarser levels.
+ *
+ * \param [in,out] d     pointer to the base level Data structure
+ * \param [in]     ini   pointer to the Runtime structure
+ * \param [in]     grid  pointer to the base level array of Grid
+ *                       structures
+ *********************************************************************** */
+{
+  int    l, nbuf, dir;
+  char   fname[512];
+  FILE   *fp;
+  NestedLevel *L;
+
+  nest_nlev = NESTED_LEVELS;
+  if (nest_nlev > NESTED_MAX_LEVELS){
+    print1 ("! Nested_Init: NESTED_LEVELS cannot exceed %d\n",
+             NESTED_MAX_LEVELS);
+    QUIT_PLUTO(1);
+  }
+
+  L = nest;
+  L->dp   = d;
+  L->gp   = grid;
+  L->Dtsp = NULL;  /* -- assigned in Nested_Integrate() -- */
+  for (dir = 0; dir < 3; dir++){
+    L->phys[dir][0] = L->phys[dir][1] = 1;
+    L->ib[dir] = 0;
+    L->ie[dir] = grid[dir].np_int_glob - 1;
+  }
+
+  nest_v    = ARRAY_2D(NMAX_POINT, NVAR, double);
+  nest_u    = ARRAY_2D(NMAX_POINT, NVAR, double);
+  nest_flag = ARRAY_1D(NMAX_POINT, unsigned char);
+
+/* -- index ranges owned by all processors (same on every level) -- */
+
+  #ifdef PARALLEL
+  {
+    int dom[3][2];
+
+    MPI_Comm_size (MPI_COMM_WORLD, &nest_nproc);
+    nest_dom = ARRAY_3D(nest_nproc, 3, 2, int);
+    nest_src = ARRAY_3D(nest_nproc, 3, 2, int);
+    nest_dst = ARRAY_3D(nest_nproc, 3, 2, int);
+    for (dir = 0; dir < 3; dir++){
+      dom[dir][0] = grid[dir].beg - grid[dir].gbeg;
+      dom[dir][1] = grid[dir].end - grid[dir].gbeg;
+    }
+    MPI_Allgather (dom[0], 6, MPI_INT, nest_dom[0][0], 6, MPI_INT,
+                   MPI_COMM_WORLD);
+  }
+  #endif
+
+  print1 ("\n> Nested grids (%d levels)\n\n", nest_nlev);
+  for (l = 1; l <= nest_nlev; l++) MakeLevel (l, ini);
+
+/* -- scratch buffer for restriction (boxes have the same size) -- */
+
+  nbuf = NVAR*nest[1].hs[IDIR]*nest[1].hs[JDIR]*nest[1].hs[KDIR];
+  nest_rbuf = ARRAY_1D(nbuf, double);
+
+/* -- initial conditions on refined levels, then restrict -- */
+
+  for (l = 1; l <= nest_nlev; l++) Startup (nest[l].dp, nest[l].gp);
+  for (l = nest_nlev; l >= 1; l--) Restrict (l);
+
+/* -- write grid files -- */
+
+  if (prank == 0){
+    for (l = 1; l <= nest_nlev; l++){
+      Grid *G = nest[l].gp;
+      int  i;
+
+      sprintf (fname, "%s/nest%d_grid.out", ini->output_dir, l);
+      fp = fopen (fname, "w");
+      fprintf(fp, "# GEOMETRY:   %s\n", "CARTESIAN");
+      for (dir = 0; dir < 3; dir++){
+        fprintf (fp, "%d \n", G[dir].np_int_glob);
+        for (i = 0; i < G[dir].np_int_glob; i++){
+          fprintf (fp, " %d  %f    %f\n", i + 1,
+                   G[dir].xl_glob[i + G[dir].gbeg],
+                   G[dir].xr_glob[i + G[dir].gbeg]);
+        }
+      }
+      fclose (fp);
+    }
+  }
+}
+
+/* ********************************************************************* */
+void MakeLevel (int l, Runtime *ini)
+/*!
+ * Define the box, grid, data and time step structures of level \c l.
+ *
+ *********************************************************************** */
+{
+  int    dir, n, nx, half, ngh, s, d1, d2;
+  double xs, dxf, x0;
+  NestedLevel *P = nest + l - 1, *L = nest + l;
+  Grid  *Gp, *G;
+
+  Gp = P->gp;
+  G  = L->grid;
+
+/* --------------------------------------------------------
+    1. Box position and coarse-fine sides
+   -------------------------------------------------------- */
+
+  for (dir = 0; dir < 3; dir++){
+    L->ib[dir] = L->ie[dir] = 0;
+    L->hs[dir] = L->nb[dir] = 1;
+    L->rb[dir] = 0;
+    L->phys[dir][0] = L->phys[dir][1] = 1;
+  }
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    nx   = Gp[dir].np_int_glob;
+    ngh  = Gp[dir].nghost;
+    half = nx/2;
+    if (nx%2 != 0 || nx < 4){
+      print1 ("! Nested_Init: the number of zones in direction %d must be even and >= 4\n",
+               dir + 1);
+      QUIT_PLUTO(1);
+    }
+    if (!Gp[dir].uniform){
+      print1 ("! Nested_Init: grid must be uniform in direction %d\n", dir + 1);
+      QUIT_PLUTO(1);
+    }
+
+  /* -- parent zone coordinate of the box center -- */
+
+    xs = (ini->nest_center[dir] - Gp[dir].xl_glob[Gp[dir].gbeg])
+         /Gp[dir].dx_glob[Gp[dir].gbeg];
+    L->ib[dir] = (int)floor(xs - 0.5*half + 0.5);
+    L->ib[dir] = MAX(L->ib[dir], 0);
+    L->ib[dir] = MIN(L->ib[dir], nx - half);
+
+  /* -- a box cannot touch a coarse-fine side of its parent -- */
+
+    if (L->ib[dir] == 0 && !P->phys[dir][0]) L->ib[dir] = 1;
+    if (L->ib[dir] + half == nx && !P->phys[dir][1]) L->ib[dir] = nx - half - 1;
+    L->ie[dir] = L->ib[dir] + half - 1;
+
+    L->phys[dir][0] = (L->ib[dir] == 0);
+    L->phys[dir][1] = (L->ie[dir] == nx - 1);
+    for (s = 0; s < 2; s++){
+      n = (s == 0 ? ini->left_bound[dir]:ini->right_bound[dir]);
+      if (L->phys[dir][s] && (n == PERIODIC || n == SHEARING)){
+        print1 ("! Nested_Init: level %d touches a periodic boundary\n", l);
+        QUIT_PLUTO(1);
+      }
+    }
+
+    L->hs[dir] = half;
+    L->rb[dir] = (ngh + 1)/2 + 1;
+    L->nb[dir] = half + 2*L->rb[dir];
+  }
+
+/* --------------------------------------------------------
+    2. Grid: same indices as the parent, coordinates of
+       the box with half the mesh spacing.
+   -------------------------------------------------------- */
+
+  for (dir = 0; dir < 3; dir++){
+    G[dir] = Gp[dir];
+    if (dir >= DIMENSIONS) continue;
+
+    nx  = G[dir].np_tot_glob;
+    dxf = 0.5*Gp[dir].dx_glob[Gp[dir].gbeg];
+    x0  = Gp[dir].xl_glob[Gp[dir].gbeg + L->ib[dir]];
+
+    G[dir].x_glob  = ARRAY_1D(nx, double);
+    G[dir].xl_glob = ARRAY_1D(nx, double);
+    G[dir].xr_glob = ARRAY_1D(nx, double);
+    G[dir].dx_glob = ARRAY_1D(nx, double);
+    for (n = 0; n < nx; n++){
+      G[dir].dx_glob[n] = dxf;
+      G[dir].xl_glob[n] = x0 + (n - G[dir].gbeg)*dxf;
+      G[dir].xr_glob[n] = G[dir].xl_glob[n] + dxf;
+      G[dir].x_glob[n]  = G[dir].xl_glob[n] + 0.5*dxf;
+    }
+    ngh = G[dir].nghost;
+    G[dir].x  = G[dir].x_glob  + G[dir].beg - ngh;
+    G[dir].xr = G[dir].xr_glob + G[dir].beg - ngh;
+    G[dir].xl = G[dir].xl_glob + G[dir].beg - ngh;
+    G[dir].dx = G[dir].dx_glob + G[dir].beg - ngh;
+
+    G[dir].xi = x0;
+    G[dir].xf = x0 + G[dir].np_int_glob*dxf;
+    G[dir].dl_min = 0.5*Gp[dir].dl_min;
+    G[dir].uniform = 1;
+
+    if (!L->phys[dir][0]) G[dir].lbound = 0;
+    if (!L->phys[dir][1]) G[dir].rbound = 0;
+  }
+  for (dir = 0; dir < 3; dir++) G[dir].level = l;
+  MakeGeometry (G);
+  L->gp = G;
+
+/* --------------------------------------------------------
+    3. Data and time step structures
+   -------------------------------------------------------- */
+
+  memset (&L->d, 0, sizeof(Data));
+  L->d.Vc   = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  L->d.Uc   = ARRAY_4D(NX3_TOT, NX2_TOT, NX1_TOT, NVAR, double);
+  L->d.flag = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, unsigned char);
+  #if UPDATE_VECTOR_POTENTIAL == YES
+   D_EXPAND(                                                   ,
+     L->d.Ax3 = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);  ,
+     L->d.Ax1 = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+     L->d.Ax2 = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+   )
+  #endif
+  #if RESISTIVITY != NO
+   L->d.J = ARRAY_4D(3, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  #endif
+  L->dp = &L->d;
+
+  L->Dts.cmax     = ARRAY_1D(NMAX_POINT, double);
+  L->Dts.inv_dta  = 0.0;
+  L->Dts.inv_dtp  = 0.5e-38;
+  L->Dts.dt_cool  = 1.e38;
+  L->Dts.cfl      = ini->cfl;
+  L->Dts.cfl_par  = ini->cfl_par;
+  L->Dts.rmax_par = ini->rmax_par;
+  L->Dts.Nsts     = L->Dts.Nrkc = 0;
+  L->Dtsp = &L->Dts;
+
+/* --------------------------------------------------------
+    4. Parent buffers and flux registers
+   -------------------------------------------------------- */
+
+  L->vold = ARRAY_4D(NVAR, L->nb[KDIR], L->nb[JDIR], L->nb[IDIR], double);
+  L->vnew = ARRAY_4D(NVAR, L->nb[KDIR], L->nb[JDIR], L->nb[IDIR], double);
+  for (dir = 0; dir < 3; dir++){
+    d1 = (dir == IDIR ? JDIR:IDIR);
+    d2 = (dir == KDIR ? JDIR:KDIR);
+    L->nreg[dir] = NVAR*L->hs[d1]*L->hs[d2];
+    for (s = 0; s < 2; s++){
+      L->freg[dir][s][0] = NULL;
+      L->freg[dir][s][1] = NULL;
+      if (dir >= DIMENSIONS || L->phys[dir][s]) continue;
+      L->freg[dir][s][0] = ARRAY_1D(2*L->nreg[dir], double);
+      L->freg[dir][s][1] = L->freg[dir][s][0] + L->nreg[dir];
+    }
+  }
+
+  print1 ("  Level %d: [%f, %f]", l, G[IDIR].xi, G[IDIR].xf);
+  D_EXPAND(                                           ,
+           print1 (" x [%f, %f]", G[JDIR].xi, G[JDIR].xf);  ,
+           print1 (" x [%f, %f]", G[KDIR].xi, G[KDIR].xf);)
+  print1 ("\n");
+}
+
+/* ********************************************************************* */
+void Nested_Restart (Output *output, int swap_endian)
+/*!
+ * Restore the refined levels after the base level has been read.
+ * Each level is read from its own file when available, otherwise it
+ * is re-initialized by interpolation from its (restored) parent.
+ *
+ * \param [in] output       pointer to the (.dbl) Output structure
+ *                          being restarted from, or NULL when
+ *                          restarting from HDF5 output
+ * \param [in] swap_endian  a flag for swapping endianity
+ *********************************************************************** */
+{
+  int l;
+  NestedLevel *L;
+
+  for (l = 1; l <= nest_nlev; l++){
+    L = nest + l;
+    if (output != NULL && Nested_ReadData (output, l, swap_endian)) continue;
+
+    print1 ("> Nested_Restart: level %d interpolated from level %d\n", l, l-1);
+    g_intStage = 1;
+    Boundary (nest[l-1].dp, ALL_DIR, nest[l-1].gp);
+    GatherParent (l, L->vold, 1);
+    memcpy (L->vnew[0][0][0], L->vold[0][0][0],
+            NVAR*L->nb[KDIR]*L->nb[JDIR]*L->nb[IDIR]*sizeof(double));
+    L->t0  = g_time;
+    L->dt0 = 1.0;
+    Prolong (l, L->dp, 1);
+  }
+}
+
+/* ********************************************************************* */
+int Nested_Integrate (Data *d, Riemann_Solver *Solver, Time_Step *Dts,
+                      Grid *grid,
+                      int (*Integrate)(Data *, Riemann_Solver *,
+                                       Time_Step *, Grid *))
+/*!
+ * Advance all levels by one base level time step ::g_dt.
+ *
+ * \param [in,out] d          pointer to the base level Data structure
+ * \param [in]     Solver     the Riemann solver
+ * \param [in,out] Dts        pointer to the base level Time_Step
+ *                            structure; on output it contains the
+ *                            time step constraints of all levels
+ * \param [in]     grid       pointer to the base level array of Grid
+ *                            structures
+ * \param [in]     Integrate  the single-level integrator
+ *
+ * \return 0 on success, 1 if any level failed.
+ *********************************************************************** */
+{
+  int    err;
+  double t = g_time, dt = g_dt;
+
+  nest[0].Dtsp   = Dts;
+  nest[0].time   = g_time;
+  nest_solver    = Solver;
+  nest_integrate = Integrate;
+
+  err = NestedStep (0, g_dt);
+
+  g_time = t;
+  g_dt   = dt;
+  return err;
+}
+
+/* ********************************************************************* */
+int NestedStep (int l, double dt)
+/*!
+ * Advance level \c l by \c dt followed by two steps of level \c l+1
+ * and synchronization.
+ *
+ *********************************************************************** */
+{
+  int    dir, s, err = 0;
+  double t, scale;
+  NestedLevel *L = nest + l, *C = nest + l + 1;
+  Time_Step   *D0 = nest[0].Dtsp;
+
+  t = L->time;
+
+/* -- parent values at the beginning of the step -- */
+
+  if (l < nest_nlev){
+    g_time = t;
+    g_intStage = 1;
+    Boundary (L->dp, ALL_DIR, L->gp);
+    GatherParent (l + 1, C->vold, 0);
+    for (dir = 0; dir < DIMENSIONS; dir++){
+    for (s = 0; s < 2; s++){
+      if (C->freg[dir][s][0] == NULL) continue;
+      memset (C->freg[dir][s][0], 0, 2*C->nreg[dir]*sizeof(double));
+    }}
+  }
+
+  g_time = t;
+  g_dt   = dt;
+  err = nest_integrate (L->dp, nest_solver, L->Dtsp, L->gp);
+
+/* -- fold time step constraints into the base level -- */
+
+  if (l > 0){
+    scale = (double)(1 << l);
+    D0->inv_dta = MAX(D0->inv_dta, L->Dts.inv_dta/scale);
+    D0->inv_dtp = MAX(D0->inv_dtp, L->Dts.inv_dtp/scale);
+    D0->dt_cool = MIN(D0->dt_cool, L->Dts.dt_cool*scale);
+    D0->Nsts    = MAX(D0->Nsts, L->Dts.Nsts);
+    D0->Nrkc    = MAX(D0->Nrkc, L->Dts.Nrkc);
+
+    DIM_LOOP(dir) L->Dts.cmax[dir] = 0.0;
+    L->Dts.inv_dta = 0.0;
+    L->Dts.inv_dtp = 0.5e-38;
+    L->Dts.dt_cool = 1.e38;
+  }
+
+/* -- advance the child level and synchronize -- */
+
+  if (l < nest_nlev){
+    g_time = t + dt;
+    g_intStage = 1;
+    Boundary (L->dp, ALL_DIR, L->gp);
+    GatherParent (l + 1, C->vnew, 0);
+
+    C->t0   = t;
+    C->dt0  = dt;
+    C->time = t;
+    err += NestedStep (l + 1, 0.5*dt);
+    err += NestedStep (l + 1, 0.5*dt);
+
+    Restrict (l + 1);
+    Reflux (l + 1);
+  }
+
+  L->time = t + dt;
+  return (err != 0);
+}
+
+/* ********************************************************************* */
+void Nested_Boundary (const Data *d, Grid *grid)
+/*!
+ * Fill ghost zones of a refined level lying on coarse-fine sides
+ * by interpolation of the parent level.
+ * It is called at the end of Boundary() and does nothing on the base
+ * level.
+ *
+ *********************************************************************** */
+{
+  int l;
+
+  for (l = 1; l <= nest_nlev; l++) if (grid == nest[l].gp) break;
+  if (l > nest_nlev) return;
+  Prolong (l, d, 0);
+}
+
+/* ********************************************************************* */
+void Prolong (int l, const Data *d, int all)
+/*!
+ * Interpolate the parent buffers of level \c l linearly in time and
+ * (minmod-limited) in space.
+ *
+ * \param [in]  l    the level
+ * \param [out] d    pointer to the level Data structure
+ * \param [in]  all  when 1, fill every zone; otherwise only ghost
+ *                   zones on coarse-fine sides.
+ *********************************************************************** */
+{
+  int    i, j, k, nv, dir, inside;
+  int    G[3], p[3], pm[3], pp[3], fl;
+  double alpha, s[3], v0, vp, vm, q;
+  NestedLevel *L = nest + l;
+  Grid  *grid = L->gp;
+  double ****vo = L->vold, ****vn = L->vnew;
+  #if TIME_STEPPING == RK3
+   double cstage[3] = {0.0, 1.0, 0.5};  /* -- stage times / dt -- */
+  #else
+   double cstage[3] = {0.0, 1.0, 0.0};
+  #endif
+
+  alpha = (g_time + cstage[g_intStage - 1]*g_dt - L->t0)/L->dt0;
+  alpha = MAX(alpha, 0.0);
+  alpha = MIN(alpha, 1.0);
+
+  #define VINT(nv,a)  ((1.0 - alpha)*vo[nv][a[KDIR]][a[JDIR]][a[IDIR]] \
+                              + alpha*vn[nv][a[KDIR]][a[JDIR]][a[IDIR]])
+
+  for (dir = 0; dir < 3; dir++){
+    G[dir] = p[dir] = 0;
+    s[dir] = 0.0;
+  }
+
+  TOT_LOOP(k,j,i){
+    D_EXPAND(G[IDIR] = GLOB_INDEX(i, grid + IDIR);  ,
+             G[JDIR] = GLOB_INDEX(j, grid + JDIR);  ,
+             G[KDIR] = GLOB_INDEX(k, grid + KDIR);)
+
+    if (!all){
+      inside = 1;
+      for (dir = 0; dir < DIMENSIONS; dir++){
+        if (G[dir] < 0 && !L->phys[dir][0]) inside = 0;
+        if (G[dir] >= grid[dir].np_int_glob && !L->phys[dir][1]) inside = 0;
+      }
+      if (inside) continue;
+    }
+
+    for (dir = 0; dir < DIMENSIONS; dir++){
+      fl     = FLOOR2(G[dir]);
+      p[dir] = fl + L->rb[dir];
+      s[dir] = (G[dir] == 2*fl ? -0.25:0.25);
+    }
+
+    for (nv = 0; nv < NVAR; nv++){
+      v0 = q = VINT(nv, p);
+      for (dir = 0; dir < DIMENSIONS; dir++){
+        pm[0] = pp[0] = p[0];
+        pm[1] = pp[1] = p[1];
+        pm[2] = pp[2] = p[2];
+        pm[dir]--;
+        pp[dir]++;
+        vm = VINT(nv, pm);
+        vp = VINT(nv, pp);
+        q += s[dir]*MINMOD(vp - v0, v0 - vm);
+      }
+      d->Vc[nv][k][j][i] = q;
+    }
+  }
+  #undef VINT
+}
+
+/* ********************************************************************* */
+void GatherParent (int l, double ****buf, int all)
+/*!
+ * Copy the primitive variables of level <tt> l-1 </tt> around the
+ * box of level \c l into \c buf.
+ * On output, each processor holds the parent zones required by
+ * Prolong() to fill its own zones of level \c l.
+ *
+ * \param [in]  l    the level
+ * \param [out] buf  the parent buffer (vold or vnew)
+ * \param [in]  all  1 if Prolong() will fill every zone, 0 if only
+ *                   ghost zones on coarse-fine sides.
+ *********************************************************************** */
+{
+  int    i, j, k, nv, dir, ok, n;
+  int    G[3], p[3], loc[3];
+  NestedLevel *P = nest + l - 1, *L = nest + l;
+  Grid  *grid = P->gp;
+  double ****Vc = P->dp->Vc;
+
+  n = NVAR*L->nb[KDIR]*L->nb[JDIR]*L->nb[IDIR];
+  memset (buf[0][0][0], 0, n*sizeof(double));
+
+  for (dir = 0; dir < 3; dir++) G[dir] = p[dir] = 0;
+  TOT_LOOP(k,j,i){
+    loc[IDIR] = i; loc[JDIR] = j; loc[KDIR] = k;
+    ok = 1;
+    for (dir = 0; dir < DIMENSIONS && ok; dir++){
+      G[dir] = GLOB_INDEX(loc[dir], grid + dir);
+      p[dir] = G[dir] - L->ib[dir] + L->rb[dir];
+      if (p[dir] < 0 || p[dir] >= L->nb[dir]) ok = 0;
+
+    /* -- a zone is owned by one processor only -- */
+
+      if (loc[dir] < grid[dir].lbeg && grid[dir].beg != grid[dir].gbeg) ok = 0;
+      if (loc[dir] > grid[dir].lend && grid[dir].end != grid[dir].gend) ok = 0;
+    }
+    if (!ok) continue;
+    for (nv = 0; nv < NVAR; nv++) {
+      buf[nv][p[KDIR]][p[JDIR]][p[IDIR]] = Vc[nv][k][j][i];
+    }
+  }
+
+  #ifdef PARALLEL
+  {
+    int p, b, e, ngh, need;
+    int N[3];
+
+    for (dir = 0; dir < 3; dir++) N[dir] = grid[dir].np_int_glob;
+    for (p = 0; p < nest_nproc; p++){
+      need = all;
+      for (dir = 0; dir < DIMENSIONS; dir++){
+        if (nest_dom[p][dir][0] == 0 && !L->phys[dir][0]) need = 1;
+        if (nest_dom[p][dir][1] == N[dir]-1 && !L->phys[dir][1]) need = 1;
+      }
+      for (dir = 0; dir < 3; dir++){
+        b   = nest_dom[p][dir][0];
+        e   = nest_dom[p][dir][1];
+        ngh = grid[dir].nghost;
+
+      /* -- owned parent zones (+ ghost zones at the global edge) -- */
+
+        SetRange (nest_src, p, dir, (b == 0 ? b - ngh:b) - L->ib[dir] + L->rb[dir],
+                  (e == N[dir]-1 ? e + ngh:e) - L->ib[dir] + L->rb[dir],
+                  L->nb[dir]);
+
+      /* -- parent zones (+ stencil) under the fine zones of p -- */
+
+        if (need){
+          SetRange (nest_dst, p, dir, FLOOR2(b - ngh) + L->rb[dir] - 1,
+                    FLOOR2(e + ngh) + L->rb[dir] + 1, L->nb[dir]);
+        }else{
+          SetRange (nest_dst, p, dir, 0, -1, L->nb[dir]);
+        }
+      }
+    }
+    NestedBoxSum (buf[0][0][0], L->nb, NVAR, 
+                  L->nb[KDIR]*L->nb[JDIR]*L->nb[IDIR], 1);
+  }
+  #endif
+}
+
+/* ********************************************************************* */
+void Restrict (int l)
+/*!
+ * Replace the zones of level <tt> l-1 </tt> covered by level \c l
+ * with the volume average of the fine conservative variables.
+ *
+ *********************************************************************** */
+{
+  int    i, j, k, nv, dir, ok, n;
+  int    G[3], p[3], loc[3];
+  double vfrac = 1.0/(double)(1 << DIMENSIONS), *q;
+  NestedLevel *P = nest + l - 1, *L = nest + l;
+  Grid  *grid;
+  double ****Vc;
+
+  n = NVAR*L->hs[KDIR]*L->hs[JDIR]*L->hs[IDIR];
+  memset (nest_rbuf, 0, n*sizeof(double));
+  for (dir = 0; dir < 3; dir++) G[dir] = p[dir] = 0;
+
+/* -- 1. sum fine zones -- */
+
+  grid = L->gp;
+  Vc   = L->dp->Vc;
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    IDOM_LOOP(i) VAR_LOOP(nv) nest_v[i][nv] = Vc[nv][k][j][i];
+    PrimToCons (nest_v, nest_u, IBEG, IEND);
+    IDOM_LOOP(i){
+      D_EXPAND(p[IDIR] = GLOB_INDEX(i, grid + IDIR)/2;  ,
+               p[JDIR] = GLOB_INDEX(j, grid + JDIR)/2;  ,
+               p[KDIR] = GLOB_INDEX(k, grid + KDIR)/2;)
+      q = nest_rbuf + ((p[KDIR]*L->hs[JDIR] + p[JDIR])*L->hs[IDIR] + p[IDIR])*NVAR;
+      VAR_LOOP(nv) q[nv] += vfrac*nest_u[i][nv];
+    }
+  }
+
+  #ifdef PARALLEL
+  {
+    int p;
+
+    for (p = 0; p < nest_nproc; p++){
+    for (dir = 0; dir < 3; dir++){
+      SetRange (nest_src, p, dir, nest_dom[p][dir][0]/2, 
+                nest_dom[p][dir][1]/2, L->hs[dir]);
+      SetRange (nest_dst, p, dir, nest_dom[p][dir][0] - L->ib[dir],
+                nest_dom[p][dir][1] - L->ib[dir], L->hs[dir]);
+    }}
+    NestedBoxSum (nest_rbuf, L->hs, NVAR, 1, NVAR);
+  }
+  #endif
+
+/* -- 2. replace parent zones -- */
+
+  grid = P->gp;
+  Vc   = P->dp->Vc;
+  DOM_LOOP(k,j,i){
+    loc[IDIR] = i; loc[JDIR] = j; loc[KDIR] = k;
+    ok = 1;
+    for (dir = 0; dir < DIMENSIONS && ok; dir++){
+      G[dir] = GLOB_INDEX(loc[dir], grid + dir);
+      p[dir] = G[dir] - L->ib[dir];
+      if (p[dir] < 0 || p[dir] >= L->hs[dir]) ok = 0;
+    }
+    if (!ok) continue;
+    q = nest_rbuf + ((p[KDIR]*L->hs[JDIR] + p[JDIR])*L->hs[IDIR] + p[IDIR])*NVAR;
+    VAR_LOOP(nv) nest_u[0][nv] = q[nv];
+    nest_flag[0] = 0;
+    ConsToPrim (nest_u, nest_v, 0, 0, nest_flag);
+    VAR_LOOP(nv) Vc[nv][k][j][i] = nest_v[0][nv];
+  }
+}
+
+/* ********************************************************************* */
+void Nested_StoreFlux (const State_1D *state, int beg, int end,
+                       int i, int j, int k, Grid *grid)
+/*!
+ * Accumulate fluxes through coarse-fine interfaces into the flux
+ * registers.
+ * Called from UpdatePencil() after RightHandSide() for the pencil
+ * (or segment) <tt> [beg,end] </tt> in the direction ::g_dir.
+ * Each interface is counted once, by the processor owning the
+ * zone on its left (or the leftmost ghost zone at the global edge).
+ *
+ * \param [in] state  pointer to a State_1D structure
+ * \param [in] beg    initial index of the pencil
+ * \param [in] end    final index of the pencil
+ * \param [in] i,j,k  pencil transverse indices (the one along
+ *                    ::g_dir is ignored)
+ * \param [in] grid   pointer to the current level Grid structures
+ *********************************************************************** */
+{
+  int    l, nv, s, dir = g_dir, d1, d2, f, gf;
+  int    loc[3], G1, G2, c1, c2;
+  double w, *reg;
+  NestedLevel *L, *C;
+  Grid  *Gn = grid + g_dir;
+  #if TIME_STEPPING == EULER
+   double wstage[3] = {1.0, 0.0, 0.0};  /* -- stage weights -- */
+  #elif TIME_STEPPING == RK2
+   double wstage[3] = {0.5, 0.5, 0.0};
+  #else
+   double wstage[3] = {1.0/6.0, 1.0/6.0, 2.0/3.0};
+  #endif
+
+  for (l = 0; l <= nest_nlev; l++) if (grid == nest[l].gp) break;
+  if (l > nest_nlev) return;
+  L = nest + l;
+
+  loc[IDIR] = i; loc[JDIR] = j; loc[KDIR] = k;
+  d1 = (dir == IDIR ? JDIR:IDIR);
+  d2 = (dir == KDIR ? JDIR:KDIR);
+  if (loc[d1] < grid[d1].lbeg || loc[d1] > grid[d1].lend) return;
+  if (loc[d2] < grid[d2].lbeg || loc[d2] > grid[d2].lend) return;
+  G1 = GLOB_INDEX(loc[d1], grid + d1);
+  G2 = GLOB_INDEX(loc[d2], grid + d2);
+
+  #define FACE_OWNED(f)  (   (f) >= beg - 1 && (f) <= end             \
+                          && ((f) >= beg || beg <= Gn->lbeg)          \
+                          && (   ((f) >= Gn->lbeg && (f) <= Gn->lend) \
+                              || ((f) == Gn->lbeg - 1 && Gn->beg == Gn->gbeg)))
+
+  #if NESTED_ADD_PRESSURE == YES
+   #define ADD_FLUX(r, f, w) \
+     NVAR_LOOP(nv) (r)[nv] += (w)*state->flux[f][nv]; \
+     (r)[MXn] += (w)*state->press[f];
+  #else
+   #define ADD_FLUX(r, f, w) \
+     NVAR_LOOP(nv) (r)[nv] += (w)*state->flux[f][nv];
+  #endif
+
+/* --------------------------------------------------------
+    1. Coarse side: faces of the child box
+   -------------------------------------------------------- */
+
+  if (l < nest_nlev){
+    C  = nest + l + 1;
+    c1 = G1 - C->ib[d1];
+    c2 = G2 - C->ib[d2];
+    if (c1 >= 0 && c1 < C->hs[d1] && c2 >= 0 && c2 < C->hs[d2]){
+      w = wstage[g_intStage - 1];
+      for (s = 0; s < 2; s++){
+        if (C->phys[dir][s]) continue;
+        gf = (s == 0 ? C->ib[dir] - 1:C->ie[dir]);
+        f  = gf + Gn->gbeg - Gn->beg + Gn->lbeg;
+        if (!FACE_OWNED(f)) continue;
+        reg = C->freg[dir][s][0] + (c2*C->hs[d1] + c1)*NVAR;
+        ADD_FLUX(reg, f, w);
+      }
+    }
+  }
+
+/* --------------------------------------------------------
+    2. Fine side: boundary faces of this level, averaged
+       over two time steps and 2^(DIMENSIONS-1) faces.
+   -------------------------------------------------------- */
+
+  if (l > 0){
+    c1 = G1/2;
+    c2 = G2/2;
+    w  = 0.5*wstage[g_intStage - 1]/(double)(1 << (DIMENSIONS - 1));
+    for (s = 0; s < 2; s++){
+      if (L->phys[dir][s]) continue;
+      gf = (s == 0 ? -1:Gn->np_int_glob - 1);
+      f  = gf + Gn->gbeg - Gn->beg + Gn->lbeg;
+      if (!FACE_OWNED(f)) continue;
+      reg = L->freg[dir][s][1] + (c2*L->hs[d1] + c1)*NVAR;
+      ADD_FLUX(reg, f, w);
+    }
+  }
+  #undef FACE_OWNED
+  #undef ADD_FLUX
+}
+
+/* ********************************************************************* */
+void Reflux (int l)
+/*!
+ * Correct the zones of level <tt> l-1 </tt> adjacent to the box of
+ * level \c l by replacing the coarse interface flux with the
+ * accumulated fine one.
+ *
+ *********************************************************************** */
+{
+  int    i, j, k, nv, dir, s, d1, d2, c1, c2, n;
+  int    loc[3];
+  double sgn, dtdx, *fc, *ff;
+  NestedLevel *P = nest + l - 1, *L = nest + l;
+  Grid  *grid = P->gp;
+  double ****Vc = P->dp->Vc;
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    d1 = (dir == IDIR ? JDIR:IDIR);
+    d2 = (dir == KDIR ? JDIR:KDIR);
+    for (s = 0; s < 2; s++){
+      if (L->phys[dir][s]) continue;
+
+      #ifdef PARALLEL
+      {
+        int p, gc, gr, owner, n3[3];
+        int ***dom = nest_dom;
+
+        n3[0] = L->hs[d1]; n3[1] = L->hs[d2]; n3[2] = 1;
+        gc = (s == 0 ? L->ib[dir] - 1:L->ie[dir]);      /* coarse face  */
+        gr = (s == 0 ? L->ib[dir] - 1:L->ie[dir] + 1);  /* refluxed zone */
+
+      /* -- coarse register: owners of the coarse face -- */
+
+        for (p = 0; p < nest_nproc; p++){
+          owner = (dom[p][dir][0] <= gc && gc <= dom[p][dir][1]);
+          SetRange (nest_src, p, 0, dom[p][d1][0] - L->ib[d1],
+                    (owner ? dom[p][d1][1] - L->ib[d1]:-1), n3[0]);
+          SetRange (nest_src, p, 1, dom[p][d2][0] - L->ib[d2],
+                    dom[p][d2][1] - L->ib[d2], n3[1]);
+          SetRange (nest_src, p, 2, 0, 0, 1);
+
+          owner = (dom[p][dir][0] <= gr && gr <= dom[p][dir][1]);
+          SetRange (nest_dst, p, 0, dom[p][d1][0] - L->ib[d1],
+                    (owner ? dom[p][d1][1] - L->ib[d1]:-1), n3[0]);
+          SetRange (nest_dst, p, 1, dom[p][d2][0] - L->ib[d2],
+                    dom[p][d2][1] - L->ib[d2], n3[1]);
+          SetRange (nest_dst, p, 2, 0, 0, 1);
+        }
+        NestedBoxSum (L->freg[dir][s][0], n3, NVAR, 1, NVAR);
+
+      /* -- fine register: owners of the fine boundary face -- */
+
+        for (p = 0; p < nest_nproc; p++){
+          owner = (s == 0 ? dom[p][dir][0] == 0
+                          : dom[p][dir][1] == grid[dir].np_int_glob - 1);
+          SetRange (nest_src, p, 0, dom[p][d1][0]/2,
+                    (owner ? dom[p][d1][1]/2:-1), n3[0]);
+          SetRange (nest_src, p, 1, dom[p][d2][0]/2, dom[p][d2][1]/2, n3[1]);
+          SetRange (nest_src, p, 2, 0, 0, 1);
+        }
+        NestedBoxSum (L->freg[dir][s][1], n3, NVAR, 1, NVAR);
+      }
+      #endif
+
+      sgn = (s == 0 ? -1.0:1.0);
+      loc[dir] = (s == 0 ? L->ib[dir] - 1:L->ie[dir] + 1)
+                 + grid[dir].gbeg - grid[dir].beg + grid[dir].lbeg;
+      if (loc[dir] < grid[dir].lbeg || loc[dir] > grid[dir].lend) continue;
+
+      for (c2 = 0; c2 < L->hs[d2]; c2++){
+      for (c1 = 0; c1 < L->hs[d1]; c1++){
+        loc[d1] = c1 + L->ib[d1] + grid[d1].gbeg - grid[d1].beg + grid[d1].lbeg;
+        loc[d2] = c2 + L->ib[d2] + grid[d2].gbeg - grid[d2].beg + grid[d2].lbeg;
+        if (loc[d1] < grid[d1].lbeg || loc[d1] > grid[d1].lend) continue;
+        if (loc[d2] < grid[d2].lbeg || loc[d2] > grid[d2].lend) continue;
+        i = loc[IDIR]; j = loc[JDIR]; k = loc[KDIR];
+
+        n    = (c2*L->hs[d1] + c1)*NVAR;
+        fc   = L->freg[dir][s][0] + n;
+        ff   = L->freg[dir][s][1] + n;
+        dtdx = sgn*L->dt0/grid[dir].dx[loc[dir]];
+
+        VAR_LOOP(nv) nest_v[0][nv] = Vc[nv][k][j][i];
+        PrimToCons (nest_v, nest_u, 0, 0);
+        NVAR_LOOP(nv) nest_u[0][nv] += dtdx*(ff[nv] - fc[nv]);
+        nest_flag[0] = 0;
+        ConsToPrim (nest_u, nest_v, 0, 0, nest_flag);
+        VAR_LOOP(nv) Vc[nv][k][j][i] = nest_v[0][nv];
+      }}
+    }
+  }
+}
+
+/* ********************************************************************* */
+void NestedBoxSum (double *q, int *n, int nc, int sc, int sv)
+/*!
+ * Sum across processors the contributions to a buffer defined on a
+ * box of <tt> n[0] x n[1] x n[2] </tt> zones with \c nc components
+ * per zone.
+ * Component \c c of zone <tt> (i,j,k) </tt> is stored in
+ * <tt> q[c*sc + ((k*n[1] + j)*n[0] + i)*sv] </tt>.
+ * Processor \c p holds its contribution in the region
+ * <tt> nest_src[p] </tt> and obtains the sum over all processors in
+ * the region <tt> nest_dst[p] </tt> (inclusive box indices, empty
+ * when lower > upper).
+ * Only overlapping portions are exchanged, with point-to-point
+ * messages.
+ *
+ *********************************************************************** */
+{
+  #ifdef PARALLEL
+   int    p, dir, i, j, k, c, m, nz, nreq, ns, nr;
+   int    lo[3], hi[3];
+   int    ***src = nest_src, ***dst = nest_dst;
+   double *qz;
+   static double *sbuf, *rbuf;
+   static int smax = 0, rmax = 0;
+   static MPI_Request *req;
+   static MPI_Status  *stat;
+
+   #define OVERLAP(a, b) \
+     (Overlap3D(a, b, lo, hi, &nz), nz)
+
+   if (req == NULL){
+     req  = (MPI_Request *) malloc(2*nest_nproc*sizeof(MPI_Request));
+     stat = (MPI_Status *)  malloc(2*nest_nproc*sizeof(MPI_Status));
+   }
+
+/* -- 1. buffer sizes -- */
+
+   ns = nr = 0;
+   for (p = 0; p < nest_nproc; p++){
+     if (p == prank) continue;
+     ns += nc*OVERLAP(src[prank], dst[p]);
+     nr += nc*OVERLAP(src[p], dst[prank]);
+   }
+   if (ns > smax){
+     if (sbuf != NULL) FreeArray1D ((void *) sbuf);
+     smax = ns;
+     sbuf = ARRAY_1D(smax, double);
+   }
+   if (nr > rmax){
+     if (rbuf != NULL) FreeArray1D ((void *) rbuf);
+     rmax = nr;
+     rbuf = ARRAY_1D(rmax, double);
+   }
+
+/* -- 2. post receives and send own contributions -- */
+
+   nreq = ns = nr = 0;
+   for (p = 0; p < nest_nproc; p++){
+     if (p == prank) continue;
+     if (OVERLAP(src[p], dst[prank]) > 0){
+       MPI_Irecv (rbuf + nr, nc*nz, MPI_DOUBLE, p, 0, MPI_COMM_WORLD,
+                  req + nreq);
+       nr += nc*nz;
+       nreq++;
+     }
+   }
+   for (p = 0; p < nest_nproc; p++){
+     if (p == prank) continue;
+     if (OVERLAP(src[prank], dst[p]) > 0){
+       m = ns;
+       for (k = lo[2]; k <= hi[2]; k++){
+       for (j = lo[1]; j <= hi[1]; j++){
+       for (i = lo[0]; i <= hi[0]; i++){
+         qz = q + ((k*n[1] + j)*n[0] + i)*sv;
+         for (c = 0; c < nc; c++) sbuf[m++] = qz[c*sc];
+       }}}
+       MPI_Isend (sbuf + ns, nc*nz, MPI_DOUBLE, p, 0, MPI_COMM_WORLD,
+                  req + nreq);
+       ns += nc*nz;
+       nreq++;
+     }
+   }
+   MPI_Waitall (nreq, req, stat);
+
+/* -- 3. add the contributions of the other processors -- */
+
+   m = 0;
+   for (p = 0; p < nest_nproc; p++){
+     if (p == prank) continue;
+     if (OVERLAP(src[p], dst[prank]) > 0){
+       for (k = lo[2]; k <= hi[2]; k++){
+       for (j = lo[1]; j <= hi[1]; j++){
+       for (i = lo[0]; i <= hi[0]; i++){
+         qz = q + ((k*n[1] + j)*n[0] + i)*sv;
+         for (c = 0; c < nc; c++) qz[c*sc] += rbuf[m++];
+       }}}
+     }
+   }
+   #undef OVERLAP
+  #endif
+}
+
+#ifdef PARALLEL
+/* ********************************************************************* */
+void Overlap3D (int **a, int **b, int *lo, int *hi, int *nz)
+/*!
+ * Compute the intersection <tt> [lo,hi] </tt> of the regions \c a
+ * and \c b and its number of zones \c nz (0 if empty).
+ *
+ *********************************************************************** */
+{
+  int dir;
+
+  *nz = 1;
+  for (dir = 0; dir < 3; dir++){
+    lo[dir] = MAX(a[dir][0], b[dir][0]);
+    hi[dir] = MIN(a[dir][1], b[dir][1]);
+    *nz *= MAX(hi[dir] - lo[dir] + 1, 0);
+  }
+}
+
+/* ********************************************************************* */
+void SetRange (int ***r, int p, int dir, int lo, int hi, int n)
+/*!
+ * Set the index range of processor \c p in direction \c dir of the
+ * region \c r to <tt> [lo,hi] </tt>, clipped to <tt> [0,n-1] </tt>.
+ *
+ *********************************************************************** */
+{
+  r[p][dir][0] = MAX(lo, 0);
+  r[p][dir][1] = MIN(hi, n - 1);
+}
+#endif
+
+/* ********************************************************************* */
+Data *Nested_Data (int l)
+/*!
+ * Return a pointer to the Data structure of level \c l.
+ *
+ *********************************************************************** */
+{
+  return nest[l].dp;
+}
+
+/* ********************************************************************* */
+Grid *Nested_Grid (int l)
+/*!
+ * Return a pointer to the array of Grid structures of level \c l.
+ *
+ *********************************************************************** */
+{
+  return nest[l].gp;
+}
+
+#undef GLOB_INDEX
+#undef FLOOR2
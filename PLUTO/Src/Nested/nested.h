@@ -0,0 +1,77 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Nested static grids module header file.
+
+  Static mesh refinement on the static-grid (non-Chombo) code.
+  Each refinement level is a fixed box covering half of its parent
+  level in every direction and discretized with the same number of
+  zones (i.e. refinement ratio 2), so that every level shares the
+  array sizes, the domain decomposition and the static storage of the
+  base grid.
+  Levels are advanced recursively with subcycling in time (two steps
+  per parent step) by calling Integrate() on each level: 
+  - ghost zones at coarse-fine boundaries are filled by linear
+    interpolation (in time and space, minmod-limited) of the parent
+    primitive variables during Boundary();
+  - after the fine steps, the parent solution underneath the box is
+    replaced by the volume average of the fine conservative variables 
+    and the parent zones adjacent to the box are corrected 
+    (refluxing) with the time- and area-averaged fine fluxes captured 
+    in UpdateStage().
+
+  The module is enabled by setting \c NESTED_LEVELS (number of refined
+  levels) in the user-defined constants section of definitions.h.
+  Each box is centered, as close as allowed by the parent grid, on the
+  point given in pluto.ini by
+  \code
+    nested_center  <x1c>  <x2c>  <x3c>
+  \endcode
+  (default: center of the computational domain).
+  Cell-centered data for each level are written to 
+  <tt> nest<l>.nnnn.dbl </tt> together with each .dbl output, while
+  \c data.nnnn.dbl holds the (restricted) base level.
+
+  Restrictions: Cartesian, uniform grids, Runge-Kutta time stepping,
+  cell-centered magnetic field (no CT), no FARGO nor shearing box; 
+  boxes cannot touch periodic boundaries. 
+  Operator-split terms (STS, RKC) are not refluxed.
+  On restart, each refined level is read back from its 
+  <tt> nest<l>.nnnn.dbl </tt> file; levels without a file (e.g. 
+  when restarting from HDF5 output) are re-initialized by 
+  interpolation from their parent.
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+
+#ifdef CH_SPACEDIM
+ #error Nested grids cannot be used with Chombo AMR
+#endif
+
+#if GEOMETRY != CARTESIAN
+ #error Nested grids require CARTESIAN geometry
+#endif
+
+#if (TIME_STEPPING != EULER) && (TIME_STEPPING != RK2) && (TIME_STEPPING != RK3)
+ #error Nested grids require Runge-Kutta time stepping
+#endif
+
+#if (defined STAGGERED_MHD) || (defined FARGO) || (defined SHEARINGBOX)
+ #error Nested grids are not compatible with CT, FARGO or the shearing box
+#endif
+
+#define NESTED_MAX_LEVELS   8
+
+/* ---- Function prototypes ---- */
+
+void Nested_Init (Data *, Runtime *, Grid *);
+void Nested_Restart (Output *, int);
+int  Nested_Integrate (Data *, Riemann_Solver *, Time_Step *, Grid *,
+                       int (*)(Data *, Riemann_Solver *, Time_Step *, Grid *));
+void Nested_Boundary (const Data *, Grid *);
+void Nested_StoreFlux (const State_1D *, int, int, int, int, int, Grid *);
+void Nested_WriteData (Output *);
+int  Nested_ReadData (Output *, int, int);
+Data *Nested_Data (int);
+Grid *Nested_Grid (int);
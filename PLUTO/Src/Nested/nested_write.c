@@ -0,0 +1,87 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Write and read data of the refined levels.
+
+  For each .dbl output, the primitive variables of level \c l are
+  written (all ::NVAR variables, in the same order and single-file
+  layout as \c data.nnnn.dbl) to <tt> nest<l>.nnnn.dbl </tt>.
+  The coordinates of each level are found in <tt> nest<l>_grid.out
+  </tt>, written at initialization.
+  The same files are read back on restart (Nested_ReadData()).
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+/* ********************************************************************* */
+void Nested_WriteData (Output *output)
+/*!
+ * Write cell-centered primitive variables of every refined level.
+ *
+ * \param [in] output  pointer to the (.dbl) Output structure being
+ *                     written
+ *********************************************************************** */
+{
+  int   l, nv;
+  char  filename[512];
+  void  *Vpt;
+  FILE  *fbin;
+  Data  *d;
+
+  for (l = 1; l <= NESTED_LEVELS; l++){
+    d = Nested_Data (l);
+    sprintf (filename, "%s/nest%d.%04d.%s", output->dir, l,
+                                            output->nfile, output->ext);
+    fbin = OpenBinaryFile (filename, SZ, "w");
+    for (nv = 0; nv < NVAR; nv++) {
+      Vpt = (void *)d->Vc[nv][0][0];
+      WriteBinaryArray (Vpt, sizeof(double), SZ, fbin, -1);
+    }
+    CloseBinaryFile (fbin, SZ);
+  }
+}
+
+/* ********************************************************************* */
+int Nested_ReadData (Output *output, int l, int swap_endian)
+/*!
+ * Read the cell-centered primitive variables of level \c l from the
+ * <tt> nest<l>.nnnn.dbl </tt> file with the same number as the
+ * (.dbl) output being restarted from.
+ *
+ * \param [in] output       pointer to the (.dbl) Output structure
+ * \param [in] l            the level number
+ * \param [in] swap_endian  a flag for swapping endianity
+ *
+ * \return 1 if the file was read, 0 if it does not exist.
+ *********************************************************************** */
+{
+  int   nv, found = 0;
+  char  filename[512];
+  void  *Vpt;
+  FILE  *fbin;
+  Data  *d = Nested_Data (l);
+
+  sprintf (filename, "%s/nest%d.%04d.%s", output->dir, l,
+                                          output->nfile, output->ext);
+  if (prank == 0){
+    fbin = fopen (filename, "rb");
+    if (fbin != NULL){
+      found = 1;
+      fclose (fbin);
+    }
+  }
+  #ifdef PARALLEL
+   MPI_Bcast (&found, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  #endif
+  if (!found) return 0;
+
+  fbin = OpenBinaryFile (filename, SZ, "r");
+  for (nv = 0; nv < NVAR; nv++) {
+    Vpt = (void *)d->Vc[nv][0][0];
+    ReadBinaryArray (Vpt, sizeof(double), SZ, fbin, -1, swap_endian);
+  }
+  CloseBinaryFile (fbin, SZ);
+  return 1;
+}
@@ -0,0 +1,211 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Fill the ghost boundaries of several arrays at once.
+
+  Same as AL_Exchange_dim() but for a list of arrays sharing the
+  same domain decomposition (e.g. the cell-centered and the staggered
+  components of the solution).
+  Along each dimension, the ghost zones of all the arrays are packed
+  into a single contiguous buffer per neighbour, so that only one
+  message is sent to (and received from) each neighbour instead of
+  one per array.
+  Buffers and persistent communication requests are created on the
+  first call and re-used as long as the same list of descriptors
+  is given.
+  They are released by AL_Free_exchange_list_() when the list changes,
+  when a descriptor is freed and in AL_Finalize().
+
+  \date Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "al_hidden.h"  /*I "al_hidden.h" I*/
+
+extern SZ *sz_stack[AL_MAX_ARRAYS];
+extern int stack_ptr[AL_MAX_ARRAYS];
+
+#define AL_MAX_LIST  64
+
+static int AL_Pack_ (char *, SZ *, int, int, char *, int);
+
+/* -- cached list of descriptors, buffers and persistent requests -- */
+
+static int nlist = 0, list[AL_MAX_LIST], ndim_list = 0;
+static long int size[AL_MAX_DIM][2];
+static char *sendbuf[AL_MAX_DIM][2], *recvbuf[AL_MAX_DIM][2];
+static MPI_Request req[AL_MAX_DIM][4];
+
+/* ********************************************************************* */
+int AL_Exchange_dim_list (char **bufs, int *sz_ptrs, int nbuf, int *dims)
+/*!
+ * Fill the ghost boundaries of a list of arrays along selected
+ * dimensions.
+ *
+ * \param [in]  bufs     array of \c nbuf pointers to buffers
+ * \param [in]  sz_ptrs  array of \c nbuf integer pointers to the
+ *                       distributed array descriptors
+ * \param [in]  nbuf     number of arrays
+ * \param [in]  dims     if dims[i]=0, do not perform the exchange in
+ *                       this dimension (array if int)
+ *********************************************************************** */
+{
+  int nb, nd, n, ndim, lr, nbytes;
+  int nrl, nlr;
+  MPI_Status status[4];
+  SZ *s, *s0;
+
+  if (nbuf > AL_MAX_LIST){
+    printf ("AL_Exchange_dim_list: too many arrays (%d)\n", nbuf);
+    return (int) AL_FAILURE;
+  }
+
+  for (nb = 0; nb < nbuf; nb++){
+    if (stack_ptr[sz_ptrs[nb]] == AL_STACK_FREE){
+      printf ("AL_Exchange_dim_list: wrong SZ pointer\n");
+    }
+  }
+
+  s0   = sz_stack[sz_ptrs[0]];
+  ndim = s0->ndim;
+
+/* --------------------------------------------------------
+    1. (Re)build buffers and persistent requests if the
+       list of descriptors has changed.
+       Message [0] goes right->left, message [1] left->right.
+   -------------------------------------------------------- */
+
+  n = 0;
+  if (nlist == nbuf){
+    for (n = 0; n < nbuf; n++) if (list[n] != sz_ptrs[n]) break;
+  }
+
+  if (n < nbuf){
+    AL_Free_exchange_list_();
+
+    for (nd = 0; nd < ndim; nd++){
+      size[nd][0] = size[nd][1] = 0;
+      if (s0->bg[nd] == 0) continue;
+      for (nb = 0; nb < nbuf; nb++){
+        s = sz_stack[sz_ptrs[nb]];
+        nrl = nlr = s->type_size;
+        for (n = 0; n < ndim; n++){
+          if (n == nd){
+            nrl *= s->bg[nd];
+            nlr *= s->bg[nd] + (s->isstaggered[nd] == AL_TRUE);
+          }else{
+            nrl *= s->larrdim_gp[n];
+            nlr *= s->larrdim_gp[n];
+          }
+        }
+        size[nd][0] += nrl;
+        size[nd][1] += nlr;
+      }
+      for (lr = 0; lr < 2; lr++){
+        sendbuf[nd][lr] = (char *) AL_ALLOC_(size[nd][lr], sizeof(char));
+        recvbuf[nd][lr] = (char *) AL_ALLOC_(size[nd][lr], sizeof(char));
+      }
+
+      MPI_Recv_init (recvbuf[nd][0], size[nd][0], MPI_BYTE, s0->right[nd],
+                     s0->tag1[nd], s0->comm, &req[nd][0]);
+      MPI_Recv_init (recvbuf[nd][1], size[nd][1], MPI_BYTE, s0->left[nd],
+                     s0->tag2[nd], s0->comm, &req[nd][1]);
+      MPI_Send_init (sendbuf[nd][0], size[nd][0], MPI_BYTE, s0->left[nd],
+                     s0->tag1[nd], s0->comm, &req[nd][2]);
+      MPI_Send_init (sendbuf[nd][1], size[nd][1], MPI_BYTE, s0->right[nd],
+                     s0->tag2[nd], s0->comm, &req[nd][3]);
+    }
+    for (n = 0; n < nbuf; n++) list[n] = sz_ptrs[n];
+    nlist     = nbuf;
+    ndim_list = ndim;
+  }
+
+/* --------------------------------------------------------
+    2. Exchange one dimension at a time, so that corner
+       ghost zones are filled as well.
+   -------------------------------------------------------- */
+
+  for (nd = 0; nd < ndim; nd++){
+    if (size[nd][0] == 0 || dims[nd] == 0) continue;
+
+    for (lr = 0; lr < 2; lr++){
+      for (nb = nbytes = 0; nb < nbuf; nb++){
+        s = sz_stack[sz_ptrs[nb]];
+        n = (lr == 0 ? s->sendb1[nd]:s->sendb2[nd]);
+        nbytes += AL_Pack_(bufs[nb] + n, s, nd, lr, sendbuf[nd][lr] + nbytes, 0);
+      }
+    }
+
+    MPI_Startall (4, req[nd]);
+    MPI_Waitall  (4, req[nd], status);
+
+    for (lr = 0; lr < 2; lr++){
+      if ((lr == 0 ? s0->right[nd]:s0->left[nd]) == MPI_PROC_NULL) continue;
+      for (nb = nbytes = 0; nb < nbuf; nb++){
+        s = sz_stack[sz_ptrs[nb]];
+        n = (lr == 0 ? s->recvb1[nd]:s->recvb2[nd]);
+        nbytes += AL_Pack_(bufs[nb] + n, s, nd, lr, recvbuf[nd][lr] + nbytes, 1);
+      }
+    }
+  }
+
+  return (int) AL_SUCCESS;
+}
+
+/* ********************************************************************* */
+int AL_Free_exchange_list_()
+/*!
+ * Free the persistent requests and the buffers created by
+ * AL_Exchange_dim_list() for the cached list of descriptors.
+ * The next call to AL_Exchange_dim_list() builds them again.
+ *********************************************************************** */
+{
+  int nd, n, lr;
+
+  for (nd = 0; nd < ndim_list; nd++){
+    if (size[nd][0] == 0) continue;
+    for (n = 0; n < 4; n++) MPI_Request_free (&req[nd][n]);
+    for (lr = 0; lr < 2; lr++){
+      AL_FREE_(sendbuf[nd][lr]);
+      AL_FREE_(recvbuf[nd][lr]);
+    }
+    size[nd][0] = size[nd][1] = 0;
+  }
+  nlist = ndim_list = 0;
+  return (int) AL_SUCCESS;
+}
+
+/* ********************************************************************* */
+int AL_Pack_ (char *a, SZ *s, int nd, int lr, char *buf, int unpack)
+/*!
+ * Copy the ghost slab of the array \c a (starting at the first
+ * element of the slab) along dimension \c nd to (unpack = 0) or
+ * from (unpack = 1) the contiguous buffer \c buf.
+ * The slab is made of \c count blocks of \c blocklen contiguous
+ * elements separated by \c stride elements, as for the strided
+ * data types built in AL_Decompose().
+ *
+ * \return the number of bytes copied.
+ *********************************************************************** */
+{
+  int  n, nb, count, blocklen, stride;
+
+  count    = 1;
+  blocklen = s->bg[nd];
+  if (lr == 1 && s->isstaggered[nd] == AL_TRUE) blocklen++;
+  stride = s->larrdim_gp[nd];
+  for (nb = 0; nb < nd; nb++){
+    blocklen *= s->larrdim_gp[nb];
+    stride   *= s->larrdim_gp[nb];
+  }
+  for (nb = nd + 1; nb < s->ndim; nb++) count *= s->larrdim_gp[nb];
+
+  blocklen *= s->type_size;
+  stride   *= s->type_size;
+
+  if (unpack){
+    for (n = 0; n < count; n++) memcpy (a + n*stride, buf + n*blocklen, blocklen);
+  }else{
+    for (n = 0; n < count; n++) memcpy (buf + n*blocklen, a + n*stride, blocklen);
+  }
+  return count*blocklen;
+}
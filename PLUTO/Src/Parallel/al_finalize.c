@@ -23,6 +23,9 @@ int AL_Finalize()
   MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
 
+  /* Release the persistent requests of AL_Exchange_dim_list() */
+  AL_Free_exchange_list_();
+
   /* Synchronize just in case */
   MPI_Barrier(MPI_COMM_WORLD);
 
@@ -67,6 +67,7 @@ extern int AL_Type_create_subarray(int, int *, int *, int *, int, MPI_Datatype,
 extern void *AL_Allocate_array(int);
 extern int AL_Exchange( void *, int);
 extern int AL_Exchange_dim(char *, int *, int);
+extern int AL_Exchange_dim_list (char **, int *, int, int *);
 extern int AL_Exchange_periods (void *vbuf, int *periods, int sz_ptr);
 
 extern int AL_File_open(char *, int);
@@ -92,6 +93,7 @@ extern int AL_Allocate_sz_();
 extern int AL_Deallocate_sz_(int);
 extern int AL_Auto_Decomp_(int, int, int *, int *);
 extern int AL_Sort_(int, int *, int *);
+extern int AL_Free_exchange_list_();
 
 #ifdef __cplusplus
 }
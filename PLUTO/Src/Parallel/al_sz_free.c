@@ -27,6 +27,11 @@ int AL_Sz_free(int sz_ptr)
  * \param [in] sz_ptr Integer pointer to the array descriptor
  *********************************************************************** */
 {
+  /*
+    The cached exchange list may refer to this descriptor
+  */
+  AL_Free_exchange_list_();
+
   /*
     Deallocate the SZ structure 
   */
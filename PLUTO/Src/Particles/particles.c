@@ -0,0 +1,485 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Initialize, advect and exchange Lagrangian tracer particles.
+
+  Particles are stored in a dynamically resized array local to each
+  processor.
+  At the beginning of the computation, \c N particles (read from the
+  \c particles line in pluto.ini) are uniformly seeded in the
+  computational domain and each processor retains only those lying
+  in its own sub-domain.
+  On restart, particles are read back from the particle output
+  instead (see Particles_Restart()).
+
+  After each integration step, particles are advanced with a second-order
+  predictor-corrector (Heun) scheme:
+  \f[
+    \vec{x}^* = \vec{x}^n + \Delta t\,\vec{u}^n(\vec{x}^n)\,,\qquad
+    \vec{x}^{n+1} = \vec{x}^n + \frac{\Delta t}{2}\left[
+                    \vec{u}^n(\vec{x}^n) + \vec{u}^{n+1}(\vec{x}^*)\right]
+  \f]
+  where \f$\vec{u}\f$ is the coordinate velocity obtained by multi-linear
+  interpolation of the cell-centered fluid velocity.
+  The velocity at the previous time level is the one stored in the
+  particle structure, so only the solution at \f$t^{n+1}\f$ is required.
+  Density, pressure and magnetic field are then sampled at the new
+  position and the shock history and electron spectrum are updated
+  (see particles_spectrum.c).
+
+  Particles leaving the local sub-domain are exchanged among processors,
+  while particles leaving the computational domain through a non-periodic
+  boundary are removed.
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+static Particle *p_arr;   /* Local array of particles */
+static int p_num;         /* Number of particles owned by this processor */
+static int p_max;         /* Allocated size of p_arr */
+static int p_periodic[3];
+
+static void   Particles_Interpolate (Data *, double *, double *, Grid *);
+static void   Particles_CoordSpeed  (double *, double *, double *);
+static int    Particles_InShock     (Data *, double *, Grid *);
+static void   Particles_Boundary    (Grid *);
+static int    LocateZone (double *, int, double);
+
+/* ********************************************************************* */
+void Particles_Init (Data *d, Runtime *ini, int restart, Grid *grid)
+/*!
+ * Seed particles uniformly in the computational domain and sample
+ * the initial fluid quantities at their positions.
+ *
+ * \param [in] d        pointer to the PLUTO Data structure
+ * \param [in] ini      pointer to the Runtime structure
+ * \param [in] restart  when set to 1, only the boundary conditions
+ *                      are initialized: particles are restored later
+ *                      by Particles_Restart().
+ * \param [in] grid     pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    n, nv, dir;
+  double x[3], q[NVAR];
+  Particle p;
+
+  for (dir = 0; dir < 3; dir++){
+    p_periodic[dir] = (ini->left_bound[dir] == PERIODIC) && (dir < DIMENSIONS);
+  }
+  if (ini->part_np <= 0 || restart) return;
+
+  print1 ("> Particles: seeding %d tracer particles\n",ini->part_np);
+
+/* --------------------------------------------------------
+    Use the same random sequence on all processors, so that
+    the particle id is unique across the whole domain.
+   -------------------------------------------------------- */
+
+  srand48(1234567);
+  for (n = 0; n < ini->part_np; n++){
+    for (dir = 0; dir < 3; dir++){
+      x[dir] = g_domBeg[dir] + drand48()*(g_domEnd[dir] - g_domBeg[dir]);
+      if (dir >= DIMENSIONS) x[dir] = grid[dir].x[0];
+    }
+    if (!Particles_IsLocal(x, grid)) continue;
+
+    memset (&p, 0, sizeof(Particle));
+    for (dir = 0; dir < 3; dir++) p.coord[dir] = x[dir];
+    Particles_Interpolate (d, p.coord, q, grid);
+    EXPAND(p.speed[IDIR] = q[VX1];  ,
+           p.speed[JDIR] = q[VX2];  ,
+           p.speed[KDIR] = q[VX3];)
+    p.rho = q[RHO];
+    #if HAVE_ENERGY
+     p.prs = q[PRS];
+    #elif EOS == ISOTHERMAL
+     p.prs = q[RHO]*g_isoSoundSpeed*g_isoSoundSpeed;
+    #endif
+    #if PHYSICS == MHD || PHYSICS == RMHD
+     EXPAND(p.B[IDIR] = q[BX1];  ,
+            p.B[JDIR] = q[BX2];  ,
+            p.B[KDIR] = q[BX3];)
+    #endif
+    p.tshock   = -1.0;
+    p.rho_pre  = p.rho;
+    p.comp     = 1.0;
+    p.id       = n;
+    Particles_Add (&p);
+  }
+}
+
+/* ********************************************************************* */
+void Particles_Update (Data *d, double dt, Grid *grid)
+/*!
+ * Advance particles by one time step and update their shock history
+ * and electron spectrum.
+ * This function must be called after the fluid has been advanced
+ * to \f$t^{n+1}\f$ and before the time is incremented.
+ *
+ * \param [in] d     pointer to the PLUTO Data structure
+ * \param [in] dt    the time step
+ * \param [in] grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    n, dir, shocked;
+  double x0[3], xs[3], u0[3], us[3], vs[3], q[NVAR];
+  double rho_old, t;
+  Particle *p;
+
+/* --------------------------------------------------------
+    Ghost zones must be consistent with the updated
+    solution in order to interpolate near processor
+    boundaries. They are filled at t^{n+1}, as the
+    next step would do.
+   -------------------------------------------------------- */
+
+  t       = g_time;
+  g_time += dt;
+  Boundary (d, ALL_DIR, grid);
+  g_time  = t;
+
+  for (n = 0; n < p_num; n++){
+    p = p_arr + n;
+
+  /* -- predictor: x* = x^n + dt*u^n -- */
+
+    for (dir = 0; dir < 3; dir++) x0[dir] = xs[dir] = p->coord[dir];
+    Particles_CoordSpeed (x0, p->speed, u0);
+    for (dir = 0; dir < DIMENSIONS; dir++) xs[dir] += dt*u0[dir];
+
+  /* -- corrector: x^{n+1} = x^n + dt/2*(u^n + u*) -- */
+
+    Particles_Interpolate (d, xs, q, grid);
+    vs[IDIR] = vs[JDIR] = vs[KDIR] = 0.0;
+    EXPAND(vs[IDIR] = q[VX1];  ,
+           vs[JDIR] = q[VX2];  ,
+           vs[KDIR] = q[VX3];)
+    Particles_CoordSpeed (xs, vs, us);
+    for (dir = 0; dir < DIMENSIONS; dir++) {
+      p->coord[dir] = x0[dir] + 0.5*dt*(u0[dir] + us[dir]);
+    }
+
+  /* -- sample fluid quantities at the new position -- */
+
+    Particles_Interpolate (d, p->coord, q, grid);
+    rho_old = p->rho;
+    EXPAND(p->speed[IDIR] = q[VX1];  ,
+           p->speed[JDIR] = q[VX2];  ,
+           p->speed[KDIR] = q[VX3];)
+    p->rho = q[RHO];
+    #if HAVE_ENERGY
+     p->prs = q[PRS];
+    #elif EOS == ISOTHERMAL
+     p->prs = q[RHO]*g_isoSoundSpeed*g_isoSoundSpeed;
+    #endif
+    #if PHYSICS == MHD || PHYSICS == RMHD
+     EXPAND(p->B[IDIR] = q[BX1];  ,
+            p->B[JDIR] = q[BX2];  ,
+            p->B[KDIR] = q[BX3];)
+    #endif
+
+  /* ----------------------------------------------------
+      Shock history: a shock crossing begins when the
+      particle enters a shocked zone and ends when it
+      leaves it. Electrons are injected at the end of the
+      crossing, when the compression ratio is known.
+     ---------------------------------------------------- */
+
+    shocked = Particles_InShock (d, p->coord, grid);
+    if (shocked && !p->in_shock){
+      p->nshocks++;
+      p->tshock  = g_time + dt;
+      p->rho_pre = rho_old;
+      p->comp    = 1.0;
+    }
+    if (shocked) p->comp = MAX(p->comp, p->rho/p->rho_pre);
+
+    Particles_Spectrum (p, rho_old, p->rho, dt);
+    if (p->in_shock && !shocked) Particles_Inject (p);
+    p->in_shock = shocked;
+  }
+
+  Particles_Boundary (grid);
+}
+
+/* ********************************************************************* */
+int Particles_Number (void)
+/*!
+ * Return the number of particles owned by the local processor.
+ *********************************************************************** */
+{
+  return p_num;
+}
+
+/* ********************************************************************* */
+Particle *Particles_Array (void)
+/*!
+ * Return a pointer to the local array of particles.
+ *********************************************************************** */
+{
+  return p_arr;
+}
+
+/* ********************************************************************* */
+void Particles_Add (Particle *p)
+/*!
+ * Append a particle to the local array, resizing it if necessary.
+ *********************************************************************** */
+{
+  if (p_num == p_max){
+    p_max = (p_max == 0 ? 1024:2*p_max);
+    p_arr = (Particle *) realloc (p_arr, p_max*sizeof(Particle));
+    if (p_arr == NULL){
+      print ("! Particles_Add: cannot allocate memory for %d particles\n",
+              p_max);
+      QUIT_PLUTO(1);
+    }
+  }
+  p_arr[p_num++] = *p;
+}
+
+/* ********************************************************************* */
+void Particles_Interpolate (Data *d, double *x, double *q, Grid *grid)
+/*!
+ * Compute the primitive variables at the particle position by
+ * multi-linear interpolation of cell-centered values.
+ * Positions falling outside the local grid (ghost zones included)
+ * are clamped to the nearest cell center.
+ *
+ * \param [in]  d     pointer to the PLUTO Data structure
+ * \param [in]  x     the particle coordinates
+ * \param [out] q     an array of primitive variables
+ * \param [in]  grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    nv, i, j, k, i1, j1, k1;
+  double wx[2], wy[2], wz[2], w, *xc;
+
+  i = j = k = 0;
+  i1 = j1 = k1 = 0;
+  wx[0] = wy[0] = wz[0] = 1.0;
+  wx[1] = wy[1] = wz[1] = 0.0;
+
+  D_EXPAND(
+    xc = grid[IDIR].x;
+    i  = LocateZone (xc, NX1_TOT, x[IDIR]);  i1 = i + 1;
+    wx[1] = (x[IDIR] - xc[i])/(xc[i1] - xc[i]);
+    wx[1] = MAX(0.0, MIN(1.0, wx[1]));
+    wx[0] = 1.0 - wx[1];                                   ,
+
+    xc = grid[JDIR].x;
+    j  = LocateZone (xc, NX2_TOT, x[JDIR]);  j1 = j + 1;
+    wy[1] = (x[JDIR] - xc[j])/(xc[j1] - xc[j]);
+    wy[1] = MAX(0.0, MIN(1.0, wy[1]));
+    wy[0] = 1.0 - wy[1];                                   ,
+
+    xc = grid[KDIR].x;
+    k  = LocateZone (xc, NX3_TOT, x[KDIR]);  k1 = k + 1;
+    wz[1] = (x[KDIR] - xc[k])/(xc[k1] - xc[k]);
+    wz[1] = MAX(0.0, MIN(1.0, wz[1]));
+    wz[0] = 1.0 - wz[1];
+  )
+
+  for (nv = 0; nv < NVAR; nv++){
+    w = wz[0]*(  wy[0]*(wx[0]*d->Vc[nv][k][j][i]  + wx[1]*d->Vc[nv][k][j][i1])
+               + wy[1]*(wx[0]*d->Vc[nv][k][j1][i] + wx[1]*d->Vc[nv][k][j1][i1]));
+    #if DIMENSIONS == 3
+     w += wz[1]*(  wy[0]*(wx[0]*d->Vc[nv][k1][j][i]  + wx[1]*d->Vc[nv][k1][j][i1])
+                 + wy[1]*(wx[0]*d->Vc[nv][k1][j1][i] + wx[1]*d->Vc[nv][k1][j1][i1]));
+    #endif
+    q[nv] = w;
+  }
+}
+
+/* ********************************************************************* */
+void Particles_CoordSpeed (double *x, double *v, double *u)
+/*!
+ * Convert the physical velocity \c v into the rate of change of the
+ * particle coordinates \c u.
+ *********************************************************************** */
+{
+  u[IDIR] = v[IDIR];
+  u[JDIR] = v[JDIR];
+  u[KDIR] = v[KDIR];
+
+  #if GEOMETRY == POLAR
+   u[JDIR] = v[JDIR]/x[IDIR];
+  #elif GEOMETRY == SPHERICAL
+   u[JDIR] = v[JDIR]/x[IDIR];
+   u[KDIR] = v[KDIR]/(x[IDIR]*sin(x[JDIR]));
+  #endif
+}
+
+/* ********************************************************************* */
+int Particles_InShock (Data *d, double *x, Grid *grid)
+/*!
+ * Return 1 if the zone hosting the particle lies in a shock, 0 otherwise.
+ * When FlagShock() is active during the step, its flags are used:
+ * ::FLAG_HLL tags shocked zones with MULTID shock flattening while,
+ * with the SELECTIVE entropy switch, shocked zones have ::FLAG_ENTROPY
+ * switched off.
+ * Otherwise, the same compression and pressure jump criteria are
+ * evaluated locally using the threshold \c PARTICLES_EPS_SHOCK.
+ *********************************************************************** */
+{
+  int i, j, k;
+
+  i = j = k = 0;
+  D_EXPAND(i = LocateZone (grid[IDIR].xr, NX1_TOT, x[IDIR]) + 1;  ,
+           j = LocateZone (grid[JDIR].xr, NX2_TOT, x[JDIR]) + 1;  ,
+           k = LocateZone (grid[KDIR].xr, NX3_TOT, x[KDIR]) + 1;)
+  D_EXPAND(i = MAX(i, IBEG); i = MIN(i, IEND);  ,
+           j = MAX(j, JBEG); j = MIN(j, JEND);  ,
+           k = MAX(k, KBEG); k = MIN(k, KEND);)
+
+#if SHOCK_FLATTENING == MULTID
+  return (d->flag[k][j][i] & FLAG_HLL) != 0;
+#elif ENTROPY_SWITCH == SELECTIVE
+  return (d->flag[k][j][i] & FLAG_ENTROPY) == 0;
+#else
+  {
+    double divv, dp, pmin, ***pt;
+
+  /* -- undivided velocity differences and pressure jump -- */
+
+    #if HAVE_ENERGY
+     pt = d->Vc[PRS];
+    #else
+     pt = d->Vc[RHO];
+    #endif
+    D_EXPAND(divv  = d->Vc[VX1][k][j][i+1] - d->Vc[VX1][k][j][i-1];  ,
+             divv += d->Vc[VX2][k][j+1][i] - d->Vc[VX2][k][j-1][i];  ,
+             divv += d->Vc[VX3][k+1][j][i] - d->Vc[VX3][k-1][j][i];)
+    if (divv >= 0.0) return 0;
+
+    pmin = pt[k][j][i];
+    D_EXPAND(dp  = fabs(pt[k][j][i+1] - pt[k][j][i-1]);
+             pmin = MIN(pmin, MIN(pt[k][j][i+1], pt[k][j][i-1]));  ,
+             dp += fabs(pt[k][j+1][i] - pt[k][j-1][i]);
+             pmin = MIN(pmin, MIN(pt[k][j+1][i], pt[k][j-1][i]));  ,
+             dp += fabs(pt[k+1][j][i] - pt[k-1][j][i]);
+             pmin = MIN(pmin, MIN(pt[k+1][j][i], pt[k-1][j][i]));)
+    return dp > PARTICLES_EPS_SHOCK*pmin;
+  }
+#endif
+}
+
+/* ********************************************************************* */
+int Particles_IsLocal (double *x, Grid *grid)
+/*!
+ * Return 1 if the particle lies inside the sub-domain owned by the
+ * local processor, 0 otherwise.
+ *********************************************************************** */
+{
+  int dir;
+  Grid *G;
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    G = grid + dir;
+    if (x[dir] <  G->xl[G->lbeg]) return 0;
+    if (x[dir] >= G->xr[G->lend]) return 0;
+  }
+  return 1;
+}
+
+/* ********************************************************************* */
+void Particles_Boundary (Grid *grid)
+/*!
+ * Apply periodic boundary conditions, remove particles that have left
+ * the computational domain and, in parallel, send particles leaving
+ * the local sub-domain to the processor owning them.
+ *********************************************************************** */
+{
+  int  n, dir, nout, keep;
+  double L;
+  Particle *p;
+  #ifdef PARALLEL
+   int  nproc, nrecv, *cnt, *displ;
+   static Particle *sbuf, *rbuf;
+   static int sbuf_max, rbuf_max;
+  #endif
+
+  nout = 0;
+  n    = 0;
+  while (n < p_num){
+    p = p_arr + n;
+
+  /* -- periodic wrap / removal at physical boundaries -- */
+
+    keep = 1;
+    for (dir = 0; dir < DIMENSIONS; dir++){
+      L = g_domEnd[dir] - g_domBeg[dir];
+      if (p_periodic[dir]){
+        if      (p->coord[dir] <  g_domBeg[dir]) p->coord[dir] += L;
+        else if (p->coord[dir] >= g_domEnd[dir]) p->coord[dir] -= L;
+      }else if (p->coord[dir] < g_domBeg[dir] || p->coord[dir] >= g_domEnd[dir]){
+        keep = 0;
+      }
+    }
+
+    if (keep && Particles_IsLocal(p->coord, grid)) {
+      n++;
+      continue;
+    }
+
+    #ifdef PARALLEL
+     if (keep){ /* -- particle moved to another processor -- */
+       if (nout == sbuf_max){
+         sbuf_max = (sbuf_max == 0 ? 64:2*sbuf_max);
+         sbuf = (Particle *) realloc (sbuf, sbuf_max*sizeof(Particle));
+       }
+       sbuf[nout++] = *p;
+     }
+    #endif
+    p_arr[n] = p_arr[--p_num];  /* -- remove from local list -- */
+  }
+
+  #ifdef PARALLEL
+   MPI_Comm_size (MPI_COMM_WORLD, &nproc);
+   cnt   = ARRAY_1D(nproc, int);
+   displ = ARRAY_1D(nproc, int);
+
+   nout *= sizeof(Particle);
+   MPI_Allgather (&nout, 1, MPI_INT, cnt, 1, MPI_INT, MPI_COMM_WORLD);
+   nrecv = 0;
+   for (n = 0; n < nproc; n++){
+     displ[n] = nrecv;
+     nrecv   += cnt[n];
+   }
+   if (nrecv > 0) {
+     if (nrecv > rbuf_max){
+       rbuf_max = nrecv;
+       rbuf     = (Particle *) realloc (rbuf, rbuf_max);
+     }
+     MPI_Allgatherv (sbuf, nout, MPI_BYTE, rbuf, cnt, displ, MPI_BYTE,
+                     MPI_COMM_WORLD);
+     nrecv /= sizeof(Particle);
+     for (n = 0; n < nrecv; n++){
+       if (Particles_IsLocal(rbuf[n].coord, grid)) Particles_Add (rbuf + n);
+     }
+   }
+   FreeArray1D ((void *) cnt);
+   FreeArray1D ((void *) displ);
+  #endif
+}
+
+/* ********************************************************************* */
+int LocateZone (double *x, int n, double x0)
+/*!
+ * Return the index \c i such that <tt> x[i] <= x0 < x[i+1] </tt>,
+ * limited to the range [0, n-2].
+ *********************************************************************** */
+{
+  int il = 0, ir = n - 1, im;
+
+  if (x0 <= x[0])     return 0;
+  if (x0 >= x[n - 1]) return n - 2;
+  while (ir - il > 1){
+    im = (il + ir)/2;
+    if (x0 < x[im]) ir = im;
+    else            il = im;
+  }
+  return il;
+}
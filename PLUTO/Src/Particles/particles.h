@@ -1,50 +1,109 @@
-/*  **************************************************************
-            Header file for particle module.
-    **************************************************************  */
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Lagrangian tracer particles module header file.
 
-#define NPARTICLES 256
+  Tracer particles are passively advected with the fluid and record
+  the local density, pressure and magnetic field together with the
+  history of shock crossings (detected from the flags set by FlagShock()).
+  Each particle also carries a non-thermal electron spectrum, injected
+  at shocks and evolved under adiabatic and synchrotron (+IC) losses.
 
-typedef struct PARTICLES
-{  
-    int    identity             ;  /*   identifiant of  particle  */
-    int    cell [DIMENSIONS]    ;  /*   particle'   cell index    */
-    real coor [DIMENSIONS]    ;  /*   coordinates of particle   */
-    real speed[DIMENSIONS]    ;  /*   speed       of particle   */
-    real mag  [DIMENSIONS]    ;  /*   magnetic field            */
-    real density              ;  /*   density in part.coor      */
-    real pression             ;  /*   pression in part.coor     */
-    real divv                 ;  /*   speed divergence          */
+  The module is enabled by setting \c INCLUDE_PARTICLES to \c YES in
+  the user-defined constants section of definitions.h.
+  The number of particles and the output frequency are set in
+  pluto.ini through the line
+  \code
+    particles   <N>   <dt>   <dn>
+  \endcode
 
-}particle;
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
 
-typedef struct head {
-    struct cell *first;
-}HEAD;
+#ifdef CH_SPACEDIM
+ #error Tracer particles are not supported with Chombo AMR
+#endif
 
-typedef struct cell{
-    struct PARTICLES part;
-    struct cell *next;
-}CELL;
+/* ------------------------------------------------------------
+    Electron spectrum: number of (logarithmically spaced) bins
+    in Lorentz factor and spectrum boundaries.
+   ------------------------------------------------------------ */
 
-/*  ----  Prototyping goes here  ----  */
+#ifndef PARTICLES_NBINS
+ #define PARTICLES_NBINS    32  
+#endif
 
-void SET_PARTICLES (HEAD *list, HEAD *temp_list, struct GRID gxyz[],
-		    real ***uu[] );
-void ADVANCE_PARTICLES_predictor (HEAD *list,HEAD *temp_list, real ***uu[], 
-                                  struct GRID gxyz[], real dt, real striction);
-void ADVANCE_PARTICLES_corrector (HEAD *list,HEAD *temp_list, real ***uu[], 
-                                  struct GRID gxyz[], real dt, real striction);
-void SAVE_PARTICLES(HEAD *list, int nt, real t, 
-                    real striction, real ***uu[]);
-void SAVE_STEP ( HEAD *list, real dt, int nop );
-void RENAME_PARTICLES( HEAD *list);
+#ifndef PARTICLES_GAMMA_MIN
+ #define PARTICLES_GAMMA_MIN   1.0
+#endif
 
-/* ROUTINES FOR LINKED LIST */
+#ifndef PARTICLES_GAMMA_MAX
+ #define PARTICLES_GAMMA_MAX   1.e9
+#endif
 
-void ADD_CELL(HEAD *list, struct PARTICLES *pl);
-void DELETE_CELL(HEAD *list, int i);
-void DISPLAY_LIST(HEAD *list);
+/* ------------------------------------------------------------
+    Injection parameters: fraction of the post-shock thermal
+    energy transferred to electrons, injection range and
+    shock detection threshold (used only when FlagShock()
+    is not available).
+   ------------------------------------------------------------ */
 
+#ifndef PARTICLES_EPS_E
+ #define PARTICLES_EPS_E      1.e-3
+#endif
 
+#ifndef PARTICLES_INJ_GMIN
+ #define PARTICLES_INJ_GMIN   10.0
+#endif
 
+#ifndef PARTICLES_INJ_GMAX
+ #define PARTICLES_INJ_GMAX   1.e7
+#endif
 
+#ifndef PARTICLES_EPS_SHOCK
+ #define PARTICLES_EPS_SHOCK  5.0
+#endif
+
+/*! Energy density (in erg/cm^3) of the background radiation field used
+    to compute inverse Compton losses (default is the CMB at z = 0). */
+#ifndef PARTICLES_URAD
+ #define PARTICLES_URAD      4.2e-13
+#endif
+
+typedef struct PARTICLE{
+  double coord[3];  /**< Particle coordinates. */
+  double speed[3];  /**< Fluid velocity at the particle position. */
+  double rho;       /**< Density at the particle position. */
+  double prs;       /**< Pressure at the particle position. */
+  double B[3];      /**< Magnetic field at the particle position. */
+  double tshock;    /**< Time of the last shock crossing (-1 if none). */
+  double comp;      /**< Compression ratio across the last shock. */
+  double rho_pre;   /**< Pre-shock density (used to compute \c comp). */
+  double N[PARTICLES_NBINS]; /**< Electron spectrum: number of electrons
+                                  per unit mass (in g^{-1}) in each 
+                                  Lorentz factor bin. */
+  int    id;        /**< Particle identification number. */
+  int    nshocks;   /**< Number of shocks crossed so far. */
+  int    in_shock;  /**< Set to 1 while the particle lies in a shocked
+                         zone, 0 otherwise. */
+} Particle;
+
+/*! Number of double-precision fields written to disk for each particle
+    (\c id, coordinates, velocity, \c rho, \c prs, magnetic field,
+     \c nshocks, \c tshock, \c comp and the spectrum). */
+#define PARTICLES_NFIELDS   (15 + PARTICLES_NBINS)
+
+void Particles_Init       (Data *, Runtime *, int, Grid *);
+void Particles_Restart    (Data *, Runtime *, Grid *);
+void Particles_Update     (Data *, double, Grid *);
+void Particles_Add        (Particle *);
+int  Particles_IsLocal    (double *, Grid *);
+void Particles_Spectrum   (Particle *, double, double, double);
+void Particles_Inject     (Particle *);
+void Particles_Write      (Runtime *, Grid *);
+void Particles_CheckForOutput (Runtime *, Grid *);
+
+int       Particles_Number  (void);
+Particle *Particles_Array   (void);
+double   *Particles_GammaBins (void);
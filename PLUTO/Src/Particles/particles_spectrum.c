@@ -0,0 +1,176 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Evolve the non-thermal electron spectrum carried by particles.
+
+  The spectrum is discretized on \c PARTICLES_NBINS logarithmically
+  spaced bins in Lorentz factor between \c PARTICLES_GAMMA_MIN and
+  \c PARTICLES_GAMMA_MAX and gives the number of electrons per unit mass
+  in each bin (this quantity is conserved under compression).
+
+  During one time step, the Lorentz factor of an electron changes because
+  of adiabatic compression/expansion and radiative (synchrotron + inverse
+  Compton) losses:
+  \f[
+    \frac{d\gamma}{dt} = \frac{\gamma}{3\rho}\frac{d\rho}{dt}
+                         - b\gamma^2\,,\qquad
+    b = \frac{4}{3}\frac{\sigma_T c}{m_ec^2}
+        \left(\frac{B^2}{8\pi} + u_{\rm rad}\right)
+  \f]
+  Both terms are integrated exactly (assuming \f$B\f$ constant during
+  the step) and applied in sequence, so that the bin edges are mapped to
+  \f[
+    \gamma' = \left[\frac{1}{f\gamma} + b\Delta t\right]^{-1}\,,\qquad
+    f = \left(\frac{\rho^{n+1}}{\rho^n}\right)^{1/3}
+  \f]
+  The content of each bin is then remapped conservatively (with a
+  piecewise constant distribution in \f$\log\gamma\f$) onto the fixed bins.
+  Electrons cooling below \c PARTICLES_GAMMA_MIN are removed from the
+  spectrum.
+
+  At the end of a shock crossing, a power-law distribution
+  \f$N(\gamma)\propto\gamma^{-s}\f$ with the test-particle diffusive
+  shock acceleration slope \f$s = (r+2)/(r-1)\f$ (\f$r\f$ being the
+  compression ratio) is injected between \c PARTICLES_INJ_GMIN and
+  \c PARTICLES_INJ_GMAX, normalized so that its energy is a fraction
+  \c PARTICLES_EPS_E of the post-shock thermal energy.
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+static double *gam_edge, *lgam_edge;
+static double PowerIntegral (double, double, double);
+
+/* ********************************************************************* */
+double *Particles_GammaBins (void)
+/*!
+ * Return an array of \c PARTICLES_NBINS+1 bin edges (in Lorentz factor).
+ *********************************************************************** */
+{
+  int    m;
+  double lgmin, dlg;
+
+  if (gam_edge == NULL){
+    gam_edge  = ARRAY_1D(PARTICLES_NBINS + 1, double);
+    lgam_edge = ARRAY_1D(PARTICLES_NBINS + 1, double);
+    lgmin = log(PARTICLES_GAMMA_MIN);
+    dlg   = (log(PARTICLES_GAMMA_MAX) - lgmin)/(double)PARTICLES_NBINS;
+    for (m = 0; m <= PARTICLES_NBINS; m++){
+      lgam_edge[m] = lgmin + m*dlg;
+      gam_edge[m]  = exp(lgam_edge[m]);
+    }
+  }
+  return gam_edge;
+}
+
+/* ********************************************************************* */
+void Particles_Spectrum (Particle *p, double rho_old, double rho_new,
+                         double dt)
+/*!
+ * Update the particle spectrum for adiabatic and radiative losses.
+ *
+ * \param [in,out] p        pointer to a Particle structure
+ * \param [in]     rho_old  density at the beginning of the step
+ * \param [in]     rho_new  density at the end of the step
+ * \param [in]     dt       the time step (code units)
+ *********************************************************************** */
+{
+  int    m, t, empty = 1;
+  double Nn[PARTICLES_NBINS];
+  double fa, B2, bdt, ga, gb, la, lb, dlg, ovl;
+  double unit_B = sqrt(4.0*CONST_PI*UNIT_DENSITY)*UNIT_VELOCITY;
+
+  for (m = 0; m < PARTICLES_NBINS; m++) {
+    if (p->N[m] > 0.0) empty = 0;
+  }
+  if (empty) return;
+
+  Particles_GammaBins();
+  dlg = lgam_edge[1] - lgam_edge[0];
+
+  fa  = pow(rho_new/rho_old, 1.0/3.0);
+  B2  = (p->B[IDIR]*p->B[IDIR] + p->B[JDIR]*p->B[JDIR]
+                               + p->B[KDIR]*p->B[KDIR])*unit_B*unit_B;
+  bdt = 4.0/3.0*CONST_sigmaT/(CONST_me*CONST_c)
+        *(B2/(8.0*CONST_PI) + PARTICLES_URAD)*dt*UNIT_LENGTH/UNIT_VELOCITY;
+
+  for (t = 0; t < PARTICLES_NBINS; t++) Nn[t] = 0.0;
+
+  for (m = 0; m < PARTICLES_NBINS; m++){
+    if (p->N[m] <= 0.0) continue;
+
+  /* -- map bin edges -- */
+
+    ga = 1.0/(1.0/(fa*gam_edge[m])     + bdt);
+    gb = 1.0/(1.0/(fa*gam_edge[m + 1]) + bdt);
+    if (gb <= gam_edge[0]) continue;    /* thermalized */
+
+  /* -- distribute bin content over the fixed bins -- */
+
+    la = log(ga);
+    lb = log(gb);
+    t  = (int)floor((la - lgam_edge[0])/dlg);
+    t  = MAX(t, 0);
+    for (; t < PARTICLES_NBINS && lgam_edge[t] < lb; t++){
+      ovl = MIN(lb, lgam_edge[t + 1]) - MAX(la, lgam_edge[t]);
+      if (ovl > 0.0) Nn[t] += p->N[m]*ovl/(lb - la);
+    }
+  }
+
+  for (m = 0; m < PARTICLES_NBINS; m++) p->N[m] = Nn[m];
+}
+
+/* ********************************************************************* */
+void Particles_Inject (Particle *p)
+/*!
+ * Inject a power-law electron distribution after a shock crossing.
+ *
+ * \param [in,out] p  pointer to a Particle structure
+ *********************************************************************** */
+{
+  int    m;
+  double r, s, ga, gb, eth, Etot, norm, gmm1;
+  double n_inj[PARTICLES_NBINS];
+
+  r = p->comp;
+  if (r <= 1.0 + 1.e-3) return;  /* -- no appreciable compression -- */
+
+  s = (r + 2.0)/(r - 1.0);
+  s = MAX(s, 2.0);
+
+  Particles_GammaBins();
+  Etot = 0.0;
+  for (m = 0; m < PARTICLES_NBINS; m++){
+    ga = MAX(gam_edge[m],     PARTICLES_INJ_GMIN);
+    gb = MIN(gam_edge[m + 1], PARTICLES_INJ_GMAX);
+    n_inj[m] = 0.0;
+    if (gb <= ga) continue;
+    n_inj[m] = PowerIntegral(ga, gb, -s);
+    Etot    += PowerIntegral(ga, gb, 1.0 - s);
+  }
+  if (Etot <= 0.0) return;
+
+/* -- thermal energy per unit mass in erg/g -- */
+
+  #if EOS == IDEAL
+   gmm1 = g_gamma - 1.0;
+  #else
+   gmm1 = 2.0/3.0;
+  #endif
+  eth  = p->prs/(gmm1*p->rho)*UNIT_VELOCITY*UNIT_VELOCITY;
+  norm = PARTICLES_EPS_E*eth/(Etot*CONST_me*CONST_c*CONST_c);
+
+  for (m = 0; m < PARTICLES_NBINS; m++) p->N[m] += norm*n_inj[m];
+}
+
+/* ********************************************************************* */
+double PowerIntegral (double a, double b, double q)
+/*!
+ * Return the integral of x^q between a and b.
+ *********************************************************************** */
+{
+  if (fabs(q + 1.0) < 1.e-8) return log(b/a);
+  return (pow(b, q + 1.0) - pow(a, q + 1.0))/(q + 1.0);
+}
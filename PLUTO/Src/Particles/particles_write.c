@@ -0,0 +1,261 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Write particle data to disk.
+
+  Particles are collected by processor 0 and written in double precision
+  to the binary file <tt> particles.nnnn.dbl </tt> (in the output
+  directory) as a sequence of records, one per particle, each containing
+  ::PARTICLES_NFIELDS values:
+  \code
+    id, x1, x2, x3, v1, v2, v3, rho, prs, B1, B2, B3,
+    nshocks, tshock, comp, N[0], ..., N[PARTICLES_NBINS-1]
+  \endcode
+  The file \c particles.out lists, for each output, the file number,
+  time, time step, step number, number of particles, number of fields
+  per particle and endianness.
+  The Lorentz factor bin edges of the spectrum are written once
+  to \c particles_gamma.out.
+  On restart, particles are read back from the last file written at
+  or before the restart time and the numbering continues from it.
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+static int p_nfile = -1;
+
+/* ********************************************************************* */
+void Particles_CheckForOutput (Runtime *ini, Grid *grid)
+/*!
+ * Check whether particle data needs to be written to disk, using the
+ * time (\c dt) and step (\c dn) increments given in pluto.ini.
+ *
+ * \param [in] ini   pointer to the Runtime structure
+ * \param [in] grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int check_dt, check_dn;
+  double t, tnext;
+
+  if (ini->part_np <= 0) return;
+
+  t     = g_time;
+  tnext = t + g_dt;
+  check_dt = (int) (tnext/ini->part_dt) - (int)(t/ini->part_dt);
+  check_dt = check_dt || g_stepNumber == 0 || fabs(t - ini->tstop) < 1.e-9;
+  check_dt = check_dt && (ini->part_dt > 0.0);
+
+  check_dn = (g_stepNumber%ini->part_dn) == 0;
+  check_dn = check_dn && (ini->part_dn > 0);
+
+  if (check_dt || check_dn) Particles_Write (ini, grid);
+}
+
+/* ********************************************************************* */
+void Particles_Write (Runtime *ini, Grid *grid)
+/*!
+ * Gather particles on processor 0 and write them to disk.
+ *
+ * \param [in] ini   pointer to the Runtime structure
+ * \param [in] grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    n, m, np, np_glob, nf;
+  double *buf, *q, *gbin;
+  char   filename[512], sline[512];
+  Particle *p;
+  FILE  *fout;
+  #ifdef PARALLEL
+   int    nproc, *cnt, *displ;
+   double *rbuf;
+  #endif
+
+  p_nfile++;
+  print1 ("> Writing particle file #%d to disk...\n", p_nfile);
+
+/* --------------------------------------------------------
+    1. Pack local particles
+   -------------------------------------------------------- */
+
+  np  = Particles_Number();
+  p   = Particles_Array();
+  nf  = PARTICLES_NFIELDS;
+  buf = (double *) malloc ((np > 0 ? np:1)*nf*sizeof(double));
+
+  for (n = 0; n < np; n++){
+    q = buf + n*nf;
+    q[0] = p[n].id;
+    q[1] = p[n].coord[IDIR];  q[2] = p[n].coord[JDIR];  q[3] = p[n].coord[KDIR];
+    q[4] = p[n].speed[IDIR];  q[5] = p[n].speed[JDIR];  q[6] = p[n].speed[KDIR];
+    q[7] = p[n].rho;
+    q[8] = p[n].prs;
+    q[9] = p[n].B[IDIR];  q[10] = p[n].B[JDIR];  q[11] = p[n].B[KDIR];
+    q[12] = p[n].nshocks;
+    q[13] = p[n].tshock;
+    q[14] = p[n].comp;
+    for (m = 0; m < PARTICLES_NBINS; m++) q[15 + m] = p[n].N[m];
+  }
+
+/* --------------------------------------------------------
+    2. Gather on processor 0
+   -------------------------------------------------------- */
+
+  np_glob = np;
+  #ifdef PARALLEL
+   MPI_Comm_size (MPI_COMM_WORLD, &nproc);
+   cnt   = ARRAY_1D(nproc, int);
+   displ = ARRAY_1D(nproc, int);
+   n = np*nf;
+   MPI_Gather (&n, 1, MPI_INT, cnt, 1, MPI_INT, 0, MPI_COMM_WORLD);
+   np_glob = 0;
+   if (prank == 0){
+     for (n = 0; n < nproc; n++){
+       displ[n] = np_glob;
+       np_glob += cnt[n];
+     }
+     np_glob /= nf;
+   }
+   rbuf = (double *) malloc ((np_glob > 0 ? np_glob:1)*nf*sizeof(double));
+   MPI_Gatherv (buf, np*nf, MPI_DOUBLE, rbuf, cnt, displ, MPI_DOUBLE,
+                0, MPI_COMM_WORLD);
+   free (buf);
+   buf = rbuf;
+   FreeArray1D ((void *) cnt);
+   FreeArray1D ((void *) displ);
+  #endif
+
+/* --------------------------------------------------------
+    3. Write binary data and update the .out files
+   -------------------------------------------------------- */
+
+  if (prank == 0){
+    sprintf (filename, "%s/particles.%04d.dbl", ini->output_dir, p_nfile);
+    fout = fopen (filename, "wb");
+    if (fout == NULL){
+      print1 ("! Particles_Write: cannot open %s\n", filename);
+      QUIT_PLUTO(1);
+    }
+    fwrite (buf, sizeof(double), (size_t)np_glob*nf, fout);
+    fclose (fout);
+
+    sprintf (filename, "%s/particles.out", ini->output_dir);
+    if (p_nfile == 0) {
+      fout = fopen (filename, "w");
+    }else {
+      fout = fopen (filename, "r+");
+      for (n = 0; n < p_nfile; n++) fgets (sline, 512, fout);
+      fseek (fout, ftell(fout), SEEK_SET);
+    }
+    fprintf (fout, "%d %12.6e %12.6e %ld %d %d %s\n", p_nfile, g_time, g_dt,
+             g_stepNumber, np_glob, nf, IsLittleEndian() ? "little":"big");
+    fclose (fout);
+
+    if (p_nfile == 0){
+      sprintf (filename, "%s/particles_gamma.out", ini->output_dir);
+      fout = fopen (filename, "w");
+      gbin = Particles_GammaBins();
+      for (m = 0; m <= PARTICLES_NBINS; m++) fprintf (fout, "%12.6e\n", gbin[m]);
+      fclose (fout);
+    }
+  }
+  free (buf);
+}
+
+/* ********************************************************************* */
+void Particles_Restart (Data *d, Runtime *ini, Grid *grid)
+/*!
+ * Restore particles from the last particle file written at or before
+ * the restart time ::g_time, listed in \c particles.out.
+ * Each processor retains the particles lying in its own sub-domain
+ * and subsequent output files are numbered after the restored one.
+ * The shock flag \c in_shock is not saved and is reset to 0.
+ * If no particle file is available, particles are seeded as in a
+ * new computation.
+ *
+ * \param [in] d     pointer to the PLUTO Data structure
+ * \param [in] ini   pointer to the Runtime structure
+ * \param [in] grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    n, m, nfile, np, nf, ifile = -1, np_file = 0;
+  long   nstep;
+  double t, dt, t_file = 0.0, q[PARTICLES_NFIELDS];
+  char   filename[512], sline[512], endn[32];
+  Particle p;
+  FILE  *fin;
+
+  if (ini->part_np <= 0) return;
+
+/* --------------------------------------------------------
+    1. Find the last particle file not beyond g_time
+   -------------------------------------------------------- */
+
+  sprintf (filename, "%s/particles.out", ini->output_dir);
+  fin = fopen (filename, "r");
+  if (fin != NULL){
+    while (fgets (sline, 512, fin) != NULL){
+      if (sscanf (sline, "%d %lf %lf %ld %d %d %31s", &nfile, &t, &dt,
+                  &nstep, &np, &nf, endn) != 7) continue;
+      if (t > g_time*(1.0 + 1.e-6)) break;   /* -- t has 7 digits -- */
+      if (nf != PARTICLES_NFIELDS){
+        print1 ("! Particles_Restart: %s has %d fields per particle (%d expected)\n",
+                 filename, nf, PARTICLES_NFIELDS);
+        QUIT_PLUTO(1);
+      }
+      if (strcmp(endn, IsLittleEndian() ? "little":"big")){
+        print1 ("! Particles_Restart: %s endianness not supported\n", endn);
+        QUIT_PLUTO(1);
+      }
+      ifile   = nfile;
+      t_file  = t;
+      np_file = np;
+    }
+    fclose (fin);
+  }
+
+  if (ifile < 0){
+    print1 ("! Particles_Restart: no particle file found, seeding new particles\n");
+    Particles_Init (d, ini, 0, grid);
+    return;
+  }
+  if (fabs(t_file - g_time) > 1.e-6*fabs(g_time)){
+    print1 ("! Particles_Restart: particles restored from t = %12.6e\n", t_file);
+  }
+
+/* --------------------------------------------------------
+    2. Read particles and keep the local ones
+   -------------------------------------------------------- */
+
+  print1 ("> Particles: restoring %d particles from file #%d\n",
+           np_file, ifile);
+  sprintf (filename, "%s/particles.%04d.dbl", ini->output_dir, ifile);
+  fin = fopen (filename, "rb");
+  if (fin == NULL){
+    print1 ("! Particles_Restart: cannot open %s\n", filename);
+    QUIT_PLUTO(1);
+  }
+  for (n = 0; n < np_file; n++){
+    if (fread (q, sizeof(double), PARTICLES_NFIELDS, fin) != PARTICLES_NFIELDS){
+      print1 ("! Particles_Restart: %s is truncated\n", filename);
+      QUIT_PLUTO(1);
+    }
+    memset (&p, 0, sizeof(Particle));
+    p.id = (int) q[0];
+    p.coord[IDIR] = q[1];  p.coord[JDIR] = q[2];  p.coord[KDIR] = q[3];
+    if (!Particles_IsLocal(p.coord, grid)) continue;
+    p.speed[IDIR] = q[4];  p.speed[JDIR] = q[5];  p.speed[KDIR] = q[6];
+    p.rho = q[7];
+    p.prs = q[8];
+    p.B[IDIR] = q[9];  p.B[JDIR] = q[10];  p.B[KDIR] = q[11];
+    p.nshocks = (int) q[12];
+    p.tshock  = q[13];
+    p.comp    = q[14];
+    for (m = 0; m < PARTICLES_NBINS; m++) p.N[m] = q[15 + m];
+    p.rho_pre = p.rho;
+    Particles_Add (&p);
+  }
+  fclose (fin);
+  p_nfile = ifile;
+}
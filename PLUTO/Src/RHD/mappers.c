@@ -121,7 +121,7 @@ int ConsToPrim (double **ucons, double **uprim, int ibeg, int iend,
  *********************************************************************** */
 {
   int    nv, i, err, ifail;
-  int    use_entropy, use_energy=1;
+  int    use_entropy, use_energy=1, rescue;
   double  scrh, m, g;
   double *u, *v;
   Map_param par;
@@ -131,6 +131,9 @@ int ConsToPrim (double **ucons, double **uprim, int ibeg, int iend,
 
     u = ucons[i];
     v = uprim[i];
+    #if FAILSAFE == YES
+     rescue = 0;
+    #endif
 
   /* -----------------------------------------------------------
       Define the input parameters of the parameter structure
@@ -178,7 +181,11 @@ int ConsToPrim (double **ucons, double **uprim, int ibeg, int iend,
         err = PressureFix(&par);
         if (err){
           Where(i,NULL);
-          QUIT_PLUTO(1);
+          #if FAILSAFE == YES
+           rescue = 1;  /* the step will be redone (see failsafe.c) */
+          #else
+           QUIT_PLUTO(1);
+          #endif
         }
         flag[i] |= FLAG_CONS2PRIM_FAIL;
         ifail    = 1;
@@ -194,7 +201,11 @@ int ConsToPrim (double **ucons, double **uprim, int ibeg, int iend,
         err = PressureFix(&par);
         if (err){
           Where(i,NULL);
-          QUIT_PLUTO(1);
+          #if FAILSAFE == YES
+           rescue = 1;  /* the step will be redone (see failsafe.c) */
+          #else
+           QUIT_PLUTO(1);
+          #endif
         }
         u[ENG]   = par.E;
         flag[i] |= FLAG_CONS2PRIM_FAIL;
@@ -220,6 +231,18 @@ int ConsToPrim (double **ucons, double **uprim, int ibeg, int iend,
     g = 1.0/sqrt(1.0 - g);
     v[RHO] = u[RHO]/g;
 
+#if FAILSAFE == YES
+    if (rescue){  /* placeholder state until the step is redone */
+      v[RHO] = u[RHO];
+      v[PRS] = g_smallPressure;
+      EXPAND(v[VX1] = 0.0;  ,
+             v[VX2] = 0.0;  ,
+             v[VX3] = 0.0;)
+      flag[i] |= FLAG_CONS2PRIM_FAIL | FLAG_RESCUE;
+      ifail    = 1;
+    }
+#endif
+
 #if NSCL > 0     
     NSCL_LOOP(nv)  v[nv] = u[nv]/u[RHO];
 #endif
@@ -818,6 +818,30 @@ void PrimToChar (double **Lp, double *v, double *w)
 }
 
 
+/* ********************************************************************* */
+void CharToPrim (double **R, double *w, double *v)
+/*!
+ *  Compute the matrix-vector multiplication between the R matrix
+ *  (containing primitive right eigenvectors) and the vector w of
+ *  characteristic variables, v = R.w, for the first NFLX components.
+ *
+ * \param [in]   R   Right eigenvectors
+ * \param [in]   w   (difference of) characteristic variables
+ * \param [out]  v   (difference of) primitive variables
+ *
+ *********************************************************************** */
+{
+  int    k, nv;
+  double s;
+
+  for (nv = 0; nv < NFLX; nv++){
+    s = 0.0;
+    for (k = 0; k < NFLX; k++) s += w[k]*R[nv][k];
+    v[nv] = s;
+  }
+}
+
+
 int PRINT_STATE(double *q, double *lambda, double cs2, double hh)
 {
 
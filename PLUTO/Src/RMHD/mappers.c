@@ -134,7 +134,7 @@ int ConsToPrim (double **ucons, double **uprim, int beg, int end,
  *********************************************************************** */
 {
   int    i, nv, err, ifail;
-  int    use_entropy, use_energy=1;
+  int    use_entropy, use_energy=1, rescue;
   double *u, *v, scrh, w_1;
   Map_param par;
 
@@ -143,6 +143,9 @@ int ConsToPrim (double **ucons, double **uprim, int beg, int end,
 
     u = ucons[i];
     v = uprim[i];
+    #if FAILSAFE == YES
+     rescue = 0;
+    #endif
 
   /* -----------------------------------------------------------
       Define the input parameters of the parameter structure
@@ -194,7 +197,11 @@ int ConsToPrim (double **ucons, double **uprim, int beg, int end,
         err = PressureFix(&par);
         if (err){
           Where(i,NULL);
-          QUIT_PLUTO(1);
+          #if FAILSAFE == YES
+           rescue = 1;  /* the step will be redone (see failsafe.c) */
+          #else
+           QUIT_PLUTO(1);
+          #endif
         }
         flag[i] |= FLAG_CONS2PRIM_FAIL;
         ifail    = 1;
@@ -210,7 +217,11 @@ int ConsToPrim (double **ucons, double **uprim, int beg, int end,
         err = PressureFix(&par);
         if (err){
           Where(i,NULL);
-          QUIT_PLUTO(1);
+          #if FAILSAFE == YES
+           rescue = 1;  /* the step will be redone (see failsafe.c) */
+          #else
+           QUIT_PLUTO(1);
+          #endif
         }
         u[ENG]   = par.E;
         flag[i] |= FLAG_CONS2PRIM_FAIL;
@@ -237,9 +248,25 @@ int ConsToPrim (double **ucons, double **uprim, int beg, int end,
       print ("! ConsToPrim(): v^2 = %f > 1  (p = %12.6e); ", scrh, par.prs);
       Where (i, NULL);
       print ("!               Flag_Entropy = %d\n", (flag[i] & FLAG_ENTROPY)); 
-      QUIT_PLUTO(1);
+      #if FAILSAFE == YES
+       rescue = 1;
+      #else
+       QUIT_PLUTO(1);
+      #endif
     }
 
+#if FAILSAFE == YES
+    if (rescue){  /* placeholder state until the step is redone */
+      v[RHO] = u[RHO];
+      v[PRS] = g_smallPressure;
+      EXPAND(v[VX1] = 0.0;  ,
+             v[VX2] = 0.0;  ,
+             v[VX3] = 0.0;)
+      flag[i] |= FLAG_CONS2PRIM_FAIL | FLAG_RESCUE;
+      ifail    = 1;
+    }
+#endif
+
     EXPAND(v[BX1] = u[BX1];  ,
            v[BX2] = u[BX2];  ,
            v[BX3] = u[BX3];)
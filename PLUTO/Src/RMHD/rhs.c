@@ -630,7 +630,7 @@ void RightHandSide (const State_1D *state, Time_Step *Dts,
       multiply fluxes by interface area 
      **************************************************** */
 
-    th  = x2[j]; s = sin(th);
+    s   = grid[JDIR].st[j];
     phi = x3[k];
     for (i = beg - 1; i <= end; i++){
       r  = x1p[i];
@@ -794,11 +794,10 @@ void RightHandSide (const State_1D *state, Time_Step *Dts,
      Enthalpy (state->v, h, beg, end);
     #endif
     for (j = beg; j <= end; j++){
-      th   = x2[j];
       dtdV = dt/dV2[j]*r_1;
       dtdx = dt/dx2[j]*r_1;      
-      s    = sin(th);
-      s_1  = 1.0/s;   
+      s    = grid[JDIR].st[j];
+      s_1  = grid[JDIR].st_1[j];
       ct   = grid[JDIR].ct[j];         /* = cot(theta)  */
 
     /* -----------------------------------------------
@@ -187,3 +187,106 @@ void Flatten (const State_1D *state, int beg, int end, Grid *grid)
 }
 #endif
 
+
+#if CHAR_LIMITING_HYBRID == YES
+
+#ifndef CHAR_LIMITING_HYBRID_EPS
+ #define CHAR_LIMITING_HYBRID_EPS  0.05
+#endif
+
+/* ********************************************************************** */
+void FlagSmoothZones (const State_1D *state, int beg, int end, int S,
+                      unsigned char *smooth)
+/*!
+ * Detect zones where the solution is smooth along the current
+ * direction, for the hybrid characteristic limiting
+ * (::CHAR_LIMITING_HYBRID == YES).
+ * An interface is marked as a jump when the relative difference 
+ * between the two adjacent zones exceeds ::CHAR_LIMITING_HYBRID_EPS in
+ * density, pressure, velocity or magnetic field (velocity and field 
+ * are measured against the local (total) pressure).
+ * A zone is smooth if none of the interfaces within its reconstruction
+ * stencil <tt> [i-S, i+S] </tt> is a jump and, with multi-D shock
+ * flattening, if neither the zone nor its neighbours are flagged.
+ * In smooth zones, limiting can be safely done in primitive variables
+ * and the characteristic projection skipped.
+ *
+ * \param [in]  state   pointer to State_1D structure
+ * \param [in]  beg     initial index of computation
+ * \param [in]  end     final   index of computation
+ * \param [in]  S       half-width of the reconstruction stencil
+ * \param [out] smooth  array set to 1 (smooth) or 0 for 
+ *                      <tt> beg <= i <= end </tt>.
+ *
+ ************************************************************************ */
+{
+  int    i, nv, s;
+  double eps2 = CHAR_LIMITING_HYBRID_EPS*CHAR_LIMITING_HYBRID_EPS;
+  double dq, dp, dv2, db2, pL, pR, pmin, rhomax, **v;
+  static unsigned char *jump;
+
+  if (jump == NULL) jump = ARRAY_1D(NMAX_POINT, unsigned char);
+
+  v = state->v;
+
+/* --------------------------------------------------------
+   1. Mark interfaces i+1/2 across which the solution jumps
+   -------------------------------------------------------- */
+
+  for (i = beg - S; i <= end + S - 1; i++){
+    #if HAVE_ENERGY
+     pL = v[i][PRS];
+     pR = v[i+1][PRS];
+    #elif EOS == ISOTHERMAL
+     pL = v[i][RHO]*g_isoSoundSpeed*g_isoSoundSpeed;
+     pR = v[i+1][RHO]*g_isoSoundSpeed*g_isoSoundSpeed;
+    #else
+     pL = pR = 0.0;
+    #endif
+    dp = fabs(pR - pL);
+
+    db2 = 0.0;
+    #if PHYSICS == MHD || PHYSICS == RMHD
+     pL += 0.5*EXPAND(v[i][BX1]*v[i][BX1], + v[i][BX2]*v[i][BX2],
+                                          + v[i][BX3]*v[i][BX3]);
+     pR += 0.5*EXPAND(v[i+1][BX1]*v[i+1][BX1], + v[i+1][BX2]*v[i+1][BX2],
+                                              + v[i+1][BX3]*v[i+1][BX3]);
+     for (nv = BX1; nv < BX1 + COMPONENTS; nv++){
+       dq   = v[i+1][nv] - v[i][nv];
+       db2 += dq*dq;
+     }
+    #endif
+    pmin   = MIN(pL, pR);
+    rhomax = MAX(v[i][RHO], v[i+1][RHO]);
+
+    dv2 = 0.0;
+    #if PHYSICS != ADVECTION
+     for (nv = VX1; nv < VX1 + COMPONENTS; nv++){
+       dq   = v[i+1][nv] - v[i][nv];
+       dv2 += dq*dq;
+     }
+    #endif
+
+    jump[i] =    fabs(v[i+1][RHO] - v[i][RHO]) 
+               > CHAR_LIMITING_HYBRID_EPS*MIN(v[i][RHO], v[i+1][RHO])
+              || dv2*rhomax > eps2*pmin 
+              || db2 > eps2*pmin;
+    #if HAVE_ENERGY
+     jump[i] = jump[i] || dp > CHAR_LIMITING_HYBRID_EPS*pmin;
+    #endif
+  }
+
+/* --------------------------------------------------------
+   2. A zone is smooth if its stencil contains no jump
+   -------------------------------------------------------- */
+
+  for (i = beg; i <= end; i++){
+    smooth[i] = 1;
+    for (s = i - S; s < i + S && smooth[i]; s++) smooth[i] = !jump[s];
+    #if SHOCK_FLATTENING == MULTID
+     if ( (state->flag[i-1] | state->flag[i] | state->flag[i+1]) 
+           & (FLAG_MINMOD | FLAG_FLAT)) smooth[i] = 0;
+    #endif
+  }
+}
+#endif /* CHAR_LIMITING_HYBRID == YES */
@@ -30,8 +30,11 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
   double **L, **R, *lambda;
   double dwp[NVAR], dwp_lim[NVAR];
   double dwm[NVAR], dwm_lim[NVAR];
-  double dvpR, dvmR;
+  double dvpR, dvmR, dvpc[NVAR], dvmc[NVAR];
   static double **dv;
+  #if CHAR_LIMITING == YES && CHAR_LIMITING_HYBRID == YES
+   static unsigned char *smooth;
+  #endif
 
 /* ----------------------------------------------------
    0. Allocate memory, set pointer shortcuts 
@@ -39,6 +42,9 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
 
   if (dv == NULL) {
     dv = ARRAY_2D(NMAX_POINT, NVAR, double);
+    #if CHAR_LIMITING == YES && CHAR_LIMITING_HYBRID == YES
+     smooth = ARRAY_1D(NMAX_POINT, unsigned char);
+    #endif
   }
 
   v  = state->v;
@@ -92,6 +98,10 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
    i = beg-1;
    NVAR_LOOP(nv) dv[i][nv] = v[i+1][nv] - v[i][nv];
 
+   #if CHAR_LIMITING_HYBRID == YES
+    FlagSmoothZones (state, beg, end, 1, smooth);
+   #endif
+
    for (i = beg; i <= end; i++){
 
      NVAR_LOOP(nv) dv[i][nv] = v[i+1][nv] - v[i][nv];
@@ -100,16 +110,28 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
      lambda = state->lambda[i];
      dvp = dv[i];  
      dvm = dv[i-1];
-    
-  /* -------------------------------
-      project undivided differences 
-      onto characteristic space
-     ------------------------------- */
-     
-     PrimEigenvectors (v[i], state->a2[i], state->h[i], lambda, L, R);
-     PrimToChar(L, dvp, dwp);
-     PrimToChar(L, dvm, dwm);
 
+  /* -- tracing needs eigenvectors in every zone -- */
+
+     #if TIME_STEPPING == CHARACTERISTIC_TRACING
+      PrimEigenvectors (v[i], state->a2[i], state->h[i], lambda, L, R);
+     #endif
+
+  /* ------------------------------------
+      smooth zone: limit primitive
+      variables, skip the projection
+     ------------------------------------ */
+
+     #if CHAR_LIMITING_HYBRID == YES
+      if (smooth[i]){
+        for (nv = NVAR; nv--; ){
+          vp[i][nv] = v[i][nv] + 0.5*dvp[nv]*LimO3Func(dvp[nv], dvm[nv], dx[i]);
+          vm[i][nv] = v[i][nv] - 0.5*dvm[nv]*LimO3Func(dvm[nv], dvp[nv], dx[i]);
+        }
+        continue;
+      }
+     #endif
+    
      #if SHOCK_FLATTENING == MULTID    
       if (state->flag[i] & FLAG_MINMOD){  
         for (nv = NVAR; nv--;    ) {
@@ -121,6 +143,17 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
       }
      #endif
 
+  /* -------------------------------
+      project undivided differences 
+      onto characteristic space
+     ------------------------------- */
+     
+     #if TIME_STEPPING != CHARACTERISTIC_TRACING
+      PrimEigenvectors (v[i], state->a2[i], state->h[i], lambda, L, R);
+     #endif
+     PrimToChar(L, dvp, dwp);
+     PrimToChar(L, dvm, dwm);
+
   /* -----------------------------
       limit undivided differences
      ----------------------------- */
@@ -129,17 +162,14 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
        dwp_lim[k] = dwp[k]*LimO3Func(dwp[k], dwm[k], dx[i]);
        dwm_lim[k] = dwm[k]*LimO3Func(dwm[k], dwp[k], dx[i]);
      }
+     CharToPrim (R, dwp_lim, dvpc);
+     CharToPrim (R, dwm_lim, dvmc);
      for (nv = NFLX; nv--;   ){
-       dvpR = dvmR = 0.0;
        #ifdef STAGGERED_MHD
         if (nv == BXn) continue;
        #endif
-       for (k = NFLX; k--; ){
-         dvpR += dwp_lim[k]*R[nv][k];
-         dvmR += dwm_lim[k]*R[nv][k];
-       }
-       vp[i][nv] = v[i][nv] + 0.5*dvpR;
-       vm[i][nv] = v[i][nv] - 0.5*dvmR;
+       vp[i][nv] = v[i][nv] + 0.5*dvpc[nv];
+       vm[i][nv] = v[i][nv] - 0.5*dvmc[nv];
      }
 
   /* -------------------------------------- 
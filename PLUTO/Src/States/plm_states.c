@@ -27,6 +27,11 @@
   Otherwise the same limiter can be imposed to all variables from 
   definitions.h.
 
+  With <tt> CHAR_LIMITING_HYBRID == YES </tt>, characteristic limiting 
+  is used only in zones where FlagSmoothZones() detects a jump inside 
+  the stencil. Smooth zones are limited in primitive variables and the
+  characteristic projection is skipped.
+
   The approach followed here is taken from Mignone (JCP, 2014) "High-order 
   conservative reconstruction schemes for finite volume methods in cylindrical
   and spherical geometries" where interface states are constructed as
@@ -72,6 +77,9 @@
 #include "pluto.h"
 
 static void MonotonicityTest(double **, double **, double **, int, int);
+#if CHAR_LIMITING == NO || CHAR_LIMITING_HYBRID == YES
+static void PrimitiveLimiter(double *, double *, double, double, double *);
+#endif
 
 #if CHAR_LIMITING == NO
 static void FourthOrderLinear(const State_1D *, int, int, Grid *);
@@ -181,53 +189,17 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
 #endif    
 
   /* ---------------------------------------------------------
-     2c. DEFAULT limiting: combination of different limiters
-        (this has some hystorical reasons)
+     2c. Limit slopes and construct (+) and (-) states
      --------------------------------------------------------- */
 
-    #if LIMITER == DEFAULT
-     SET_MC_LIMITER(dv_lim[RHO], dvp[RHO], dvm[RHO], cp, cm);
-     #if PHYSICS != ADVECTION
-      EXPAND(SET_VL_LIMITER(dv_lim[VX1], dvp[VX1], dvm[VX1], cp, cm);  ,
-             SET_VL_LIMITER(dv_lim[VX2], dvp[VX2], dvm[VX2], cp, cm);  ,
-             SET_VL_LIMITER(dv_lim[VX3], dvp[VX3], dvm[VX3], cp, cm);)
-     #endif
-
-     #if PHYSICS == MHD || PHYSICS == RMHD
-      EXPAND(SET_VL_LIMITER(dv_lim[BX1], dvp[BX1], dvm[BX1], cp, cm);  ,
-             SET_VL_LIMITER(dv_lim[BX2], dvp[BX2], dvm[BX2], cp, cm);  ,
-             SET_VL_LIMITER(dv_lim[BX3], dvp[BX3], dvm[BX3], cp, cm);)
-      #ifdef GLM_MHD
-       SET_MC_LIMITER(dv_lim[PSI_GLM], dvp[PSI_GLM], dvm[PSI_GLM], cp, cm);
-      #endif
-     #endif
-
-     #if HAVE_ENERGY
-      SET_MM_LIMITER(dv_lim[PRS], dvp[PRS], dvm[PRS], cp, cm);
-     #endif
- 
-     #if NFLX != NVAR /* -- scalars: MC lim  -- */
-      for (nv = NFLX; nv < NVAR; nv++){
-        SET_MC_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
-      }
-     #endif
-    #endif /* LIMITER == DEFAULT */
-
-  /* ----------------------------------------
-     2d. construct (+) and (-) states
-     ---------------------------------------- */
-
+    PrimitiveLimiter (dvp, dvm, cp, cm, dv_lim);
     for (nv = 0; nv < NVAR; nv++){
-      #if LIMITER != DEFAULT  /* -- same limiter for all variables -- */
-       SET_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
-      #endif
-
       vp[i][nv] = v[i][nv] + dv_lim[nv]*dp;
       vm[i][nv] = v[i][nv] - dv_lim[nv]*dm;
     }
 
   /* --------------------------------------
-      2e.  Relativistic Limiter
+      2d.  Relativistic Limiter
      -------------------------------------- */
 
     #if (PHYSICS == RHD || PHYSICS == RMHD) 
@@ -445,13 +417,16 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
   int    i, j, k, nv;
   double dvp[NVAR], dvm[NVAR], dv_lim[NVAR], dvc[NVAR], d2v;
   double dw_lim[NVAR], dwp[NVAR], dwm[NVAR];
-  double dp, dm, dc;
+  double dp, dm;
   double **vp, **vm, **v;
   double **L, **R, *lambda;
   double cp, cm, wp, wm, cpk[NVAR], cmk[NVAR];
   double kstp[NVAR];
   PLM_Coeffs plm_coeffs;
   static double **dv;
+  #if CHAR_LIMITING_HYBRID == YES
+   static unsigned char *smooth;
+  #endif
 
 /* ---------------------------------------------
    0. Allocate memory and set pointer shortcuts
@@ -459,6 +434,9 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
 
   if (dv == NULL) {
     dv = ARRAY_2D(NMAX_POINT, NVAR, double);
+    #if CHAR_LIMITING_HYBRID == YES
+     smooth = ARRAY_1D(NMAX_POINT, unsigned char);
+    #endif
   }
 
   v  = state->v; 
@@ -485,6 +463,10 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
     NVAR_LOOP(nv) dv[i][nv] = v[i+1][nv] - v[i][nv];
   }
 
+  #if CHAR_LIMITING_HYBRID == YES
+   FlagSmoothZones (state, beg, end, 1, smooth);
+  #endif
+
 /* --------------------------------------------------------------
     Set the amount of steepening for each characteristic family.
     Default is 2, but nonlinear fields may be safely set to 1
@@ -511,6 +493,11 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
     R      = state->Rp[i];
     lambda = state->lambda[i];
 
+  /* -- eigenvectors are still needed in smooth zones for tracing -- */
+
+    #if CHAR_LIMITING_HYBRID == YES && TIME_STEPPING != CHARACTERISTIC_TRACING
+     if (!smooth[i])
+    #endif
     PrimEigenvectors(v[i], state->a2[i], state->h[i], lambda, L, R);
 
   /* ---------------------------------------------------------------
@@ -546,6 +533,22 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
      }
     #endif
 
+  /* -- smooth zone: limit primitive variables and skip projection -- */
+
+    #if CHAR_LIMITING_HYBRID == YES
+     if (smooth[i]){
+       PrimitiveLimiter (dvp, dvm, cp, cm, dv_lim);
+       for (nv = NVAR; nv--;   ) {
+         vp[i][nv] = v[i][nv] + dv_lim[nv]*dp;
+         vm[i][nv] = v[i][nv] - dv_lim[nv]*dm;
+       }
+       #if (PHYSICS == RHD || PHYSICS == RMHD)
+        VelocityLimiter (v[i], vp[i], vm[i]);
+       #endif
+       continue;
+     }
+    #endif
+
     PrimToChar(L, dvm, dwm);
     PrimToChar(L, dvp, dwp);
 
@@ -578,13 +581,11 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
          Also, enforce monotonicity in primitive variables as well.
      ------------------------------------------------------------------ */
 
+    CharToPrim (R, dw_lim, dvc);
     for (nv = NFLX; nv--;   ){
-      dc = 0.0;
-      for (k = 0; k < NFLX; k++) dc += dw_lim[k]*R[nv][k];
-
       if (dvp[nv]*dvm[nv] > 0.0){
         d2v        = ABS_MIN(cp*dvp[nv], cm*dvm[nv]);
-        dv_lim[nv] = MINMOD(d2v, dc);
+        dv_lim[nv] = MINMOD(d2v, dvc[nv]);
       }else dv_lim[nv] = 0.0;
     }
 
@@ -675,6 +676,55 @@ void States (const State_1D *state, int beg, int end,  Grid *grid)
 #endif  /* CHAR_LIMITING == YES */
 
 
+#if CHAR_LIMITING == NO || CHAR_LIMITING_HYBRID == YES
+/* ********************************************************************* */
+void PrimitiveLimiter(double *dvp, double *dvm, double cp, double cm,
+                      double *dv_lim)
+/*!
+ * Compute limited slopes of primitive variables from the forward 
+ * (dvp) and backward (dvm) differences.
+ * The DEFAULT setting applies a combination of different limiters 
+ * (this has some hystorical reasons), otherwise the same limiter 
+ * is used for all variables.
+ *
+ *********************************************************************** */
+{
+  int nv;
+
+  #if LIMITER == DEFAULT
+   SET_MC_LIMITER(dv_lim[RHO], dvp[RHO], dvm[RHO], cp, cm);
+   #if PHYSICS != ADVECTION
+    EXPAND(SET_VL_LIMITER(dv_lim[VX1], dvp[VX1], dvm[VX1], cp, cm);  ,
+           SET_VL_LIMITER(dv_lim[VX2], dvp[VX2], dvm[VX2], cp, cm);  ,
+           SET_VL_LIMITER(dv_lim[VX3], dvp[VX3], dvm[VX3], cp, cm);)
+   #endif
+
+   #if PHYSICS == MHD || PHYSICS == RMHD
+    EXPAND(SET_VL_LIMITER(dv_lim[BX1], dvp[BX1], dvm[BX1], cp, cm);  ,
+           SET_VL_LIMITER(dv_lim[BX2], dvp[BX2], dvm[BX2], cp, cm);  ,
+           SET_VL_LIMITER(dv_lim[BX3], dvp[BX3], dvm[BX3], cp, cm);)
+    #ifdef GLM_MHD
+     SET_MC_LIMITER(dv_lim[PSI_GLM], dvp[PSI_GLM], dvm[PSI_GLM], cp, cm);
+    #endif
+   #endif
+
+   #if HAVE_ENERGY
+    SET_MM_LIMITER(dv_lim[PRS], dvp[PRS], dvm[PRS], cp, cm);
+   #endif
+ 
+   #if NFLX != NVAR /* -- scalars: MC lim  -- */
+    for (nv = NFLX; nv < NVAR; nv++){
+      SET_MC_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
+    }
+   #endif
+  #else  /* -- same limiter for all variables -- */
+   for (nv = 0; nv < NVAR; nv++){
+     SET_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
+   }
+  #endif
+}
+#endif
+
 /* ********************************************************************* */
 void MonotonicityTest(double **v, double **vp, double **vm, int beg, int end)
 /*
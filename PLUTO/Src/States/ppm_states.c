@@ -44,6 +44,9 @@
   in characteristic variables (<tt>PRIMITIVE_LIM == 0</tt>), 
   primitive (<tt>PRIMITIVE_LIM == 1</tt>) or both 
   (<tt>PRIMITIVE_LIM == 2</tt>).
+  With <tt> CHAR_LIMITING_HYBRID == YES </tt> this is done only in 
+  zones where FlagSmoothZones() detects a jump inside the stencil, 
+  while smooth zones are limited in primitive variables.
   
   
   \author A. Mignone (mignone@ph.unito.it)
@@ -268,6 +271,9 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
   double dv,  **v, **L, **R, *lambda;
   double tau, a0, a1, w0, w1;
   static double  **dvF, **vppm4;
+  #if CHAR_LIMITING_HYBRID == YES
+   static unsigned char *smooth;
+  #endif
   PPM_Coeffs ppm_coeffs;
   PLM_Coeffs plm_coeffs;
 
@@ -279,6 +285,9 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
   if (dvF == NULL){
     dvF   = ARRAY_2D(NMAX_POINT, NVAR, double);
     vppm4 = ARRAY_2D(NMAX_POINT,NVAR,double);
+    #if CHAR_LIMITING_HYBRID == YES
+     smooth = ARRAY_1D(NMAX_POINT, unsigned char);
+    #endif
   } 
   v  = state->v;
   vp = state->vp;
@@ -326,6 +335,10 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
     } 
   }
 
+  #if CHAR_LIMITING_HYBRID == YES
+   FlagSmoothZones (state, beg, end, 2, smooth);
+  #endif
+
 /* --------------------------------------------------------------
    2. Begin main spatial loop
    -------------------------------------------------------------- */
@@ -344,9 +357,13 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
     R      = state->Rp[i];
     lambda = state->lambda[i];
 
-    PrimEigenvectors(v[i], state->a2[i], state->h[i], lambda, L, R);
-    #if NVAR != NFLX
-     for (k = NFLX; k < NVAR; k++) lambda[k] = v[i][VXn]; 
+  /* -- tracing needs eigenvectors in every zone -- */
+
+    #if TIME_STEPPING == CHARACTERISTIC_TRACING
+     PrimEigenvectors(v[i], state->a2[i], state->h[i], lambda, L, R);
+     #if NVAR != NFLX
+      for (k = NFLX; k < NVAR; k++) lambda[k] = v[i][VXn]; 
+     #endif
     #endif
 
 #if SHOCK_FLATTENING == MULTID    
@@ -365,11 +382,44 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
     }
 #endif  /* SHOCK_FLATTENING == MULTID */
 
+  /* ------------------------------------------------------------------
+     Smooth zone: apply limiters in primitive variables and 
+     skip the characteristic projection.
+     ------------------------------------------------------------------ */
+
+    #if CHAR_LIMITING_HYBRID == YES && RECONSTRUCTION == PARABOLIC
+     if (smooth[i]){
+       cm = (hm[i] + 1.0)/(hp[i] - 1.0);
+       cp = (hp[i] + 1.0)/(hm[i] - 1.0);
+       VAR_LOOP(nv){
+         dp = MINMOD(vppm4[i][nv]   - v[i][nv],  dvF[i][nv]);
+         dm = MINMOD(vppm4[i-1][nv] - v[i][nv], -dvF[i-1][nv]);
+         if (dp*dm >= 0.0) dp = dm = 0.0;
+         else{
+           if      (fabs(dp) >= cm*fabs(dm)) dp = -cm*dm;
+           else if (fabs(dm) >= cp*fabs(dp)) dm = -cp*dp;
+         }
+         vp[i][nv] = v[i][nv] + dp;
+         vm[i][nv] = v[i][nv] + dm;
+       }
+       #if PHYSICS == RHD || PHYSICS == RMHD
+        VelocityLimiter (v[i], vp[i], vm[i]);
+       #endif
+       continue;
+     }
+    #endif
+
   /* ------------------------------------------------------------------
      2a. Project unlimited increments (vp - v) and (vm - v) 
          along characteristics and apply limiter.
+         Eigenvectors are computed only here, where the projection
+         is actually needed.
      ------------------------------------------------------------------ */
 
+    #if TIME_STEPPING != CHARACTERISTIC_TRACING
+     PrimEigenvectors(v[i], state->a2[i], state->h[i], lambda, L, R);
+    #endif
+
     #if RECONSTRUCTION == WENO3
 
    /* -- compute undivided differences and 
@@ -441,15 +491,8 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
          dv = \sum dw.R
      ------------------------------------------------------------------- */
 
-    for (nv = 0; nv < NFLX; nv++) {
-      dp = dm = 0.0;
-      for (k = 0; k < NFLX; k++){
-        dp += dwp[k]*R[nv][k];
-        dm += dwm[k]*R[nv][k];
-      }
-      dvp[nv] = dp;
-      dvm[nv] = dm;
-    }
+    CharToPrim (R, dwp, dvp);
+    CharToPrim (R, dwm, dvm);
     #if NVAR != NFLX
      for (nv = NFLX; nv < NVAR; nv++){
        dvp[nv] = dwp[nv];
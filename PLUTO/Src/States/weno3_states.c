@@ -28,9 +28,12 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
   double b1, S1, wm;
   double dwp[NVAR], dwp_lim[NVAR];
   double dwm[NVAR], dwm_lim[NVAR];
-  double dvpR, dvmR;
+  double dvpc[NVAR], dvmc[NVAR];
   static double **Rg, **Lg, **Pg, **Mg; /* -- interpolation coeffs -- */
   static double **dv;
+  #if CHAR_LIMITING == YES && CHAR_LIMITING_HYBRID == YES
+   static unsigned char *smooth;
+  #endif
 
 /* -----------------------------------------------------
    0. Allocate memory and set pointer shortcuts
@@ -38,6 +41,9 @@ void States (const State_1D *state, int beg, int end, Grid *grid)
    
   if (dv == NULL) {
     dv = ARRAY_2D(NMAX_POINT, NVAR, double);
+    #if CHAR_LIMITING == YES && CHAR_LIMITING_HYBRID == YES
+     smooth = ARRAY_1D(NMAX_POINT, unsigned char);
+    #endif
     Rg = ARRAY_2D(DIMENSIONS, NMAX_POINT, double);
     Lg = ARRAY_2D(DIMENSIONS, NMAX_POINT, double);
     Pg = ARRAY_2D(DIMENSIONS, NMAX_POINT, double);
@@ -117,6 +123,10 @@ S1 = 1.0/(b1 + 1.e-6)/(b1 + 1.e-6);
    i = beg-1;
    for (nv = NVAR; nv--;   ) dv[i][nv] = v[i+1][nv] - v[i][nv];
 
+   #if CHAR_LIMITING_HYBRID == YES
+    FlagSmoothZones (state, beg, end, 1, smooth);
+   #endif
+
    for (i = beg; i <= end; i++){
 
      NVAR_LOOP(nv) dv[i][nv] = v[i+1][nv] - v[i][nv];
@@ -126,16 +136,37 @@ S1 = 1.0/(b1 + 1.e-6)/(b1 + 1.e-6);
      lambda = state->lambda[i];
      dvp = dv[i];   
      dvm = dv[i-1];
-    
-  /* -------------------------------
-      project undivided differences 
-      onto characteristic space
-     ------------------------------- */
-     
-     PrimEigenvectors (v[i], state->a2[i], state->h[i], lambda, Lv, Rv);
-     PrimToChar(Lv, dvp, dwp);
-     PrimToChar(Lv, dvm, dwm);
 
+  /* -- tracing needs eigenvectors in every zone -- */
+
+     #if TIME_STEPPING == CHARACTERISTIC_TRACING
+      PrimEigenvectors (v[i], state->a2[i], state->h[i], lambda, Lv, Rv);
+     #endif
+
+  /* ------------------------------------
+      smooth zone: limit primitive
+      variables, skip the projection
+     ------------------------------------ */
+
+     #if CHAR_LIMITING_HYBRID == YES
+      if (smooth[i]){
+        dx2 = dx[i]*dx[i];
+        for (nv = 0; nv < NVAR; nv++){
+          b0  = dvp[nv]*dvp[nv] + dx2;
+          b1  = dvm[nv]*dvm[nv] + dx2;
+          tau = dvp[nv] - dvm[nv];
+          tau = tau*tau;
+          S0  = 1.0 + tau/b0;
+          S1  = 1.0 + tau/b1;
+          vp[i][nv] = v[i][nv] + (S0*R[i]*dvp[nv] + P[i]*S1*R[i-1]*dvm[nv])
+                                /(S0 + P[i]*S1);
+          vm[i][nv] = v[i][nv] - (M[i]*S0*L[i]*dvp[nv] + S1*L[i-1]*dvm[nv])
+                                /(M[i]*S0 + S1);
+        }
+        continue;
+      }
+     #endif
+    
      #if SHOCK_FLATTENING == MULTID    
       if (state->flag[i] & FLAG_MINMOD){  
         for (nv = NVAR; nv--;    ) {
@@ -147,6 +178,17 @@ S1 = 1.0/(b1 + 1.e-6)/(b1 + 1.e-6);
       }
      #endif
 
+  /* -------------------------------
+      project undivided differences 
+      onto characteristic space
+     ------------------------------- */
+     
+     #if TIME_STEPPING != CHARACTERISTIC_TRACING
+      PrimEigenvectors (v[i], state->a2[i], state->h[i], lambda, Lv, Rv);
+     #endif
+     PrimToChar(Lv, dvp, dwp);
+     PrimToChar(Lv, dvm, dwm);
+
      dx2 = dx[i]*dx[i];
      for (k = NVAR; k--; ){
        b0 = dwp[k]*dwp[k] + dx2;
@@ -166,17 +208,14 @@ S1 = 1.0/(b1 + 1.e-6)/(b1 + 1.e-6);
 */
 
      }
+     CharToPrim (Rv, dwp_lim, dvpc);
+     CharToPrim (Rv, dwm_lim, dvmc);
      for (nv = NFLX; nv--;   ){
-       dvpR = dvmR = 0.0;
        #ifdef STAGGERED_MHD
         if (nv == BXn) continue;
        #endif
-       for (k = NFLX; k--; ){
-         dvpR += dwp_lim[k]*Rv[nv][k];
-         dvmR += dwm_lim[k]*Rv[nv][k];
-       }
-       vp[i][nv] = v[i][nv] + dvpR;
-       vm[i][nv] = v[i][nv] - dvmR;
+       vp[i][nv] = v[i][nv] + dvpc[nv];
+       vm[i][nv] = v[i][nv] - dvmc[nv];
      }
 
   /* -------------------------------------------------- 
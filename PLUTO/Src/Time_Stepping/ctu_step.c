@@ -186,6 +186,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
 
   g_intStage = 1;
   Boundary (d, ALL_DIR, grid);
+  #if SELF_GRAVITY == YES
+   SelfGravitySolve (d, grid);
+  #endif
   #if (SHOCK_FLATTENING == MULTID) || (ENTROPY_SWITCH) 
    FlagShock (d, grid);
   #endif
@@ -614,6 +617,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
    FARGO_ShiftSolution (d->Uc, d->Vs, grid);
   #endif 
 
+  #ifdef GLM_MHD
+   glm_damping = GLM_Damping (GLM_DAMPING_DT, grid);
+  #endif
   ConsToPrim3D(d->Uc, d->Vc, d->flag, box);
 
   #ifdef FARGO
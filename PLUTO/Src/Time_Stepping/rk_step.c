@@ -74,6 +74,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
 
   g_intStage = 1;  
   Boundary (d, ALL_DIR, grid);
+#if SELF_GRAVITY == YES
+  SelfGravitySolve (d, grid);
+#endif
 #if (SHOCK_FLATTENING == MULTID) || (ENTROPY_SWITCH) 
   FlagShock (d, grid);
 #endif
@@ -91,6 +94,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
   UpdateStage(d, d->Uc, NULL, Riemann, g_dt, Dts, grid);
 #ifdef STAGGERED_MHD
   CT_AverageMagneticField (d->Vs, d->Uc, grid);
+#endif
+#if (defined GLM_MHD) && (TIME_STEPPING == EULER)
+  glm_damping = GLM_Damping (GLM_DAMPING_DT, grid);
 #endif
   ConsToPrim3D (d->Uc, d->Vc, d->flag, box);
 
@@ -102,6 +108,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
 
    g_intStage = 2;
    Boundary (d, ALL_DIR, grid);
+  #if SELF_GRAVITY == YES
+   SelfGravitySolve (d, grid);
+  #endif
 
 /* -- need an extra conversion if INTERNAL_BOUNDARY is enabled 
       [note: done only with dimensional splitting for backward compat.] -- */
@@ -124,6 +133,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
   #if (defined FARGO) && (TIME_STEPPING == RK2)
   FARGO_ShiftSolution (d->Uc, d->Vs, grid);
   #endif 
+  #if (defined GLM_MHD) && (TIME_STEPPING == RK2)
+  glm_damping = GLM_Damping (GLM_DAMPING_DT, grid);
+  #endif
   ConsToPrim3D (d->Uc, d->Vc, d->flag, box);
 
 #endif  /* TIME_STEPPING == RK2/RK3 */
@@ -135,6 +147,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
 #if TIME_STEPPING == RK3
   g_intStage = 3;
   Boundary (d, ALL_DIR, grid);
+  #if SELF_GRAVITY == YES
+  SelfGravitySolve (d, grid);
+  #endif
 
 /* -- need an extra conversion if INTERNAL_BOUNDARY is enabled -- */
 
@@ -156,6 +171,9 @@ int AdvanceStep (const Data *d, Riemann_Solver *Riemann,
   #ifdef FARGO
   FARGO_ShiftSolution (d->Uc, d->Vs, grid);
   #endif
+  #ifdef GLM_MHD
+  glm_damping = GLM_Damping (GLM_DAMPING_DT, grid);
+  #endif
   ConsToPrim3D (d->Uc, d->Vc, d->flag, box);
 #endif /* TIME_STEPPING == RK3 */
 
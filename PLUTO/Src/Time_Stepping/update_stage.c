@@ -22,6 +22,8 @@
   When the integrator stage is the first one (predictor), this function 
   also computes the maximum of inverse time steps for hyperbolic and 
   parabolic terms (if the latters are included explicitly).
+  The corresponding 3D maps can be retrieved with GetInverseTimeStep()
+  (e.g. to be written as user-defined output variables).
   
   \authors A. Mignone (mignone@ph.unito.it)\n
            C. Zanni   (zanni@oato.inaf.it)\n
@@ -31,8 +33,43 @@
 */
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
+
+/* ---------------------------------------------------------------
+    UPDATE_TILES enables the cache-blocked traversal of the
+    domain (default for 3D unsplit schemes).
+    It is turned off when a module needs complete pencils or
+    per-direction global arrays.
+   --------------------------------------------------------------- */
+
+#ifndef UPDATE_TILES
+ #if (DIMENSIONS == 3) && (DIMENSIONAL_SPLITTING == NO)
+  #define UPDATE_TILES  YES
+ #else
+  #define UPDATE_TILES  NO
+ #endif
+#endif
+
+#ifndef UPDATE_TILE_SIZE
+ #define UPDATE_TILE_SIZE  16  /* Number of interior zones per tile side */
+#endif
+
+#if (defined CHOMBO) || (defined SHEARINGBOX) || (DIMENSIONAL_SPLITTING == YES)
+ #undef  UPDATE_TILES
+ #define UPDATE_TILES  NO
+#endif
+#if (RESISTIVITY == EXPLICIT) && !(defined STAGGERED_MHD)
+ #undef  UPDATE_TILES
+ #define UPDATE_TILES  NO
+#endif
+
 static void SaveAMRFluxes (const State_1D *, double **, int, int, Grid *);
 static intList TimeStepIndexList();
+static void UpdatePencil (const Data *, Data_Arr, double **, Riemann_Solver *,
+                          double, Time_Step *, State_1D *, Index *,
+                          int, int, int, Grid *);
+
+static double ***T, ***C_dt[NVAR], **dcoeff;
+static intList cdt_list;
 
 /* ********************************************************************* */
 void UpdateStage(const Data *d, Data_Arr UU, double **aflux,
@@ -54,11 +91,8 @@ void UpdateStage(const Data *d, Data_Arr UU, double **aflux,
   int  i, j, k;
   int  nv, dir, beg_dir, end_dir;
   int  *ip;
-  double *inv_dl, dl2;
-  static double ***T, ***C_dt[NVAR], **dcoeff;
   static State_1D state;
   Index indx;
-  intList cdt_list;
 
   #if DIMENSIONAL_SPLITTING == YES
    beg_dir = end_dir = g_dir;
@@ -122,9 +156,88 @@ void UpdateStage(const Data *d, Data_Arr UU, double **aflux,
   #endif
 
 /* ----------------------------------------------------------------
-   3. Main loop on directions
+   3. Main loop on directions.
+      With UPDATE_TILES, the domain is traversed in 3D tiles and
+      all directions are swept on a tile before moving to the
+      next one, so that Vc and UU are reused from cache.
    ---------------------------------------------------------------- */
 
+#if UPDATE_TILES == YES
+  {
+    int  n, dir1, dir2, nt[3], tc[3], lo[3], hi[3];
+    int  rbeg[3], rend[3], dbeg[3], dend[3];
+    int  *t1, *t2;
+    static State_1D tstate[3];
+    Index tindx[3];
+
+  /* -- per-direction index ranges and states -- */
+
+    for (dir = beg_dir; dir <= end_dir; dir++){
+      g_dir = dir;
+      SetIndexes (&tindx[dir], grid);
+      if (tstate[dir].v == NULL) MakeState (&tstate[dir]);
+      ResetState (d, &tstate[dir], grid);
+    }
+
+    dbeg[IDIR] = IBEG; dend[IDIR] = IEND;
+    dbeg[JDIR] = JBEG; dend[JDIR] = JEND;
+    dbeg[KDIR] = KBEG; dend[KDIR] = KEND;
+    for (n = 0; n < 3; n++){
+      nt[n] = (dend[n] - dbeg[n])/UPDATE_TILE_SIZE + 1;
+    }
+
+    for (tc[KDIR] = 0; tc[KDIR] < nt[KDIR]; tc[KDIR]++){
+    for (tc[JDIR] = 0; tc[JDIR] < nt[JDIR]; tc[JDIR]++){
+    for (tc[IDIR] = 0; tc[IDIR] < nt[IDIR]; tc[IDIR]++){
+
+      for (n = 0; n < 3; n++){
+        lo[n] = dbeg[n] + tc[n]*UPDATE_TILE_SIZE;
+        hi[n] = MIN(lo[n] + UPDATE_TILE_SIZE - 1, dend[n]);
+      }
+
+      for (dir = beg_dir; dir <= end_dir; dir++){
+        g_dir = dir;
+        indx = tindx[dir];
+
+      /* ----------------------------------------------------
+          Tiles touching the edges of the domain inherit
+          the (possibly extended) index range of the sweep.
+         ---------------------------------------------------- */
+
+        for (n = 0; n < 3; n++){
+          rbeg[n] = lo[n];
+          rend[n] = hi[n];
+        }
+        dir1 = (dir == IDIR ? JDIR:IDIR);
+        dir2 = (dir == KDIR ? JDIR:KDIR);
+        t1   = (dir1 == IDIR ? &i:&j);
+        t2   = (dir2 == JDIR ? &j:&k);
+        if (lo[dir]  == dbeg[dir])  rbeg[dir]  = indx.beg;
+        if (hi[dir]  == dend[dir])  rend[dir]  = indx.end;
+        if (lo[dir1] == dbeg[dir1]) rbeg[dir1] = indx.t1_beg;
+        if (hi[dir1] == dend[dir1]) rend[dir1] = indx.t1_end;
+        if (lo[dir2] == dbeg[dir2]) rbeg[dir2] = indx.t2_beg;
+        if (hi[dir2] == dend[dir2]) rend[dir2] = indx.t2_end;
+
+        indx.beg = rbeg[dir];
+        indx.end = rend[dir];
+        for (*t2 = rbeg[dir2]; *t2 <= rend[dir2]; (*t2)++){
+        for (*t1 = rbeg[dir1]; *t1 <= rend[dir1]; (*t1)++){
+          UpdatePencil (d, UU, aflux, Riemann, dt, Dts, &tstate[dir],
+                        &indx, i, j, k, grid);
+        }}
+      }
+    }}}
+
+  /* -- EMF ranges must span the whole sweep, not the last tile -- */
+
+    #ifdef STAGGERED_MHD
+     for (dir = beg_dir; dir <= end_dir; dir++){
+       CT_SetEMFRange (dir, tindx[dir].beg - 1, tindx[dir].end);
+     }
+    #endif
+  }
+#else
   for (dir = beg_dir; dir <= end_dir; dir++){
 
     g_dir = dir;  
@@ -136,78 +249,11 @@ void UpdateStage(const Data *d, Data_Arr UU, double **aflux,
     #endif
 
     TRANSVERSE_LOOP(indx,ip,i,j,k){
-      g_i = i;  g_j = j;  g_k = k;
-      for ((*ip) = 0; (*ip) < indx.ntot; (*ip)++) {
-        VAR_LOOP(nv) state.v[(*ip)][nv] = d->Vc[nv][k][j][i];
-        state.flag[*ip] = d->flag[k][j][i];
-        #ifdef STAGGERED_MHD
-         state.bn[(*ip)] = d->Vs[g_dir][k][j][i];
-        #endif
-      }
-      CheckNaN (state.v, 0, indx.ntot-1,0);
-      States  (&state, indx.beg - 1, indx.end + 1, grid); 
-      Riemann (&state, indx.beg - 1, indx.end, Dts->cmax, grid);
-      #ifdef STAGGERED_MHD
-       CT_StoreEMF (&state, indx.beg - 1, indx.end, grid);
-      #endif
-      #if (PARABOLIC_FLUX & EXPLICIT)
-       ParabolicFlux(d->Vc, d->J, T, &state, dcoeff, indx.beg-1, indx.end, grid);
-      #endif
-      #if UPDATE_VECTOR_POTENTIAL == YES
-       VectorPotentialUpdate (d, NULL, &state, grid);
-      #endif
-      #ifdef SHEARINGBOX
-       SB_SaveFluxes (&state, grid);
-      #endif
-      RightHandSide (&state, Dts, indx.beg, indx.end, dt, grid);
-
-    /* -- update:  U = U + dt*R -- */
-
-      #ifdef CHOMBO
-       for ((*ip) = indx.beg; (*ip) <= indx.end; (*ip)++) { 
-         VAR_LOOP(nv) UU[nv][k][j][i] += state.rhs[*ip][nv];
-       }
-       SaveAMRFluxes (&state, aflux, indx.beg-1, indx.end, grid);
-      #else
-       for ((*ip) = indx.beg; (*ip) <= indx.end; (*ip)++) { 
-         VAR_LOOP(nv) UU[k][j][i][nv] += state.rhs[*ip][nv];
-       }
-      #endif
-
-      if (g_intStage > 1) continue;
-
-    /* -- compute inverse dt coefficients when g_intStage = 1 -- */
-
-      inv_dl = GetInverse_dl(grid);
-      for ((*ip) = indx.beg; (*ip) <= indx.end; (*ip)++) { 
-        #if DIMENSIONAL_SPLITTING == NO
-
-         #if !GET_MAX_DT
-          C_dt[0][k][j][i] += 0.5*(  Dts->cmax[(*ip)-1] 
-                                   + Dts->cmax[*ip])*inv_dl[*ip];
-         #endif
-         #if (PARABOLIC_FLUX & EXPLICIT)
-          dl2 = 0.5*inv_dl[*ip]*inv_dl[*ip];
-          FOR_EACH(nv, 1, (&cdt_list)) {  
-            C_dt[nv][k][j][i] += (dcoeff[*ip][nv]+dcoeff[(*ip)-1][nv])*dl2;
-          }
-         #endif
-
-        #elif DIMENSIONAL_SPLITTING == YES
-
-         #if !GET_MAX_DT
-          Dts->inv_dta = MAX(Dts->inv_dta, Dts->cmax[*ip]*inv_dl[*ip]);
-         #endif
-         #if (PARABOLIC_FLUX & EXPLICIT)
-          dl2 = inv_dl[*ip]*inv_dl[*ip];
-          FOR_EACH(nv, 1, (&cdt_list)) {
-            Dts->inv_dtp = MAX(Dts->inv_dtp, dcoeff[*ip][nv]*dl2);
-          }
-         #endif
-        #endif 
-      }
+      UpdatePencil (d, UU, aflux, Riemann, dt, Dts, &state, &indx,
+                    i, j, k, grid);
     }
   }
+#endif
 
 /* -------------------------------------------------------------------
    4. Additional terms here
@@ -257,6 +303,110 @@ void UpdateStage(const Data *d, Data_Arr UU, double **aflux,
 
 }
 
+/* ********************************************************************* */
+void UpdatePencil (const Data *d, Data_Arr UU, double **aflux,
+                   Riemann_Solver *Riemann, double dt, Time_Step *Dts,
+                   State_1D *state, Index *indx, int i, int j, int k,
+                   Grid *grid)
+/*!
+ * Reconstruct, solve and update a single pencil in the direction given
+ * by ::g_dir, between the indices <tt> indx->beg </tt> and 
+ * <tt> indx->end </tt>.
+ * Only the zones needed by the reconstruction stencil are copied 
+ * into the state structure, so that the pencil may also be a segment
+ * (as with UPDATE_TILES).
+ *
+ * \param [in]  i,j,k  the pencil transverse indices (the one 
+ *                     corresponding to ::g_dir is ignored)
+ *
+ *********************************************************************** */
+{
+  int    nv, *ip, vbeg, vend, ngh;
+  double *inv_dl, dl2;
+
+  if (g_dir == IDIR) ip = &i;
+  if (g_dir == JDIR) ip = &j;
+  if (g_dir == KDIR) ip = &k;
+
+  ngh  = grid[g_dir].nghost;
+  vbeg = MAX(indx->beg - ngh, 0);
+  vend = MIN(indx->end + ngh, indx->ntot - 1);
+
+  g_i = i;  g_j = j;  g_k = k;
+  for ((*ip) = vbeg; (*ip) <= vend; (*ip)++) {
+    VAR_LOOP(nv) state->v[(*ip)][nv] = d->Vc[nv][k][j][i];
+    state->flag[*ip] = d->flag[k][j][i];
+    #ifdef STAGGERED_MHD
+     state->bn[(*ip)] = d->Vs[g_dir][k][j][i];
+    #endif
+  }
+  CheckNaN (state->v, vbeg, vend, 0);
+  States  (state, indx->beg - 1, indx->end + 1, grid); 
+  Riemann (state, indx->beg - 1, indx->end, Dts->cmax, grid);
+  #ifdef STAGGERED_MHD
+   CT_StoreEMF (state, indx->beg - 1, indx->end, grid);
+  #endif
+  #if (PARABOLIC_FLUX & EXPLICIT)
+   ParabolicFlux(d->Vc, d->J, T, state, dcoeff, indx->beg-1, indx->end, grid);
+  #endif
+  #if UPDATE_VECTOR_POTENTIAL == YES
+   VectorPotentialUpdate (d, NULL, state, grid);
+  #endif
+  #ifdef SHEARINGBOX
+   SB_SaveFluxes (state, grid);
+  #endif
+  RightHandSide (state, Dts, indx->beg, indx->end, dt, grid);
+  #if NESTED_LEVELS > 0
+   Nested_StoreFlux (state, indx->beg, indx->end, i, j, k, grid);
+  #endif
+
+/* -- update:  U = U + dt*R -- */
+
+  #ifdef CHOMBO
+   for ((*ip) = indx->beg; (*ip) <= indx->end; (*ip)++) { 
+     VAR_LOOP(nv) UU[nv][k][j][i] += state->rhs[*ip][nv];
+   }
+   SaveAMRFluxes (state, aflux, indx->beg-1, indx->end, grid);
+  #else
+   for ((*ip) = indx->beg; (*ip) <= indx->end; (*ip)++) { 
+     VAR_LOOP(nv) UU[k][j][i][nv] += state->rhs[*ip][nv];
+   }
+  #endif
+
+  if (g_intStage > 1) return;
+
+/* -- compute inverse dt coefficients when g_intStage = 1 -- */
+
+  inv_dl = GetInverse_dl(grid);
+  for ((*ip) = indx->beg; (*ip) <= indx->end; (*ip)++) { 
+    #if DIMENSIONAL_SPLITTING == NO
+
+     #if !GET_MAX_DT
+      C_dt[0][k][j][i] += 0.5*(  Dts->cmax[(*ip)-1] 
+                               + Dts->cmax[*ip])*inv_dl[*ip];
+     #endif
+     #if (PARABOLIC_FLUX & EXPLICIT)
+      dl2 = 0.5*inv_dl[*ip]*inv_dl[*ip];
+      FOR_EACH(nv, 1, (&cdt_list)) {  
+        C_dt[nv][k][j][i] += (dcoeff[*ip][nv]+dcoeff[(*ip)-1][nv])*dl2;
+      }
+     #endif
+
+    #elif DIMENSIONAL_SPLITTING == YES
+
+     #if !GET_MAX_DT
+      Dts->inv_dta = MAX(Dts->inv_dta, Dts->cmax[*ip]*inv_dl[*ip]);
+     #endif
+     #if (PARABOLIC_FLUX & EXPLICIT)
+      dl2 = inv_dl[*ip]*inv_dl[*ip];
+      FOR_EACH(nv, 1, (&cdt_list)) {
+        Dts->inv_dtp = MAX(Dts->inv_dtp, dcoeff[*ip][nv]*dl2);
+      }
+     #endif
+    #endif 
+  }
+}
+
 #ifdef CHOMBO
 /* ********************************************************************* */
 void SaveAMRFluxes (const State_1D *state, double **aflux, 
@@ -452,6 +602,31 @@ void SaveAMRFluxes (const State_1D *state, double **aflux,
 }
 #endif
 
+/* ********************************************************************* */
+double ***GetInverseTimeStep (int nv)
+/*!
+ * Return the 3D array of inverse time steps computed during the 
+ * predictor stage of the last integration step, summed over 
+ * directions: \c nv = ::RHO gives the advection map, while 
+ * \c nv = ::MX1, ::BX1...::BX3 or ::ENG give the (explicit) 
+ * viscous, resistive or thermal conduction maps.
+ * Values are available in the computational domain only.
+ *
+ * \return A pointer to the 3D array or \c NULL if the map has not 
+ *         been computed (dimensionally split schemes, CTU or no 
+ *         step taken yet).
+ *
+ *********************************************************************** */
+{
+  #if DIMENSIONAL_SPLITTING == NO
+   #if GET_MAX_DT
+    if (nv == RHO) return NULL;
+   #endif
+   if (nv >= 0 && nv < NVAR) return C_dt[nv];
+  #endif
+  return NULL;
+}
+
 /* ********************************************************************* */
 intList TimeStepIndexList()
 /*!
@@ -57,6 +57,10 @@ void Boundary (const Data *d, int idim, Grid *grid)
   int  type[6], sbeg, send, vsign[NVAR];
   int  par_dim[3] = {0, 0, 0};
   double ***q;
+  #ifdef PARALLEL
+   int  al_sz[NVAR + 3];
+   char *al_buf[NVAR + 3];
+  #endif
 
 /* ---------------------------------------------------
     Check the number of processors in each direction
@@ -82,11 +86,23 @@ void Boundary (const Data *d, int idim, Grid *grid)
    #endif
 
 /* -------------------------------------------------
-    Call userdef internal boundary with side == 0
+    Call userdef internal boundary with side == 0.
+    A static internal boundary is declared by the 
+    first call only and then re-imposed from the 
+    stored spans.
    -------------------------------------------------  */
 
   #if INTERNAL_BOUNDARY == YES
-   UserDefBoundary (d, NULL, 0, grid);
+   #if INTERNAL_BOUNDARY_STATIC == YES
+    if (InternalBoundaryIsSet (grid)) {
+      InternalBoundaryImpose (d, grid);
+    }else{
+      UserDefBoundary (d, NULL, 0, grid);
+      InternalBoundaryStore (d, grid);
+    }
+   #else
+    UserDefBoundary (d, NULL, 0, grid);
+   #endif
   #endif
   
 /* -------------------------------------
@@ -94,17 +110,25 @@ void Boundary (const Data *d, int idim, Grid *grid)
    ------------------------------------- */
    
   #ifdef PARALLEL
-   MPI_Barrier (MPI_COMM_WORLD);
    for (nv = 0; nv < NVAR; nv++) {
-     AL_Exchange_dim ((char *)d->Vc[nv][0][0], par_dim, SZ);
+     al_buf[nv] = (char *)d->Vc[nv][0][0];
+     al_sz[nv]  = SZ;
    }
    #ifdef STAGGERED_MHD 
     D_EXPAND(
-      AL_Exchange_dim ((char *)(d->Vs[BX1s][0][0] - 1), par_dim, SZ_stagx);  ,
-      AL_Exchange_dim ((char *)d->Vs[BX2s][0][-1]     , par_dim, SZ_stagy);  ,
-      AL_Exchange_dim ((char *)d->Vs[BX3s][-1][0]     , par_dim, SZ_stagz);)
+      al_buf[NVAR]     = (char *)(d->Vs[BX1s][0][0] - 1);
+      al_sz[NVAR]      = SZ_stagx;                          ,
+      al_buf[NVAR + 1] = (char *)d->Vs[BX2s][0][-1];
+      al_sz[NVAR + 1]  = SZ_stagy;                          ,
+      al_buf[NVAR + 2] = (char *)d->Vs[BX3s][-1][0];
+      al_sz[NVAR + 2]  = SZ_stagz;)
+    nv = NVAR + DIMENSIONS;
    #endif
-   MPI_Barrier (MPI_COMM_WORLD);
+
+  /* -- cell-centered and staggered fields travel in the
+        same message (one per neighbour and direction) -- */
+
+   AL_Exchange_dim_list (al_buf, al_sz, nv, par_dim);
   #endif
 
 /* ----------------------------------------------------------------
@@ -269,6 +293,15 @@ void Boundary (const Data *d, int idim, Grid *grid)
     }
   }
 
+/* --------------------------------------------------
+    On refined levels, fill ghost zones on coarse-fine
+    sides by interpolation of the parent level.
+   -------------------------------------------------- */
+
+  #if NESTED_LEVELS > 0
+   Nested_Boundary (d, grid);
+  #endif
+
 /* --------------------------------------------------
     With FARGO, restore velocity deviation if the 
     original input array to Boundary() did not 
@@ -37,6 +37,7 @@ void ParseCmdLineArgs (int argc, char *argv[], char *ini_file,
    ----------------------------------------------- */
 
   cmd->restart   = NO;
+  cmd->active    = NO;
   cmd->h5restart = NO;
   cmd->maxsteps  = 0 ;
   cmd->write     = YES;
@@ -65,7 +66,11 @@ void ParseCmdLineArgs (int argc, char *argv[], char *ini_file,
 
   for (i = 1; i < argc ; i++){
 
-    if (!strcmp(argv[i],"-dec")) {
+    if (!strcmp(argv[i],"-active-domain")) {
+
+      cmd->active = YES;
+
+    }else if (!strcmp(argv[i],"-dec")) {
 
     /* -- start reading integers at i+1 -- */
 
@@ -199,6 +204,32 @@ void ParseCmdLineArgs (int argc, char *argv[], char *ini_file,
   else if (cmd->jet == JDIR) cmd->parallel_dim[JDIR] = NO;
   else if (cmd->jet == KDIR) cmd->parallel_dim[KDIR] = NO;
 
+/* -- -active-domain changes the integration range in all
+      directions and cannot be combined with -xnjet, with modules
+      that rely on the full local domain or with source terms that
+      change a uniform state (zones outside the active box are
+      frozen) -- */
+
+  if (cmd->active){
+    if (cmd->jet != -1){
+      if (prank == 0) printf ("! -active-domain cannot be used with -xnjet\n");
+      QUIT_PLUTO(1);
+    }
+    #if (NESTED_LEVELS > 0) || (defined FARGO) || (defined SHEARINGBOX)
+     if (prank == 0) {
+       printf ("! -active-domain cannot be used with nested grids,\n");
+       printf ("  FARGO or the shearing box\n");
+     }
+     QUIT_PLUTO(1);
+    #endif
+    #if (COOLING != NO) || (BODY_FORCE != NO) || (ROTATING_FRAME == YES)
+     if (prank == 0) {
+       printf ("! -active-domain cannot be used with cooling, body forces\n");
+       printf ("  or a rotating frame\n");
+     }
+     QUIT_PLUTO(1);
+    #endif
+  }
 }
 /* ******************************************************************* */
 void PrintUsage()
@@ -214,6 +245,13 @@ void PrintUsage()
   printf ("           or \n\n");
   printf ("       mpirun -np NP ./pluto [options]\n\n");
   printf ("[options] are:\n\n");
+  printf (" -active-domain\n");
+  printf ("    Restrict integration, in every direction, to the smallest\n");
+  printf ("    box enclosing the regions where the solution differs from\n");
+  printf ("    a uniform state. Useful for blast waves or bubbles expanding\n");
+  printf ("    in a quiescent medium.\n");
+  printf ("    Not available with cooling, body forces or a rotating frame.\n\n");
+
   printf (" -dec n1 [n2] [n3]\n");  
   printf ("    Enable user-defined parallel decomposition mode. The integers\n");
   printf ("    n1, n2 and n3 specify the number of processors along the x1,\n");
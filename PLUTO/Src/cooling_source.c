@@ -20,6 +20,18 @@
   \f]
   where \f$ M_R \f$ is the maximum cooling rate (defined by the global variable  
   ::g_maxCoolingRate) and X are the chemical species.
+
+  The cost of integrating a cell grows with the number of sub-steps
+  (\f$\Delta t\,\max(\rm rate)\f$) and may vary by orders of magnitude
+  between ambient cells and cells near radiative shocks.
+  When \c COOLING_LOAD_BALANCE is set to \c YES (parallel runs only)
+  the cost of each cell is estimated before integration and the state
+  vectors of the most expensive cells are shipped from overloaded to
+  underloaded processors, integrated there and sent back.
+  Transfers take place only when the most loaded processor exceeds the
+  average load by more than a fraction \c COOLING_LB_TOLERANCE.
+  This requires the reaction network (Radiat()) to depend on the
+  state vector only.
   
   \b References
      - "Simulating radiative astrophysical flows with the PLUTO code:
@@ -34,6 +46,34 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
 
+#ifndef COOLING_LOAD_BALANCE
+ #define COOLING_LOAD_BALANCE   NO
+#endif
+
+#ifndef COOLING_LB_TOLERANCE
+ #define COOLING_LB_TOLERANCE   0.1  /* Allowed load imbalance before
+                                        cells are moved across processors */
+#endif
+
+#if !(defined PARALLEL) || (defined CH_SPACEDIM)
+ #undef  COOLING_LOAD_BALANCE
+ #define COOLING_LOAD_BALANCE   NO
+#endif
+
+/* -- number of doubles describing a cell in transit: v0, k1, maxrate, T0 -- */
+
+#define COOL_NREC   (2*NVAR + 2)
+
+static double CoolingPrepare (const Data *, int, int, int, double *, double *,
+                              double *, Grid *);
+static void   CoolingIntegrate (double *, double *, double, double, double, 
+                                double *);
+static void   CoolingStore (const Data *, double *, double, int, int, int, 
+                            Time_Step *);
+#if COOLING_LOAD_BALANCE == YES
+static void   CoolingBalance (const Data *, double, Time_Step *, Grid *);
+#endif
+
 /* ********************************************************************* */
 void CoolingSource (const Data *d, double dt, Time_Step *Dts, Grid *GXYZ)
 /*!
@@ -46,30 +86,14 @@ void CoolingSource (const Data *d, double dt, Time_Step *Dts, Grid *GXYZ)
  *
  *********************************************************************** */
 {
-  int  nv, k, j, i, stiff, status;
-  double err, scrh, min_tol = 2.e-5;
-  double mu0, T0, T1, mu1, prs;
+  int  k, j, i;
+  double T0, maxrate;
   double v0[NVAR], v1[NVAR], k1[NVAR];
-  double maxrate;
-  intList var_list;
-  
-/* --------------------------------------------------------
-    Set number and indices of the time-dependent variables
-   -------------------------------------------------------- */
-
-  var_list.nvar    = NIONS+1;
-  var_list.indx[0] = PRS;
-  for (nv = 0; nv < NIONS; nv++) var_list.indx[nv+1] = NFLX+nv;
-
-/* -----------------------------------------------------
-    Zero k1
-   ----------------------------------------------------- */
-  
-  NVAR_LOOP(nv) k1[nv] = 0.0;  
 
-/*  ----------------------------------------------------------- 
-                   Begin Integration 
-    -----------------------------------------------------------  */
+  #if COOLING_LOAD_BALANCE == YES
+   CoolingBalance (d, dt, Dts, GXYZ);
+   return;
+  #endif
 
   DOM_LOOP(k,j,i){  /* -- span the computational domain -- */
 
@@ -83,146 +107,435 @@ void CoolingSource (const Data *d, double dt, Time_Step *Dts, Grid *GXYZ)
      if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) continue;
     #endif
     if (d->flag[k][j][i] & FLAG_SPLIT_CELL) continue;
+
+    T0 = CoolingPrepare (d, k, j, i, v0, k1, &maxrate, GXYZ);
+    CoolingIntegrate (v0, k1, maxrate, T0, dt, v1);
+    CoolingStore (d, v1, dt, k, j, i, Dts);
+
+  } /* -- end loop on points -- */
+}
+
+/* ********************************************************************* */
+double CoolingPrepare (const Data *d, int k, int j, int i, double *v0,
+                       double *k1, double *maxrate, Grid *GXYZ)
+/*!
+ * Load the primitive state of cell (i,j,k) into v0 (replacing pressure
+ * with internal energy), compute the initial reaction rates and the 
+ * maximum rate of the network.
+ *
+ * \param [in]  d        pointer to Data structure
+ * \param [in]  k,j,i    the cell indices
+ * \param [out] v0       the initial state vector
+ * \param [out] k1       the initial right hand side
+ * \param [out] maxrate  the maximum rate of the reaction network
+ * \param [in]  GXYZ     pointer to an array of Grid structures
+ *
+ * \return The initial temperature.
+ *********************************************************************** */
+{
+  int nv;
+  double mu0, T0, prs;
+
+/* ----------------------------------------------
+    Compute temperature and internal energy from
+    density, pressure and concentrations.
+   ---------------------------------------------- */
     
-  /* ----------------------------------------------
-      Compute temperature and internal energy from
-      density, pressure and concentrations.
-     ---------------------------------------------- */
-    
-    NVAR_LOOP(nv) v0[nv] = v1[nv] = d->Vc[nv][k][j][i];
-    prs = v0[PRS];
-    mu0 = MeanMolecularWeight(v0);
-    T0  = v0[PRS]/v0[RHO]*KELVIN*mu0;
-    #if EOS == IDEAL
-     v0[RHOE] = v1[RHOE] = prs/(g_gamma-1.0);
-    #else
-     v1[RHOE] = v0[RHOE] = InternalEnergy(v0, T0);
-    #endif
+  NVAR_LOOP(nv) v0[nv] = d->Vc[nv][k][j][i];
+  prs = v0[PRS];
+  mu0 = MeanMolecularWeight(v0);
+  T0  = v0[PRS]/v0[RHO]*KELVIN*mu0;
+  #if EOS == IDEAL
+   v0[RHOE] = prs/(g_gamma-1.0);
+  #else
+   v0[RHOE] = InternalEnergy(v0, T0);
+  #endif
+
+  if (T0 <= 0.0){
+    print ("! CoolingSource: negative initial temperature\n");
+    print (" %12.6e  %12.6e\n",v0[RHOE], v0[RHO]);
+    print (" at: %f %f\n",GXYZ[IDIR].x[i], GXYZ[JDIR].x[j]);
+    QUIT_PLUTO(1);
+  }
 
-    if (T0 <= 0.0){
-      print ("! CoolingSource: negative initial temperature\n");
-      print (" %12.6e  %12.6e\n",v0[RHOE], v0[RHO]);
-      print (" at: %f %f\n",GXYZ[IDIR].x[i], GXYZ[JDIR].x[j]);
-      QUIT_PLUTO(1);
-    }
+/* -------------------------------------------
+    Get estimated time step based on 
+    the max rate of the reaction network.
+   ------------------------------------------- */
 
-  /* -------------------------------------------
-      Get estimated time step based on 
-      the max rate of the reaction network.
-     ------------------------------------------- */
+  NVAR_LOOP(nv) k1[nv] = 0.0;  
+  Radiat(v0, k1);
+  *maxrate = GetMaxRate (v0, k1, T0);
+
+  return T0;
+}
+
+/* ********************************************************************* */
+void CoolingIntegrate (double *v0, double *k1, double maxrate, double T0,
+                       double dt, double *v1)
+/*!
+ * Integrate the cooling and reaction network of a single cell over
+ * the time step dt.
+ * This function depends on the state vector only and may thus be 
+ * called for a cell owned by another processor.
+ *
+ * \param [in,out] v0       the initial state vector, as returned by
+ *                          CoolingPrepare() (overwritten)
+ * \param [in,out] k1       the initial right hand side (overwritten)
+ * \param [in]     maxrate  the maximum rate of the reaction network
+ * \param [in]     T0       the initial temperature
+ * \param [in]     dt       the time step to be taken
+ * \param [out]    v1       the final primitive state vector
+ *********************************************************************** */
+{
+  int  nv, stiff, status;
+  double scrh, min_tol = 2.e-5;
+  double T1, mu1, prs;
+  intList var_list;
+  
+/* --------------------------------------------------------
+    Set number and indices of the time-dependent variables
+   -------------------------------------------------------- */
 
-    Radiat(v0, k1);
+  var_list.nvar    = NIONS+1;
+  var_list.indx[0] = PRS;
+  for (nv = 0; nv < NIONS; nv++) var_list.indx[nv+1] = NFLX+nv;
 
-    maxrate = GetMaxRate (v0, k1, T0);
-    stiff = (dt*maxrate > 1.0 ? 1:0);
+  NVAR_LOOP(nv) v1[nv] = v0[nv];
+  stiff = (dt*maxrate > 1.0 ? 1:0);
 
-  /* ---------------------------------------------------
-      If the system is not stiff, then try to advance
-      with an explicit 2-nd order midpoint rule
-     --------------------------------------------------- */
+/* ---------------------------------------------------
+    If the system is not stiff, then try to advance
+    with an explicit 2-nd order midpoint rule
+   --------------------------------------------------- */
 
-    if (!stiff){ /* -- no stiffness: try explicit -- */
+  if (!stiff){ /* -- no stiffness: try explicit -- */
  
-      scrh = SolveODE_RKF12 (v0, k1, v1, dt, min_tol, &var_list); 
-/*    scrh = SolveODE_RKF23 (v0, k1, v1, dt, min_tol);  */
+    scrh = SolveODE_RKF12 (v0, k1, v1, dt, min_tol, &var_list); 
+/*  scrh = SolveODE_RKF23 (v0, k1, v1, dt, min_tol);  */
 
 /* -- error is too big ? --> use some other integrator -- */
 
-      if (scrh < 0.0) SolveODE_CK45 (v0, k1, v1, dt, min_tol, &var_list);
+    if (scrh < 0.0) SolveODE_CK45 (v0, k1, v1, dt, min_tol, &var_list);
 
-    } else { /* -- if stiff = 1 use more sophisticated integrators -- */
+  } else { /* -- if stiff = 1 use more sophisticated integrators -- */
 
 /*  SolveODE_ROS34 (v0, k1, v1, dtsub, min_tol);  */
 
-      int nsub, k;
-      double dtsub, dtnew, t;
+    int nsub, k;
+    double dtsub, dtnew, t;
 
-      nsub  = ceil(dt*maxrate);
-      dtsub = dt/(double)nsub;
+    nsub  = ceil(dt*maxrate);
+    dtsub = dt/(double)nsub;
 
-    /* ----------------------------------
-            use sub-time stepping
-       ---------------------------------- */
+  /* ----------------------------------
+          use sub-time stepping
+     ---------------------------------- */
 
-      t = 0.0;
-      for (k = 1; 1; k++){
-        dtnew = SolveODE_CK45 (v0, k1, v1, dtsub, min_tol, &var_list);
-     /* dtnew = SolveODE_ROS34(v0, k1, v1, dtsub, min_tol);  */
-        t    += dtsub;
-     /* printf ("%d / %d   %12.6e  %12.6e, t/dt = %f\n",
-        k,nsub,dtsub,dtnew, t/dt);*/
+    t = 0.0;
+    for (k = 1; 1; k++){
+      dtnew = SolveODE_CK45 (v0, k1, v1, dtsub, min_tol, &var_list);
+   /* dtnew = SolveODE_ROS34(v0, k1, v1, dtsub, min_tol);  */
+      t    += dtsub;
+   /* printf ("%d / %d   %12.6e  %12.6e, t/dt = %f\n",
+      k,nsub,dtsub,dtnew, t/dt);*/
 
-        if (fabs(t/dt - 1.0) < 1.e-9) break;
+      if (fabs(t/dt - 1.0) < 1.e-9) break;
 
-        v0[RHOE] = v1[RHOE];
-        NIONS_LOOP(nv) v0[nv] = v1[nv];
+      v0[RHOE] = v1[RHOE];
+      NIONS_LOOP(nv) v0[nv] = v1[nv];
 
-        Radiat(v0, k1);
-        dtsub = MIN (dtnew, dt - t);
-      }
+      Radiat(v0, k1);
+      dtsub = MIN (dtnew, dt - t);
+    }
 
-      if (k > 100) print ("! CoolingSource: Number of substeps exceeded 100 (%d)\n",k);
-      if (fabs(t/dt - 1.0) > 1.e-12) {
-        print ("! CoolingSource: dt mismatch\n");
-        QUIT_PLUTO(1);
-      }
-    }  /* -- end if (stiff) -- */
+    if (k > 100) print ("! CoolingSource: Number of substeps exceeded 100 (%d)\n",k);
+    if (fabs(t/dt - 1.0) > 1.e-12) {
+      print ("! CoolingSource: dt mismatch\n");
+      QUIT_PLUTO(1);
+    }
+  }  /* -- end if (stiff) -- */
 
-  /* -- Constrain ions to lie between [0,1] -- */
+/* -- Constrain ions to lie between [0,1] -- */
 
-    NIONS_LOOP(nv){
-      v1[nv] = MAX(v1[nv], 0.0);
-      v1[nv] = MIN(v1[nv], 1.0);
-    }
-    #if COOLING == H2_COOL
-     v1[X_H2] = MIN(v1[X_H2], 0.5);
-    #endif
+  NIONS_LOOP(nv){
+    v1[nv] = MAX(v1[nv], 0.0);
+    v1[nv] = MIN(v1[nv], 1.0);
+  }
+  #if COOLING == H2_COOL
+   v1[X_H2] = MIN(v1[X_H2], 0.5);
+  #endif
     
-  /* -- pressure must be positive -- */
-
-    mu1 = MeanMolecularWeight(v1);
-    #if EOS == IDEAL
-     prs = v1[RHOE]*(g_gamma - 1.0);
-     T1  = prs/v1[RHO]*KELVIN*mu1;
-    #elif EOS == PVTE_LAW
-     status = GetEV_Temperature(v1[RHOE], v1, &T1);
-     prs    = v1[RHO]*T1/(KELVIN*mu1);
-    #endif
+/* -- pressure must be positive -- */
+
+  mu1 = MeanMolecularWeight(v1);
+  #if EOS == IDEAL
+   prs = v1[RHOE]*(g_gamma - 1.0);
+   T1  = prs/v1[RHO]*KELVIN*mu1;
+  #elif EOS == PVTE_LAW
+   status = GetEV_Temperature(v1[RHOE], v1, &T1);
+   prs    = v1[RHO]*T1/(KELVIN*mu1);
+  #endif
 
-    if (prs < 0.0) prs = g_smallPressure;
+  if (prs < 0.0) prs = g_smallPressure;
 
-  /* -- Check final temperature -- */
+/* -- Check final temperature -- */
 
+  if (T1 < g_minCoolingTemp && T0 > g_minCoolingTemp)
+    prs = g_minCoolingTemp*v1[RHO]/(KELVIN*mu1);
+
+  v1[PRS] = prs;
+}
+
+/* ********************************************************************* */
+void CoolingStore (const Data *d, double *v1, double dt,
+                   int k, int j, int i, Time_Step *Dts)
+/*!
+ * Suggest the next time step based on the fractional variation and
+ * copy the final pressure and ion fractions into the solution array.
+ *
+ * \param [in,out] d     pointer to Data structure
+ * \param [in]     v1    the final state vector from CoolingIntegrate()
+ * \param [in]     dt    the time step that has been taken
+ * \param [in]     k,j,i the cell indices
+ * \param [out]    Dts   pointer to the Time_Step structure
+ *********************************************************************** */
+{
+  int nv;
+  double err, scrh;
 
-    if (T1 < g_minCoolingTemp && T0 > g_minCoolingTemp)
-      prs = g_minCoolingTemp*v1[RHO]/(KELVIN*mu1);
+  err = fabs(v1[PRS]/d->Vc[PRS][k][j][i] - 1.0);
 
-  /* ------------------------------------------
-      Suggest next time step based on 
-      fractional variaton.
-     ------------------------------------------ */
+  #if COOLING == MINEq
+   for (nv = NFLX; nv < NFLX + NIONS - Fe_IONS; nv++) 
+  #else
+     NIONS_LOOP(nv)
+  #endif
+    err = MAX(err, fabs(d->Vc[nv][k][j][i] - v1[nv]));
 
-    err = fabs(prs/d->Vc[PRS][k][j][i] - 1.0);
+  scrh = dt*g_maxCoolingRate/err;
 
-    #if COOLING == MINEq
-     for (nv = NFLX; nv < NFLX + NIONS - Fe_IONS; nv++) 
-    #else
-       NIONS_LOOP(nv)
+  Dts->dt_cool = MIN(Dts->dt_cool, scrh);
+
+/* ---- Update solution array ---- */
+
+  d->Vc[PRS][k][j][i] = v1[PRS];
+  NIONS_LOOP(nv) d->Vc[nv][k][j][i] = v1[nv];
+}
+
+#if COOLING_LOAD_BALANCE == YES
+typedef struct {
+  double cost;
+  int    n;
+} CoolCost;
+
+static int CompareCost (const void *a, const void *b)
+{
+  double ca = ((const CoolCost *)a)->cost;
+  double cb = ((const CoolCost *)b)->cost;
+  if (ca > cb) return -1;
+  if (ca < cb) return  1;
+  return ((const CoolCost *)a)->n - ((const CoolCost *)b)->n;
+}
+
+/* ********************************************************************* */
+void CoolingBalance (const Data *d, double dt, Time_Step *Dts, Grid *GXYZ)
+/*!
+ * Integrate cooling and reaction source terms distributing the work
+ * among processors according to the estimated cost of each cell.
+ *
+ * The cost of a cell is taken to be the number of sub-steps,
+ * \f$ \max(1, \lceil \Delta t\,\max({\rm rate})\rceil)\f$.
+ * Processors whose load exceeds the average send their most expensive
+ * cells (state vector, initial rates, max rate and temperature) to the
+ * underloaded ones using a greedy matching that every processor 
+ * computes identically from the gathered loads. 
+ * Results are returned to the owner, which updates the solution array 
+ * and the cooling time step.
+ *
+ * \param [in,out]  d   pointer to Data structure
+ * \param [in]     dt   the time step to be taken
+ * \param [out]    Dts  pointer to the Time_Step structure
+ * \param [in]    GXYZ  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    k, j, i, n, m, p, q, nv, ncell, nproc, nsend, nrecv;
+  int    *cell, *dest, *scnt, *sdsp, *rcnt, *rdsp;
+  double Wloc, Wavg, Wmax, acc, amnt;
+  double *W, *excess, *plan, *rec, *res, *sbuf, *rbuf, *v;
+  CoolCost *cost;
+
+  MPI_Comm_size (MPI_COMM_WORLD, &nproc);
+
+/* --------------------------------------------------------
+    1. Prepare all active cells and estimate their cost
+   -------------------------------------------------------- */
+
+  ncell = 0;
+  DOM_LOOP(k,j,i) ncell++;
+
+  cell = (int *)      malloc ((ncell + 1)*3*sizeof(int));
+  dest = (int *)      malloc ((ncell + 1)*sizeof(int));
+  cost = (CoolCost *) malloc ((ncell + 1)*sizeof(CoolCost));
+  rec  = (double *)   malloc ((ncell + 1)*COOL_NREC*sizeof(double));
+  res  = (double *)   malloc ((ncell + 1)*NVAR*sizeof(double));
+
+  n    = 0;
+  Wloc = 0.0;
+  DOM_LOOP(k,j,i){
+    #if INTERNAL_BOUNDARY == YES
+     if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) continue;
     #endif
-      err = MAX(err, fabs(d->Vc[nv][k][j][i] - v1[nv]));
+    if (d->flag[k][j][i] & FLAG_SPLIT_CELL) continue;
 
-    scrh = dt*g_maxCoolingRate/err;
+    v = rec + n*COOL_NREC;
+    v[2*NVAR + 1] = CoolingPrepare (d, k, j, i, v, v + NVAR, 
+                                    v + 2*NVAR, GXYZ);
+    cell[3*n] = k; cell[3*n + 1] = j; cell[3*n + 2] = i;
+    dest[n]   = prank;
+    cost[n].n    = n;
+    cost[n].cost = MAX(1.0, ceil(dt*v[2*NVAR]));
+    Wloc += cost[n].cost;
+    n++;
+  }
+  ncell = n;
 
-    Dts->dt_cool = MIN(Dts->dt_cool, scrh);
+/* --------------------------------------------------------
+    2. Gather loads and build the transfer plan:
+       plan[p*nproc + q] is the cost moved from p to q.
+   -------------------------------------------------------- */
 
-  /* ---- Update solution array ---- */
+  W      = ARRAY_1D(nproc, double);
+  excess = ARRAY_1D(nproc, double);
+  plan   = ARRAY_1D(nproc*nproc, double);
+  MPI_Allgather (&Wloc, 1, MPI_DOUBLE, W, 1, MPI_DOUBLE, MPI_COMM_WORLD);
 
-    d->Vc[PRS][k][j][i] = prs;
-    NIONS_LOOP(nv) d->Vc[nv][k][j][i] = v1[nv];
+  Wavg = Wmax = 0.0;
+  for (p = 0; p < nproc; p++) {
+    Wavg += W[p]/(double)nproc;
+    Wmax  = MAX(Wmax, W[p]);
+  }
+  for (p = 0; p < nproc*nproc; p++) plan[p] = 0.0;
+
+  if (Wmax > (1.0 + COOLING_LB_TOLERANCE)*Wavg){
+    for (p = 0; p < nproc; p++) excess[p] = W[p] - Wavg;
+    p = q = 0;
+    while (p < nproc && q < nproc){
+      if (excess[p] <= 0.0)  {p++; continue;}
+      if (excess[q] >= 0.0)  {q++; continue;}
+      amnt = MIN(excess[p], -excess[q]);
+      plan[p*nproc + q] = amnt;
+      excess[p] -= amnt;
+      excess[q] += amnt;
+    }
+  }
 
-  } /* -- end loop on points -- */
+/* --------------------------------------------------------
+    3. Assign the most expensive cells to the receivers.
+       A cell is sent only if it does not overshoot the
+       planned amount by more than half its cost.
+   -------------------------------------------------------- */
+
+  if (W[prank] > Wavg){
+    qsort (cost, ncell, sizeof(CoolCost), CompareCost);
+    m = 0;
+    for (q = 0; q < nproc; q++){
+      amnt = plan[prank*nproc + q];
+      acc  = 0.0;
+      for (; m < ncell && amnt > 0.0; m++){
+        if (acc + 0.5*cost[m].cost > amnt) break;
+        dest[cost[m].n] = q;
+        acc += cost[m].cost;
+      }
+    }
+  }
+
+/* --------------------------------------------------------
+    4. Ship records to their destinations
+   -------------------------------------------------------- */
+
+  scnt = ARRAY_1D(nproc, int);
+  sdsp = ARRAY_1D(nproc, int);
+  rcnt = ARRAY_1D(nproc, int);
+  rdsp = ARRAY_1D(nproc, int);
+
+  for (q = 0; q < nproc; q++) scnt[q] = 0;
+  for (n = 0; n < ncell; n++) if (dest[n] != prank) scnt[dest[n]]++;
+  MPI_Alltoall (scnt, 1, MPI_INT, rcnt, 1, MPI_INT, MPI_COMM_WORLD);
+
+  nsend = nrecv = 0;
+  for (q = 0; q < nproc; q++){
+    sdsp[q] = nsend; nsend += scnt[q];
+    rdsp[q] = nrecv; nrecv += rcnt[q];
+  }
+
+  sbuf = (double *) malloc ((nsend + 1)*COOL_NREC*sizeof(double));
+  rbuf = (double *) malloc ((nrecv + 1)*COOL_NREC*sizeof(double));
+
+  for (q = 0; q < nproc; q++) scnt[q] = 0;
+  for (n = 0; n < ncell; n++){
+    q = dest[n];
+    if (q == prank) continue;
+    v = sbuf + (sdsp[q] + scnt[q])*COOL_NREC;
+    for (nv = 0; nv < COOL_NREC; nv++) v[nv] = rec[n*COOL_NREC + nv];
+    scnt[q]++;
+  }
+
+  for (q = 0; q < nproc; q++){
+    scnt[q] *= COOL_NREC; sdsp[q] *= COOL_NREC;
+    rcnt[q] *= COOL_NREC; rdsp[q] *= COOL_NREC;
+  }
+  MPI_Alltoallv (sbuf, scnt, sdsp, MPI_DOUBLE, 
+                 rbuf, rcnt, rdsp, MPI_DOUBLE, MPI_COMM_WORLD);
+
+/* --------------------------------------------------------
+    5. Integrate received cells first (their owners wait
+       for them), then the local ones.
+       Results overwrite the head of each record.
+   -------------------------------------------------------- */
+
+  for (n = 0; n < nrecv; n++){
+    v = rbuf + n*COOL_NREC;
+    CoolingIntegrate (v, v + NVAR, v[2*NVAR], v[2*NVAR + 1], dt, res);
+    for (nv = 0; nv < NVAR; nv++) v[nv] = res[nv];
+  }
+
+  for (n = 0; n < ncell; n++){
+    if (dest[n] != prank) continue;
+    v = rec + n*COOL_NREC;
+    CoolingIntegrate (v, v + NVAR, v[2*NVAR], v[2*NVAR + 1], dt, 
+                      res + n*NVAR);
+  }
+
+/* --------------------------------------------------------
+    6. Send results back to the owners (same layout,
+       reversed counts) and update the solution array
+   -------------------------------------------------------- */
+
+  MPI_Alltoallv (rbuf, rcnt, rdsp, MPI_DOUBLE, 
+                 sbuf, scnt, sdsp, MPI_DOUBLE, MPI_COMM_WORLD);
+
+  for (q = 0; q < nproc; q++) scnt[q] = 0;
+  for (n = 0; n < ncell; n++){
+    q = dest[n];
+    if (q != prank){
+      v = sbuf + sdsp[q] + scnt[q]*COOL_NREC;
+      for (nv = 0; nv < NVAR; nv++) res[n*NVAR + nv] = v[nv];
+      scnt[q]++;
+    }
+    CoolingStore (d, res + n*NVAR, dt, cell[3*n], cell[3*n + 1],
+                  cell[3*n + 2], Dts);
+  }
+
+  free (cell); free (dest); free (cost);
+  free (rec);  free (res);  free (sbuf); free (rbuf);
+  FreeArray1D ((void *) W);    FreeArray1D ((void *) excess);
+  FreeArray1D ((void *) plan);
+  FreeArray1D ((void *) scnt); FreeArray1D ((void *) sdsp);
+  FreeArray1D ((void *) rcnt); FreeArray1D ((void *) rdsp);
 }
- 
+#endif
+
 /* ********************************************************************* */
 void Numerical_Jacobian (double *v, double **J)
 /*!
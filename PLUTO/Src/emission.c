@@ -0,0 +1,363 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Compute synchrotron and inverse Compton emission maps.
+
+  EmissionMaps() computes optically thin synchrotron and inverse Compton
+  (IC) emissivities from the primitive variables and integrates them
+  along one of the coordinate axes, producing 2D projected maps at
+  \c EMISSION_NFREQ frequencies logarithmically spaced between
+  \c EMISSION_NU_MIN and \c EMISSION_NU_MAX (in Hz).
+  It is meant to be called from the user-supplied Analysis() function,
+  e.g.
+  \code
+    void Analysis (const Data *d, Grid *grid)
+    {
+      EmissionMaps (d, KDIR, grid);
+    }
+  \endcode
+  so that small maps can be written instead of full 3D snapshots.
+
+  In each zone, non-thermal electrons follow a power-law distribution
+  \f$ n(\gamma) = K\gamma^{-p}\f$ between \c EMISSION_GAMMA_MIN and
+  \c EMISSION_GAMMA_MAX, with energy density equal to a fraction
+  \c EMISSION_EPS_E of the thermal energy density.
+  The synchrotron emissivity depends on the field component
+  perpendicular to the line of sight,
+  \f[
+    j_\nu = \frac{\sqrt{3}e^3B_\perp}{4\pi m_ec^2}K\,
+            G\left(\frac{\nu}{\nu_0B_\perp}\right)\,,\qquad
+    G(y) = \int_{\gamma_{\min}}^{\gamma_{\max}}
+           \gamma^{-p}F\left(\frac{y}{\gamma^2}\right)d\gamma
+  \f]
+  where \f$\nu_0 = 3e/(4\pi m_ec)\f$ and \f$F(x)\f$ is the synchrotron
+  kernel.
+  Since \f$p\f$ and the energy range are fixed, the function \f$G(y)\f$
+  is tabulated once and then interpolated, so that the emissivity of a
+  zone costs a table lookup per frequency.
+  When the magnetic field is not evolved (e.g. HD), \f$B\f$ is computed
+  assuming that its energy density is a fraction \c EMISSION_EPS_B of the
+  thermal one.
+  IC emission from a black-body radiation field of temperature
+  \c EMISSION_TRAD is computed in the Thomson limit with the
+  delta-function approximation, so it simply scales with \f$K\f$.
+
+  Maps are reduced across processors and written by processor 0 to the
+  binary files \c syn.nnnn.map and \c ic.nnnn.map (double precision,
+  \c EMISSION_NFREQ maps in sequence) in units of erg/(s cm^2 Hz sr).
+  The file \c emission.out lists, for each output, the file number,
+  time, map size, line of sight and frequencies.
+
+  The maps are built on the static grid and EmissionMaps() is not
+  available with AMR (Chombo).
+
+  \b Reference
+    - "Radiative Processes in Astrophysics",
+       Rybicki \& Lightman (1979), Wiley
+    - Fouka \& Ouichaoui, Res. Astron. Astrophys. (2013) 13, 680
+
+  \date    Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#ifdef CHOMBO
+ #error EmissionMaps() not available with CHOMBO
+#endif
+
+#ifndef EMISSION_NFREQ
+ #define EMISSION_NFREQ     4
+#endif
+
+#ifndef EMISSION_NU_MIN
+ #define EMISSION_NU_MIN    1.e9    /* Hz */
+#endif
+
+#ifndef EMISSION_NU_MAX
+ #define EMISSION_NU_MAX    1.e18   /* Hz */
+#endif
+
+#ifndef EMISSION_P
+ #define EMISSION_P         2.2
+#endif
+
+#ifndef EMISSION_GAMMA_MIN
+ #define EMISSION_GAMMA_MIN    10.0
+#endif
+
+#ifndef EMISSION_GAMMA_MAX
+ #define EMISSION_GAMMA_MAX    1.e7
+#endif
+
+#ifndef EMISSION_EPS_E
+ #define EMISSION_EPS_E      1.e-2
+#endif
+
+#ifndef EMISSION_EPS_B
+ #define EMISSION_EPS_B      1.e-2
+#endif
+
+#ifndef EMISSION_TRAD
+ #define EMISSION_TRAD       2.725   /* K (CMB) */
+#endif
+
+#define EMISSION_QE      4.8032068e-10   /* electron charge (esu) */
+#define EMISSION_NTAB    512
+
+static double SynchrotronKernel (double);
+static void   EmissionTables (double *, double *, double *, double *);
+
+/* ********************************************************************* */
+void EmissionMaps (const Data *d, int los, Grid *grid)
+/*!
+ * Compute and write synchrotron and IC maps projected along the
+ * \c los direction.
+ *
+ * \param [in] d     pointer to the PLUTO Data structure
+ * \param [in] los   the line of sight direction (IDIR, JDIR or KDIR)
+ * \param [in] grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int    i, j, k, n, m, ia, ib, ia0, ib0, na, nb, dir_a, dir_b;
+  int    ind[3];
+  size_t nmap;
+  static int nfile = -1;
+  static double *lgtab, *Gtab, nu[EMISSION_NFREQ], ic_fac[EMISSION_NFREQ];
+  static double lgy_beg, inv_dlgy;
+  double *syn, *ic, *mbuf;
+  double Kfac, unit_B, unit_p, gmm1, prs, uth, K, dl;
+  double B[3], Bn, Bperp, Bperp2, y, ly, w, G, syn_fac;
+  char   fname[512], sline[512];
+  FILE   *fp;
+
+  #if GEOMETRY != CARTESIAN
+   print1 ("! EmissionMaps: only Cartesian geometry is supported\n");
+   QUIT_PLUTO(1);
+  #endif
+
+/* --------------------------------------------------------
+    1. Tabulate G(y) and the IC spectral factor once
+   -------------------------------------------------------- */
+
+  if (Gtab == NULL){
+    lgtab = ARRAY_1D(EMISSION_NTAB, double);
+    Gtab  = ARRAY_1D(EMISSION_NTAB, double);
+    EmissionTables (lgtab, Gtab, nu, ic_fac);
+    lgy_beg  = lgtab[0];
+    inv_dlgy = 1.0/(lgtab[1] - lgtab[0]);
+  }
+
+/* --------------------------------------------------------
+    2. Set map directions and the local offset inside
+       the global map.
+   -------------------------------------------------------- */
+
+  dir_a = (los == IDIR ? JDIR:IDIR);
+  dir_b = (los == KDIR ? JDIR:KDIR);
+  na = grid[dir_a].np_int_glob;
+  nb = grid[dir_b].np_int_glob;
+  ia0 = grid[dir_a].beg - grid[dir_a].gbeg;
+  ib0 = grid[dir_b].beg - grid[dir_b].gbeg;
+  nmap = (size_t)na*nb;
+
+  syn = ARRAY_1D(nmap*EMISSION_NFREQ, double);
+  ic  = ARRAY_1D(nmap*EMISSION_NFREQ, double);
+  memset (syn, 0, nmap*EMISSION_NFREQ*sizeof(double));
+  memset (ic,  0, nmap*EMISSION_NFREQ*sizeof(double));
+
+/* --------------------------------------------------------
+    3. Emissivity normalization.
+       K is obtained from u_e = eps_e*u_th = K*me*c^2*I1
+       with I1 = int gamma^(1-p) dgamma.
+   -------------------------------------------------------- */
+
+  #if EOS == IDEAL
+   gmm1 = g_gamma - 1.0;
+  #else
+   gmm1 = 2.0/3.0;
+  #endif
+  unit_p = UNIT_DENSITY*UNIT_VELOCITY*UNIT_VELOCITY;
+  unit_B = sqrt(4.0*CONST_PI*UNIT_DENSITY)*UNIT_VELOCITY;
+  if (fabs(EMISSION_P - 2.0) < 1.e-8) {
+    Kfac = log(EMISSION_GAMMA_MAX/EMISSION_GAMMA_MIN);
+  }else{
+    Kfac = (  pow(EMISSION_GAMMA_MAX, 2.0 - EMISSION_P)
+            - pow(EMISSION_GAMMA_MIN, 2.0 - EMISSION_P))/(2.0 - EMISSION_P);
+  }
+  Kfac    = EMISSION_EPS_E/(gmm1*CONST_me*CONST_c*CONST_c*Kfac);
+  syn_fac = sqrt(3.0)*pow(EMISSION_QE,3)/(4.0*CONST_PI*CONST_me*CONST_c*CONST_c);
+
+/* --------------------------------------------------------
+    4. Compute emissivities and integrate along the
+       line of sight
+   -------------------------------------------------------- */
+
+  B[IDIR] = B[JDIR] = B[KDIR] = 0.0;
+  DOM_LOOP(k,j,i){
+    #if HAVE_ENERGY
+     prs = d->Vc[PRS][k][j][i];
+    #elif EOS == ISOTHERMAL
+     prs = d->Vc[RHO][k][j][i]*g_isoSoundSpeed*g_isoSoundSpeed;
+    #endif
+    uth = prs*unit_p/gmm1;
+    K   = Kfac*prs*unit_p;
+
+    #if PHYSICS == MHD || PHYSICS == RMHD
+     EXPAND(B[IDIR] = d->Vc[BX1][k][j][i]*unit_B;  ,
+            B[JDIR] = d->Vc[BX2][k][j][i]*unit_B;  ,
+            B[KDIR] = d->Vc[BX3][k][j][i]*unit_B;)
+     Bn     = B[los];
+     Bperp2 = B[IDIR]*B[IDIR] + B[JDIR]*B[JDIR] + B[KDIR]*B[KDIR] - Bn*Bn;
+    #else
+     Bperp2 = 2.0/3.0*8.0*CONST_PI*EMISSION_EPS_B*uth; /* isotropic field */
+    #endif
+    Bperp = sqrt(MAX(Bperp2, 0.0));
+
+    ind[IDIR] = i - IBEG; ind[JDIR] = j - JBEG; ind[KDIR] = k - KBEG;
+    ia = ia0 + ind[dir_a];
+    ib = ib0 + ind[dir_b];
+    n  = ib*na + ia;
+
+    dl = (los < DIMENSIONS ? grid[los].dx[ind[los] + grid[los].lbeg]:1.0);
+    dl *= UNIT_LENGTH;
+
+    for (m = 0; m < EMISSION_NFREQ; m++) ic[m*nmap + n] += ic_fac[m]*K*dl;
+
+    if (Bperp <= 0.0) continue;
+    for (m = 0; m < EMISSION_NFREQ; m++){
+      y  = nu[m]/(3.0*EMISSION_QE/(4.0*CONST_PI*CONST_me*CONST_c)*Bperp);
+      ly = (log(y) - lgy_beg)*inv_dlgy;
+      if (ly >= EMISSION_NTAB - 1) continue;   /* above cutoff */
+      if (ly < 0.0){                           /* low frequency tail */
+        G = exp(Gtab[0])*pow(y/exp(lgy_beg), 1.0/3.0);
+      }else{
+        ia = (int)ly;
+        w  = ly - ia;
+        G  = exp((1.0 - w)*Gtab[ia] + w*Gtab[ia+1]);
+      }
+      syn[m*nmap + n] += syn_fac*Bperp*K*G*dl;
+    }
+  }
+
+/* --------------------------------------------------------
+    5. Reduce and write maps
+   -------------------------------------------------------- */
+
+  #ifdef PARALLEL
+   mbuf = ARRAY_1D(nmap*EMISSION_NFREQ, double);
+   MPI_Reduce (syn, mbuf, nmap*EMISSION_NFREQ, MPI_DOUBLE, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+   memcpy (syn, mbuf, nmap*EMISSION_NFREQ*sizeof(double));
+   MPI_Reduce (ic, mbuf, nmap*EMISSION_NFREQ, MPI_DOUBLE, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+   memcpy (ic, mbuf, nmap*EMISSION_NFREQ*sizeof(double));
+   FreeArray1D ((void *) mbuf);
+  #endif
+
+  nfile++;
+  if (prank == 0){
+    print1 ("> Writing emission maps #%d to disk...\n", nfile);
+
+    sprintf (fname, "%s/syn.%04d.map", RuntimeGet()->output_dir, nfile);
+    fp = fopen (fname, "wb");
+    fwrite (syn, sizeof(double), nmap*EMISSION_NFREQ, fp);
+    fclose (fp);
+
+    sprintf (fname, "%s/ic.%04d.map", RuntimeGet()->output_dir, nfile);
+    fp = fopen (fname, "wb");
+    fwrite (ic, sizeof(double), nmap*EMISSION_NFREQ, fp);
+    fclose (fp);
+
+    sprintf (fname, "%s/emission.out", RuntimeGet()->output_dir);
+    if (nfile == 0) {
+      fp = fopen (fname, "w");
+    }else {
+      fp = fopen (fname, "r+");
+      for (n = 0; n < nfile; n++) fgets (sline, 512, fp);
+      fseek (fp, ftell(fp), SEEK_SET);
+    }
+    fprintf (fp, "%d %12.6e %d %d %d %s ", nfile, g_time, na, nb, los,
+             IsLittleEndian() ? "little":"big");
+    for (m = 0; m < EMISSION_NFREQ; m++) fprintf (fp, "%12.6e ", nu[m]);
+    fprintf (fp, "\n");
+    fclose (fp);
+  }
+
+  FreeArray1D ((void *) syn);
+  FreeArray1D ((void *) ic);
+}
+
+/* ********************************************************************* */
+void EmissionTables (double *lgy, double *lnG, double *nu, double *ic_fac)
+/*!
+ * Tabulate ln G(y) on a uniform grid in ln y, the map frequencies and
+ * the IC factor j_nu/K for each frequency.
+ *
+ * \param [out] lgy     array of ln(y) values
+ * \param [out] lnG     array of ln(G(y)) values
+ * \param [out] nu      array of frequencies
+ * \param [out] ic_fac  IC emissivity per unit K at each frequency
+ *********************************************************************** */
+{
+  int    n, l, ng = 256;
+  double lymin, lymax, lg0, dlg, g, x, s, wl;
+  double nu_s, u_rad, gam;
+
+  lymin = log(EMISSION_GAMMA_MIN*EMISSION_GAMMA_MIN*1.e-6);
+  lymax = log(EMISSION_GAMMA_MAX*EMISSION_GAMMA_MAX*50.0);
+  lg0   = log(EMISSION_GAMMA_MIN);
+  dlg   = (log(EMISSION_GAMMA_MAX) - lg0)/(double)ng;
+
+/* -- integrate gamma^(1-p) F(y/gamma^2) dln(gamma) with Simpson's rule -- */
+
+  for (n = 0; n < EMISSION_NTAB; n++){
+    lgy[n] = lymin + n*(lymax - lymin)/(EMISSION_NTAB - 1.0);
+    s = 0.0;
+    for (l = 0; l <= ng; l++){
+      g  = exp(lg0 + l*dlg);
+      x  = exp(lgy[n])/(g*g);
+      wl = (l == 0 || l == ng ? 1.0:(l%2 ? 4.0:2.0));
+      s += wl*pow(g, 1.0 - EMISSION_P)*SynchrotronKernel(x);
+    }
+    s *= dlg/3.0;
+    lnG[n] = log(MAX(s, 1.e-300));
+  }
+
+/* -- frequencies and IC factors (Thomson, delta approximation) -- */
+
+  nu_s  = 2.70*CONST_kB*EMISSION_TRAD/CONST_h;
+  u_rad = 4.0*CONST_sigma/CONST_c*pow(EMISSION_TRAD, 4);
+  for (n = 0; n < EMISSION_NFREQ; n++){
+    nu[n] = EMISSION_NU_MIN;
+    if (EMISSION_NFREQ > 1) {
+      nu[n] *= pow(EMISSION_NU_MAX/EMISSION_NU_MIN, n/(EMISSION_NFREQ - 1.0));
+    }
+    gam = sqrt(0.75*nu[n]/nu_s);
+    ic_fac[n] = 0.0;
+    if (gam >= EMISSION_GAMMA_MIN && gam <= EMISSION_GAMMA_MAX){
+      ic_fac[n] = 4.0/3.0*CONST_sigmaT*CONST_c*u_rad*pow(gam, 3.0 - EMISSION_P)
+                  /(2.0*nu[n])/(4.0*CONST_PI);
+    }
+  }
+}
+
+/* ********************************************************************* */
+double SynchrotronKernel (double x)
+/*!
+ * Return the synchrotron kernel F(x) = x int_x^inf K_{5/3}(t) dt
+ * using the analytical approximation of Fouka \& Ouichaoui (2013),
+ * accurate to better than 0.5 per cent.
+ *********************************************************************** */
+{
+  double x13, x23, x43;
+
+  if (x > 700.0) return 0.0;
+  x13 = pow(x, 1.0/3.0);
+  x23 = x13*x13;
+  x43 = x23*x23;
+  return 2.15*x13*pow(1.0 + 3.06*x, 1.0/6.0)
+         *(1.0 + 0.884*x23 + 0.471*x43)/(1.0 + 1.64*x23 + 0.974*x43)*exp(-x);
+}
+
+#undef EMISSION_QE
+#undef EMISSION_NTAB
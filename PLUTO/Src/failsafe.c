@@ -1,75 +1,260 @@
-#include"pluto.h"
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Redo failed integration steps from a saved solution.
 
-static int nstep0;
-static Data_Arr V0, Vs0;
-static double t0, dt0;
+  When ::FAILSAFE is set to \c YES, the solution array (and the
+  staggered magnetic field), the time step structure and the time
+  level are saved by FailSafe_Save() before every step.
+  After the step, FailSafe_Check() looks for
+  - zones where the conversion to primitive variables could not
+    recover a physical state (::FLAG_RESCUE) or produced NaN's.
+    Zones fixed by the pressure or density floors of ConsToPrim()
+    (::FLAG_CONS2PRIM_FAIL alone) are not failures;
+  - a non-zero return value from Integrate();
+  - an advection time step so small that NextTimeStep() would
+    stop the computation.
 
-/* ************************************************************ */
-void SAVE_SOL (Data *d, Grid *grid)
-/*
+  If any of these occurs on any processor, FailSafe_Retry() restores
+  the saved solution and halves the time step.
+  The offending zones and their neighbours are also tagged with
+  ::FLAG_MINMOD and ::FLAG_HLL (see FailSafe_SetFlags()) until the
+  step goes through; these flags are honoured by the reconstruction
+  and the Riemann solvers when ::SHOCK_FLATTENING is \c MULTID.
+  The tags are exchanged between processors, so that zones next to
+  a failure across a sub-domain boundary (ghost zones included) are
+  tagged as well.
+  After ::FAILSAFE_MAX_RETRY unsuccessful attempts the last one is
+  kept, as if ::FAILSAFE was not set.
+
+  Every zone is updated during a step, so the saved copy is a full
+  copy of the arrays (ghost zones included) done with a single
+  memcpy() per array.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#if FAILSAFE == YES
+
+#if NESTED_LEVELS > 0
+ #error FAILSAFE not available with NESTED_LEVELS
+#endif
+
+#ifndef FAILSAFE_MAX_RETRY
+ #define FAILSAFE_MAX_RETRY  4  /**< Maximum number of times a step is
+                                     redone. */
+#endif
+
+static double ****V0;       /**< saved cell-centered primitive variables */
+static double **Vs0;        /**< saved staggered magnetic field */
+static unsigned char ***mask; /**< zones to be integrated with
+                                   FLAG_MINMOD | FLAG_HLL */
+static int    mask_on, nretry;
+static double t0;
+static Time_Step Dts0;
+
+#ifdef STAGGERED_MHD
+static double *StaggeredBlock (double ***, int, size_t *);
+#endif
+
+/* ********************************************************************* */
+void FailSafe_Save (const Data *d, const Time_Step *Dts)
+/*!
+ * Save the solution and the information needed to redo the
+ * current step.
  *
- * Save all necessary information to re-start the 
- * computation at runtime level.
+ * \param [in] d    pointer to Data structure
+ * \param [in] Dts  pointer to Time_Step structure
  *
- ************************************************************** */
+ *********************************************************************** */
 {
-  int i, j, k;
+  int nv;
+  size_t nbox = (size_t)NX3_TOT*NX2_TOT*NX1_TOT, nstag;
+  double *Bs;
 
   if (V0 == NULL){
-    V0 = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+    V0   = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+    mask = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, unsigned char);
+    memset (mask[0][0], 0, nbox);
     #ifdef STAGGERED_MHD
-     Vs0 = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+     Vs0 = ARRAY_2D(DIMENSIONS, (NX3_TOT + 1)*(NX2_TOT + 1)*(NX1_TOT + 1), double);
     #endif
   }
 
-  for (nv = NVAR; nv--;  ){
-  DOM_LOOP(k,j,i){
-    V0[nv][k][j][i] = d->Vc[nv][k][j][i];
-  }}
+  memcpy (V0[0][0][0], d->Vc[0][0][0], NVAR*nbox*sizeof(double));
 
   #ifdef STAGGERED_MHD
-   for (k = KBEG-1; k <= KEND; k++){
-   for (j = JBEG-1; j <= JEND; j++){
-   for (i = IBEG-1; i <= IEND; i++){
-     D_EXPAND(
-       Vs0[BX1s][k][j][i] = d->Vs[BX1s][k][j][i];  ,
-       Vs0[BX2s][k][j][i] = d->Vs[BX2s][k][j][i];  ,
-       Vs0[BX3s][k][j][i] = d->Vs[BX3s][k][j][i];)
-   }}}
+   DIM_LOOP(nv){
+     Bs = StaggeredBlock (d->Vs[nv], nv, &nstag);
+     memcpy (Vs0[nv], Bs, nstag*sizeof(double));
+   }
   #endif
 
-  nstep0 = g_stepNumber; 
-  dt0    = g_dt;
-  t0     = g_time;
+  Dts0 = *Dts;
+  t0   = g_time;
 }
 
-/* ************************************************************ */
-void GET_SOL (Data *d, Grid *grid)
-/*
+/* ********************************************************************* */
+int FailSafe_Check (Data *d, int err, Time_Step *Dts, Runtime *ini,
+                    Grid *grid)
+/*!
+ * Decide whether the step just taken must be redone.
  *
- *  Restore previously saved solution array
+ * \param [in] d     pointer to Data structure
+ * \param [in] err   the value returned by Integrate()
+ * \param [in] Dts   pointer to Time_Step structure
+ * \param [in] ini   pointer to Runtime structure
+ * \param [in] grid  pointer to array of Grid structures
  *
- ************************************************************** */
-
+ * \return 1 if the step must be redone with FailSafe_Retry(),
+ *         0 otherwise.
+ *********************************************************************** */
 {
-  for (nv = NVAR; nv--;  ){
+  int  i, j, k, nv, nfail[2];
+  double inv_dta;
+
+/* --------------------------------------------------------
+    1. Find zones where the step failed (mask bit 2)
+   -------------------------------------------------------- */
+
+  nfail[0] = 0;
+  nfail[1] = (err != 0);
   DOM_LOOP(k,j,i){
-    d->Vc[nv][k][j][i] = V0[nv][k][j][i];
-  }}
+    err = d->flag[k][j][i] & FLAG_RESCUE;
+    NVAR_LOOP(nv) if (d->Vc[nv][k][j][i] != d->Vc[nv][k][j][i]) err = 1;
+    if (!err) continue;
+
+    nfail[0]++;
+    if (nretry < FAILSAFE_MAX_RETRY) mask[k][j][i] |= 2;
+  }
+
+/* --------------------------------------------------------
+    2. The next time step should not be too small
+   -------------------------------------------------------- */
+
+  inv_dta = Dts->inv_dta;
+  #ifdef PARALLEL
+   MPI_Allreduce (&Dts->inv_dta, &inv_dta, 1, MPI_DOUBLE, MPI_MAX,
+                  MPI_COMM_WORLD);
+   MPI_Allreduce (MPI_IN_PLACE, nfail, 2, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  #endif
+  if (ini->cfl < inv_dta*ini->first_dt*1.e-9) nfail[1]++;
+
+/* --------------------------------------------------------
+    3. Accept or redo the step
+   -------------------------------------------------------- */
+
+  if (nfail[0] > 0 && nretry < FAILSAFE_MAX_RETRY){
+
+  /* -- get the failed zones of the neighbour processors in
+        the ghost zones, then tag failed zones and their
+        neighbours (mask bit 1) -- */
+
+    #ifdef PARALLEL
+     AL_Exchange ((char *)mask[0][0], SZ_char);
+    #endif
+    TOT_LOOP(k,j,i){
+      if (!(mask[k][j][i] & 2)) continue;
+      mask[k][j][i] = 1;
+      D_EXPAND(
+        if (i > 0)           mask[k][j][i-1] |= 1;
+        if (i < NX1_TOT - 1) mask[k][j][i+1] |= 1;  ,
+        if (j > 0)           mask[k][j-1][i] |= 1;
+        if (j < NX2_TOT - 1) mask[k][j+1][i] |= 1;  ,
+        if (k > 0)           mask[k-1][j][i] |= 1;
+        if (k < NX3_TOT - 1) mask[k+1][j][i] |= 1;)
+    }
+    mask_on = 1;
+  }
+
+  if (nfail[0] + nfail[1] == 0 || nretry == FAILSAFE_MAX_RETRY){
+    if (nretry == FAILSAFE_MAX_RETRY){
+      print1 ("! FailSafe_Check(): step %d still failing after %d attempts\n",
+               g_stepNumber, nretry + 1);
+    }
+    if (mask_on) TOT_LOOP(k,j,i) mask[k][j][i] = 0;
+    mask_on = 0;
+    nretry  = 0;
+    return 0;
+  }
+
+  print1 ("! FailSafe_Check(): step %d failed (%d zones), re-trying\n",
+           g_stepNumber, nfail[0]);
+  nretry++;
+  return 1;
+}
+
+/* ********************************************************************* */
+void FailSafe_Retry (Data *d, Time_Step *Dts)
+/*!
+ * Restore the solution saved by FailSafe_Save() and halve the
+ * time step.
+ *
+ * \param [out] d    pointer to Data structure
+ * \param [out] Dts  pointer to Time_Step structure
+ *
+ *********************************************************************** */
+{
+  int nv;
+  size_t nbox = (size_t)NX3_TOT*NX2_TOT*NX1_TOT, nstag;
+  double *Bs;
+
+  memcpy (d->Vc[0][0][0], V0[0][0][0], NVAR*nbox*sizeof(double));
 
   #ifdef STAGGERED_MHD
-   for (k = KBEG-1; k <= KEND; k++){
-   for (j = JBEG-1; j <= JEND; j++){
-   for (i = IBEG-1; i <= IEND; i++){
-     D_EXPAND(
-       d->Vs[BX1s][k][j][i] = Vs0[BX1s][k][j][i];  ,
-       d->Vs[BX2s][k][j][i] = Vs0[BX2s][k][j][i];  ,
-       d->Vs[BX3s][k][j][i] = Vs0[BX3s][k][j][i];)
-   }}}
+   DIM_LOOP(nv){
+     Bs = StaggeredBlock (d->Vs[nv], nv, &nstag);
+     memcpy (Bs, Vs0[nv], nstag*sizeof(double));
+   }
   #endif
-  g_stepNumber   = nstep0;
-  g_dt = dt0;
-  t0      = g_time;
 
+  *Dts    = Dts0;
+  g_time  = t0;
+  g_dt   *= 0.5;
+}
+
+/* ********************************************************************* */
+void FailSafe_SetFlags (Data *d)
+/*!
+ * Tag the zones where the previous attempt failed with
+ * ::FLAG_MINMOD and ::FLAG_HLL.
+ *
+ * \param [in,out] d  pointer to Data structure
+ *
+ *********************************************************************** */
+{
+  int i, j, k;
+
+  if (!mask_on) return;
+  TOT_LOOP(k,j,i){
+    if (mask[k][j][i]) d->flag[k][j][i] |= FLAG_MINMOD | FLAG_HLL;
+  }
+}
+
+#ifdef STAGGERED_MHD
+/* ********************************************************************* */
+double *StaggeredBlock (double ***Bs, int nv, size_t *n)
+/*!
+ * Return the first element and the size of the contiguous memory
+ * block holding the staggered component \c nv (allocated with
+ * ArrayBox(), with one more zone below the first one in the
+ * staggered direction).
+ *
+ *********************************************************************** */
+{
+  *n = (size_t)NX3_TOT*NX2_TOT*NX1_TOT;
+  if (nv == BX1s){
+    *n += NX3_TOT*NX2_TOT;
+    return &Bs[0][0][-1];
+  }else if (nv == BX2s){
+    *n += NX3_TOT*NX1_TOT;
+    return &Bs[0][-1][0];
+  }
+  *n += NX2_TOT*NX1_TOT;
+  return &Bs[-1][0][0];
 }
+#endif
 
+#endif
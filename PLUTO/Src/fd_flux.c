@@ -12,6 +12,13 @@
   since high-order reconstruction is done on the characteristic
   projection of the cell-centered fluxes.
 
+  At each interface, the fluxes and conservative variables of the
+  whole stencil are projected once onto the left eigenvectors; the
+  Lax-Friedrichs splitting and the reconstruction are then carried
+  out for all the characteristic fields together (see
+  WENOZ_ReconstructFields() and the like), so that the inner loops
+  run over fields and can be vectorized.
+
   \authors A. Mignone (mignone@ph.unito.it)\n
            P. Tzeferacos (petros.tzeferacos@ph.unito.it)
   \date   April 02, 2015
@@ -41,16 +48,19 @@ void FD_Flux (const State_1D *state, int beg, int end,
  * 
  ****************************************************************** */
 {
-  int    nv, i, j, k, np_tot;
+  int    nv, i, j, k, s, np_tot;
   int    Kmax, S;
   double **v, **flux, *press;
-  double fs, fp, fm, flx[NFLX], dx;
+  double fs, fu, fp, fm, flx[NFLX], dx;
+  double flxp[NFLX], flxm[NFLX];
 
   static double *Fp, *Fm, **F, *a2, **u;
   static double **Uave, **Vave, **lp;
-  double **L, **R;
+  static double **LF, **LU, **Wp, **Wm;
+  double **L, **R, *Lk;
   static double *psim, *Bm; 
   double (*REC)(double *, double, int);
+  Reconstruct_Fields *REC_FIELDS;
 
 /* ------------------------------------------------------------------
            Check compatibility with other modules 
@@ -86,15 +96,19 @@ void FD_Flux (const State_1D *state, int beg, int end,
   dx = grid[g_dir].dx[beg];
   #if RECONSTRUCTION == WENO3_FD
    REC = WENO3_Reconstruct;
+   REC_FIELDS = WENO3_ReconstructFields;
    S   = 1;
   #elif RECONSTRUCTION == LIMO3_FD
    REC = LIMO3_Reconstruct;
+   REC_FIELDS = LIMO3_ReconstructFields;
    S   = 1;
   #elif RECONSTRUCTION == WENOZ_FD
    REC = WENOZ_Reconstruct;
+   REC_FIELDS = WENOZ_ReconstructFields;
    S   = 2;
   #elif RECONSTRUCTION == MP5_FD
    REC = MP5_Reconstruct;
+   REC_FIELDS = MP5_ReconstructFields;
    S   = 2;
   #endif
   
@@ -109,6 +123,10 @@ void FD_Flux (const State_1D *state, int beg, int end,
     Uave = ARRAY_2D(NMAX_POINT, NVAR, double);
     Vave = ARRAY_2D(NMAX_POINT, NVAR, double);
     u    = ARRAY_2D(NMAX_POINT, NVAR, double);
+    LF   = ARRAY_2D(6, NFLX, double);
+    LU   = ARRAY_2D(6, NFLX, double);
+    Wp   = ARRAY_2D(5, NFLX, double);
+    Wm   = ARRAY_2D(5, NFLX, double);
   }
 
   np_tot = grid[g_dir].np_tot;
@@ -200,17 +218,17 @@ void FD_Flux (const State_1D *state, int beg, int end,
          Compute eigenvectors and eigenvalues
    ---------------------------------------------------- */
 
+  fs = 0.0;
+  for (k = Kmax; k--;     ){
+    fs = MAX(fs, fabs(state->lmax[k]));
+  }  
+  cmax[0] = MAX(cmax[0], fs);
+
   for (i = beg; i <= end; i++){
     L = state->Lp[i];
     R = state->Rp[i];
 
     ConsEigenvectors(Uave[i], Vave[i], a2[i], L, R, lp[i]);
-
-    fs = 0.0;
-    for (k = Kmax; k--;     ){
-      fs = MAX(fs, fabs(state->lmax[k]));
-    }  
-    cmax[0] = MAX(cmax[0], fs);
     cmax[i] = fs;
   }
 
@@ -224,30 +242,50 @@ void FD_Flux (const State_1D *state, int beg, int end,
 
     a is the global maximum eigenvalue for the k-th 
     characteristic.
-    Reconstruct F_{+,j} and F_{-,j}.
+    L.F and L.u are computed once on the 2S+2 zones
+    i-S <= j <= i+S+1 shared by F_+ and F_-; F_- is stored
+    mirrored about i+1/2 (j' = 2i+1-j), so that both are
+    reconstructed with the same stencil for all k at once.
    --------------------------------------------------------- */
 
   for (i = beg; i <= end; i++){
     L = state->Lp[i];
     R = state->Rp[i];
 
-    for (k = 0; k < Kmax; k++){
-      fs = state->lmax[k];
-      for (j = i-S; j <= i+S; j++) {
-        Fp[j] = Fm[j] = 0.0;
-        for (nv = NFLX; nv--;   ){ /* -- LF flux splitting -- */
-          Fp[j] += 0.5*L[k][nv]*(F[j][nv]       + fs*u[j][nv]);
-          Fm[j] += 0.5*L[k][nv]*(F[2*i-j+1][nv] - fs*u[2*i-j+1][nv]);
+    for (s = 0; s <= 2*S + 1; s++){
+      j = i - S + s;
+      for (k = 0; k < Kmax; k++){
+        Lk = L[k];
+        fs = fu = 0.0;
+        for (nv = 0; nv < NFLX; nv++){
+          fs += Lk[nv]*F[j][nv];
+          fu += Lk[nv]*u[j][nv];
         }
+        LF[s][k] = fs;
+        LU[s][k] = fu;
+      }
+    }
+
+    for (s = 0; s <= 2*S; s++){  /* -- LF flux splitting -- */
+      for (k = 0; k < Kmax; k++){
+        fs = state->lmax[k];
+        Wp[s][k] = 0.5*(LF[s][k]           + fs*LU[s][k]);
+        Wm[s][k] = 0.5*(LF[2*S + 1 - s][k] - fs*LU[2*S + 1 - s][k]);
       }
-      #if SHOCK_FLATTENING == MULTID
-       if ( (state->flag[i] & FLAG_MINMOD) || (state->flag[i+1] & FLAG_MINMOD)){
-         fs = LIN_Reconstruct(Fp, dx, i) + LIN_Reconstruct(Fm, dx, i); 
-       }else
-      #endif
-      flx[k] = REC(Fp, dx, i) + REC(Fm, dx,i);
     }
 
+    #if SHOCK_FLATTENING == MULTID
+     if ( (state->flag[i] & FLAG_MINMOD) || (state->flag[i+1] & FLAG_MINMOD)){
+       LIN_ReconstructFields (Wp + S, dx, Kmax, flxp);
+       LIN_ReconstructFields (Wm + S, dx, Kmax, flxm);
+     }else
+    #endif
+    {
+      REC_FIELDS (Wp + S, dx, Kmax, flxp);
+      REC_FIELDS (Wm + S, dx, Kmax, flxm);
+    }
+    for (k = 0; k < Kmax; k++) flx[k] = flxp[k] + flxm[k];
+
     for (nv = 0; nv < NFLX; nv++){
       fs = 0.0;
       for (k=0; k < Kmax; k++) fs += flx[k]*R[nv][k];
@@ -297,37 +335,68 @@ void FD_GetMaxEigenvalues (const Data *d, State_1D *state, Grid *grid)
  *   Compute, for each characteristic wave, its maximum over
  *   the entire computational domain
  *
+ *   With unsplit integration the solution does not change
+ *   between the sweeps of a stage; the maxima for all
+ *   directions are then computed in a single pass (and a
+ *   single reduction) when g_dir == IDIR and reused for the
+ *   other directions.
  *
  *********************************************************************** */
 {
-  int  i, j, k, nv;
-  double *x1, *x2, *x3;
+  int  i, j, k, nv, dir, dir0, dir1;
   static double **v, **lambda, *a2;
+  static double lmax[3][NFLX];
+  Index indx;
   
   if (v == NULL){
-    v      = ARRAY_2D(NMAX_POINT, NFLX, double);
+    v      = ARRAY_2D(NMAX_POINT, NVAR, double);
     lambda = ARRAY_2D(NMAX_POINT, NFLX, double);
     a2     = ARRAY_1D(NMAX_POINT, double);
   }
 
   for (nv = NVAR; nv--;  ) state->lmax[nv] = 0.0;
 
-  x1 = grid[IDIR].x;
-  x2 = grid[JDIR].x;
-  x3 = grid[KDIR].x;
+  #if DIMENSIONAL_SPLITTING == NO
+   if (g_dir != IDIR){
+     for (nv = 0; nv < NFLX; nv++) state->lmax[nv] = lmax[g_dir][nv];
+     return;
+   }
+   dir0 = 0;
+   dir1 = DIMENSIONS - 1;
+  #else
+   dir0 = dir1 = g_dir;
+  #endif
+
+  for (dir = dir0; dir <= dir1; dir++){
+    for (nv = 0; nv < NFLX; nv++) lmax[dir][nv] = 0.0;
+  }
 
   KDOM_LOOP(k) JDOM_LOOP(j){
     IDOM_LOOP(i) for (nv = NVAR; nv--;  ) v[i][nv] = d->Vc[nv][k][j][i];
     SoundSpeed2  (v, a2, NULL, IBEG, IEND, CELL_CENTER, grid);
-    Eigenvalues  (v, a2, lambda, IBEG, IEND);
-    IDOM_LOOP(i){
-      for (nv = NFLX; nv--;  ) 
-        state->lmax[nv] = MAX(fabs(lambda[i][nv]), state->lmax[nv]);
+    for (dir = dir0; dir <= dir1; dir++){
+      if (dir1 > dir0) {
+        g_dir = dir;
+        SetIndexes (&indx, grid);
+      }
+      Eigenvalues  (v, a2, lambda, IBEG, IEND);
+      IDOM_LOOP(i){
+        for (nv = NFLX; nv--;  ) 
+          lmax[dir][nv] = MAX(fabs(lambda[i][nv]), lmax[dir][nv]);
+      }
     }
   }
 
+/* -- restore the indexes of the current direction -- */
+
+  if (dir1 > dir0){
+    g_dir = dir0;
+    SetIndexes (&indx, grid);
+  }
+
   #ifdef PARALLEL
-   MPI_Allreduce (state->lmax, lambda[0], NFLX, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
-   for (nv = 0; nv < NFLX; nv++) state->lmax[nv] = lambda[0][nv];
+   MPI_Allreduce (MPI_IN_PLACE, lmax[dir0], (dir1 - dir0 + 1)*NFLX,
+                  MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
   #endif
+  for (nv = 0; nv < NFLX; nv++) state->lmax[nv] = lmax[g_dir][nv];
 }
@@ -11,46 +11,71 @@ double MP5_Reconstruct(double *F, double dx, int j)
  *
  ************************************************************************* */
 {
+  double f, *Fs[5];
+
+  Fs[0] = F + j - 2; Fs[1] = F + j - 1; Fs[2] = F + j;
+  Fs[3] = F + j + 1; Fs[4] = F + j + 2;
+  MP5_ReconstructFields (Fs + 2, dx, 1, &f);
+  return f;
+}
+
+/* *********************************************************************** */
+void MP5_ReconstructFields(double **F, double dx, int n, double *fr)
+/*  
+ *
+ *  Same as MP5_Reconstruct() for the n fields F[s][0..n-1],
+ *  s = -2,...,2 being the stencil position relative to the
+ *  interpolation point.
+ *  The interface values are stored in fr[0..n-1].
+ *
+ ************************************************************************* */
+{
+  int k;
   double f, d2, d2p, d2m; 
   double dMMm, dMMp;
   double scrh1,scrh2, fmin, fmax; 
   double fAV, fMD, fLC, fUL, fMP;
+  double *Fm2 = F[-2], *Fm1 = F[-1], *F0 = F[0], *Fp1 = F[1], *Fp2 = F[2];
   static double alpha = 4.0, epsm = 1.e-12;
 
-  f  = 2.0*F[j-2] - 13.0*F[j-1] + 47.0*F[j] + 27.0*F[j+1] - 3.0*F[j+2];
-  f /= 60.0;   
+  for (k = 0; k < n; k++){
+    f  = 2.0*Fm2[k] - 13.0*Fm1[k] + 47.0*F0[k] + 27.0*Fp1[k] - 3.0*Fp2[k];
+    f /= 60.0;   
 
-  fMP = F[j] + MINMOD(F[j+1]-F[j],alpha*(F[j]-F[j-1]));
+    fMP = F0[k] + MINMOD(Fp1[k]-F0[k],alpha*(F0[k]-Fm1[k]));
 
-  if ((f - F[j])*(f - fMP) <= epsm) return f;
+    if ((f - F0[k])*(f - fMP) <= epsm) {
+      fr[k] = f;
+      continue;
+    }
 
-  d2m = F[j-2] + F[j  ] - 2.0*F[j-1];    /* -- Eq. (2.19) -- */
-  d2  = F[j-1] + F[j+1] - 2.0*F[j];
-  d2p = F[j  ] + F[j+2] - 2.0*F[j+1];    /* -- Eq. (2.19) -- */
+    d2m = Fm2[k] + F0[k]  - 2.0*Fm1[k];    /* -- Eq. (2.19) -- */
+    d2  = Fm1[k] + Fp1[k] - 2.0*F0[k];
+    d2p = F0[k]  + Fp2[k] - 2.0*Fp1[k];    /* -- Eq. (2.19) -- */
 
-  scrh1 = MINMOD(4.0*d2 - d2p, 4.0*d2p - d2);
-  scrh2 = MINMOD(d2, d2p);
-  dMMp  = MINMOD(scrh1,scrh2);   /* -- Eq. (2.27) -- */
+    scrh1 = MINMOD(4.0*d2 - d2p, 4.0*d2p - d2);
+    scrh2 = MINMOD(d2, d2p);
+    dMMp  = MINMOD(scrh1,scrh2);   /* -- Eq. (2.27) -- */
 
-  scrh1 = MINMOD(4.0*d2m - d2, 4.0*d2 - d2m);
-  scrh2 = MINMOD(d2, d2m);
-  dMMm  = MINMOD(scrh1,scrh2);   /* -- Eq. (2.27) -- */
+    scrh1 = MINMOD(4.0*d2m - d2, 4.0*d2 - d2m);
+    scrh2 = MINMOD(d2, d2m);
+    dMMm  = MINMOD(scrh1,scrh2);   /* -- Eq. (2.27) -- */
 
-  fUL = F[j] + alpha*(F[j] - F[j-1]);   /* -- Eq. (2.8) -- */
-  fAV = 0.5*(F[j] + F[j+1]);        /* -- Eq. (2.16) -- */
-  fMD = fAV - 0.5*dMMp; /* -- Eq. (2.28) -- */
-  fLC = 0.5*(3.0*F[j] - F[j-1]) + 4.0/3.0*dMMm;  /* -- Eq. (2.29) -- */
+    fUL = F0[k] + alpha*(F0[k] - Fm1[k]);   /* -- Eq. (2.8) -- */
+    fAV = 0.5*(F0[k] + Fp1[k]);        /* -- Eq. (2.16) -- */
+    fMD = fAV - 0.5*dMMp; /* -- Eq. (2.28) -- */
+    fLC = 0.5*(3.0*F0[k] - Fm1[k]) + 4.0/3.0*dMMm;  /* -- Eq. (2.29) -- */
 
-  scrh1 = MIN(F[j], F[j+1]); scrh1 = MIN(scrh1, fMD);
-  scrh2 = MIN(F[j], fUL);    scrh2 = MIN(scrh2, fLC);
-  fmin  = MAX(scrh1, scrh2);  /* -- Eq. (2.24a) -- */
+    scrh1 = MIN(F0[k], Fp1[k]); scrh1 = MIN(scrh1, fMD);
+    scrh2 = MIN(F0[k], fUL);    scrh2 = MIN(scrh2, fLC);
+    fmin  = MAX(scrh1, scrh2);  /* -- Eq. (2.24a) -- */
 
-  scrh1 = MAX(F[j], F[j+1]); scrh1 = MAX(scrh1, fMD);
-  scrh2 = MAX(F[j], fUL);    scrh2 = MAX(scrh2, fLC);
-  fmax  = MIN(scrh1, scrh2);  /* -- Eq. (2.24b) -- */
+    scrh1 = MAX(F0[k], Fp1[k]); scrh1 = MAX(scrh1, fMD);
+    scrh2 = MAX(F0[k], fUL);    scrh2 = MAX(scrh2, fLC);
+    fmax  = MIN(scrh1, scrh2);  /* -- Eq. (2.24b) -- */
 
-  f = Median(f, fmin, fmax); /* -- Eq. (2.26) -- */
-  return f;
+    fr[k] = Median(f, fmin, fmax); /* -- Eq. (2.26) -- */
+  }
 }
 
 /* ************************************************************* */
@@ -107,34 +132,54 @@ double LIMO3_Reconstruct(double *v, double dx,  int i)
  *
  *************************************************************** */
 {
+  double f, *vs[3];
+
+  vs[0] = v + i - 1; vs[1] = v + i; vs[2] = v + i + 1;
+  LIMO3_ReconstructFields (vs + 1, dx, 1, &f);
+  return f;
+}
+
+/* ************************************************************* */
+void LIMO3_ReconstructFields(double **v, double dx, int n, double *fr)
+/*
+ *
+ *  Same as LIMO3_Reconstruct() for the n fields v[s][0..n-1],
+ *  s = -1,0,1.
+ *
+ *************************************************************** */
+{
+  int k;
   double dvp, dvm, r = 1.;
   double a,b,c,q, th, lim;
   double eta, psi, eps = 1.e-12;
-
-  dvp = v[i+1] - v[i];
-  dvm = v[i] - v[i-1];
-
-  th  = dvm/(dvp + 1.e-16);
-
-  q = (2.0 + th)/3.0;
-  a = MIN(1.5,2.0*th);
-  a = MIN(q,a);
-  b = MAX(-0.5*th,a);
-  c = MIN(q,b);
-  psi = MAX(0.0,c);
-
-  eta = r*dx;
-  eta = (dvm*dvm + dvp*dvp)/(eta*eta);
-  if ( eta <= 1.0 - eps) {
-    lim = q;
-  }else if (eta >= 1.0 + eps){
-    lim = psi;
-  }else{
-    psi =   (1.0 - (eta - 1.0)/eps)*q
-          + (1.0 + (eta - 1.0)/eps)*psi;
-    lim = 0.5*psi;
+  double *vm1 = v[-1], *v0 = v[0], *vp1 = v[1];
+
+  for (k = 0; k < n; k++){
+    dvp = vp1[k] - v0[k];
+    dvm = v0[k] - vm1[k];
+
+    th  = dvm/(dvp + 1.e-16);
+
+    q = (2.0 + th)/3.0;
+    a = MIN(1.5,2.0*th);
+    a = MIN(q,a);
+    b = MAX(-0.5*th,a);
+    c = MIN(q,b);
+    psi = MAX(0.0,c);
+
+    eta = r*dx;
+    eta = (dvm*dvm + dvp*dvp)/(eta*eta);
+    if ( eta <= 1.0 - eps) {
+      lim = q;
+    }else if (eta >= 1.0 + eps){
+      lim = psi;
+    }else{
+      psi =   (1.0 - (eta - 1.0)/eps)*q
+            + (1.0 + (eta - 1.0)/eps)*psi;
+      lim = 0.5*psi;
+    }
+    fr[k] = v0[k] + 0.5*dvp*lim;
   }
-  return (v[i] + 0.5*dvp*lim);
 }
 /* *********************************************************************** */
 double WENOZ_Reconstruct(double *F, double dx,  int j)
@@ -147,45 +192,65 @@ double WENOZ_Reconstruct(double *F, double dx,  int j)
  *
  *
  ************************************************************************* */
-#define eps 1.e-6
 {
-  double IS0, IS1, IS2, IS3, IS4, IS5;
+  double f, *Fs[5];
+
+  Fs[0] = F + j - 2; Fs[1] = F + j - 1; Fs[2] = F + j;
+  Fs[3] = F + j + 1; Fs[4] = F + j + 2;
+  WENOZ_ReconstructFields (Fs + 2, dx, 1, &f);
+  return f;
+}
+
+/* *********************************************************************** */
+void WENOZ_ReconstructFields(double **F, double dx, int n, double *fr)
+/*  
+ *
+ *  Same as WENOZ_Reconstruct() for the n fields F[s][0..n-1],
+ *  s = -2,...,2.
+ *  There are no branches, so the loop on the fields can be
+ *  vectorized by the compiler.
+ *
+ ************************************************************************* */
+{
+  int k;
   double a0, a1, a2;
   double f0, f1, f2;
   double w0, w1, w2;
-  double sum_a, f;
+  double sum_a;
   static double thirteen_12 = 13.0/12.0;
   double b0, b1, b2,t5;
+  double *Fm2 = F[-2], *Fm1 = F[-1], *F0 = F[0], *Fp1 = F[1], *Fp2 = F[2];
 
-  a0 = F[j-2] - 2.0*F[j-1] +     F[j]; 
-  a1 = F[j-2] - 4.0*F[j-1] + 3.0*F[j]; 
-  b0 = thirteen_12*a0*a0 + 0.25*a1*a1;
+  for (k = 0; k < n; k++){
+    a0 = Fm2[k] - 2.0*Fm1[k] +     F0[k]; 
+    a1 = Fm2[k] - 4.0*Fm1[k] + 3.0*F0[k]; 
+    b0 = thirteen_12*a0*a0 + 0.25*a1*a1;
 
-  a0 = F[j-1] - 2.0*F[j] + F[j+1]; 
-  a1 = F[j-1] - F[j+1]; 
-  b1 = thirteen_12*a0*a0 + 0.25*a1*a1;
+    a0 = Fm1[k] - 2.0*F0[k] + Fp1[k]; 
+    a1 = Fm1[k] - Fp1[k]; 
+    b1 = thirteen_12*a0*a0 + 0.25*a1*a1;
 
-  a0 =     F[j] - 2.0*F[j+1] + F[j+2]; 
-  a1 = 3.0*F[j] - 4.0*F[j+1] + F[j+2]; 
-  b2 = thirteen_12*a0*a0 + 0.25*a1*a1;
+    a0 =     F0[k] - 2.0*Fp1[k] + Fp2[k]; 
+    a1 = 3.0*F0[k] - 4.0*Fp1[k] + Fp2[k]; 
+    b2 = thirteen_12*a0*a0 + 0.25*a1*a1;
 
-  t5 = fabs(b0-b2);
+    t5 = fabs(b0-b2);
 
-  a0 = 1.0*(1.0 + t5/(b0 + 1.e-40));
-  a1 = 6.0*(1.0 + t5/(b1 + 1.e-40));
-  a2 = 3.0*(1.0 + t5/(b2 + 1.e-40));
+    a0 = 1.0*(1.0 + t5/(b0 + 1.e-40));
+    a1 = 6.0*(1.0 + t5/(b1 + 1.e-40));
+    a2 = 3.0*(1.0 + t5/(b2 + 1.e-40));
 
-  sum_a = 1.0/(a0 + a1 + a2);
-  w0 = a0*sum_a;
-  w1 = a1*sum_a;
-  w2 = a2*sum_a;
+    sum_a = 1.0/(a0 + a1 + a2);
+    w0 = a0*sum_a;
+    w1 = a1*sum_a;
+    w2 = a2*sum_a;
 
-  f0 = (2.0*F[j-2] - 7.0*F[j-1] + 11.0*F[j]);
-  f1 = (   -F[j-1] + 5.0*F[j]   +  2.0*F[j+1]);
-  f2 = (2.0*F[j]   + 5.0*F[j+1] -      F[j+2]);
+    f0 = (2.0*Fm2[k] - 7.0*Fm1[k] + 11.0*F0[k]);
+    f1 = (   -Fm1[k] + 5.0*F0[k]   +  2.0*Fp1[k]);
+    f2 = (2.0*F0[k]  + 5.0*Fp1[k] -      Fp2[k]);
 
-  f = (w0*f0 + w1*f1 + w2*f2)/6.0;
-  return(f);
+    fr[k] = (w0*f0 + w1*f1 + w2*f2)/6.0;
+  }
 }
 
 /* *********************************************************************** */
@@ -200,42 +265,61 @@ double WENO3_Reconstruct(double *F, double dx, int j)
  *
  ************************************************************************* */
 {
+  double f, *Fs[3];
+
+  Fs[0] = F + j - 1; Fs[1] = F + j; Fs[2] = F + j + 1;
+  WENO3_ReconstructFields (Fs + 1, dx, 1, &f);
+  return f;
+}
+
+/* *********************************************************************** */
+void WENO3_ReconstructFields(double **F, double dx, int n, double *fr)
+/*  
+ *
+ *  Same as WENO3_Reconstruct() for the n fields F[s][0..n-1],
+ *  s = -1,0,1.
+ *
+ ************************************************************************* */
+{
+  int k;
   double a0, b0, w0, f0, a1, b1, w1, f1;
   double tau, dx2;
+  double *Fm1 = F[-1], *F0 = F[0], *Fp1 = F[1];
 
   dx2 = dx*dx;
 
-  b0 = F[j+1] - F[j];
-  b1 = F[j-1] - F[j];
+  for (k = 0; k < n; k++){
+    b0 = Fp1[k] - F0[k];
+    b1 = Fm1[k] - F0[k];
 
-  b0 = b0*b0;
-  b1 = b1*b1;
+    b0 = b0*b0;
+    b1 = b1*b1;
 
-/* -- traditional version -- */
+  /* -- traditional version -- */
 
-/*
-  a0 = eps + b0;
-  a1 = eps + b1;
+  /*
+    a0 = eps + b0;
+    a1 = eps + b1;
   
-  a0 = 2.0/(a0*a0);
-  a1 = 1.0/(a1*a1);
-*/
-/* -- improved version -- */
+    a0 = 2.0/(a0*a0);
+    a1 = 1.0/(a1*a1);
+  */
+  /* -- improved version -- */
 
-  tau = (F[j+1] - 2.0*F[j] + F[j-1]);
-  tau = tau*tau;
+    tau = (Fp1[k] - 2.0*F0[k] + Fm1[k]);
+    tau = tau*tau;
 
-  a0 = 2.0*(1.0 + tau/(dx2 + b0));
-  a1 = 1.0*(1.0 + tau/(dx2 + b1));
+    a0 = 2.0*(1.0 + tau/(dx2 + b0));
+    a1 = 1.0*(1.0 + tau/(dx2 + b1));
 
-  w0 = a0/(a0 + a1);
-  w1 = a1/(a0 + a1);
+    w0 = a0/(a0 + a1);
+    w1 = a1/(a0 + a1);
 
-  f0 =  0.5*( F[j+1] +     F[j]);
-  f1 =  0.5*(-F[j-1] + 3.0*F[j]);
-  return (w0*f0 + w1*f1);
+    f0 =  0.5*( Fp1[k] +     F0[k]);
+    f1 =  0.5*(-Fm1[k] + 3.0*F0[k]);
+    fr[k] = w0*f0 + w1*f1;
+  }
 }
-#undef eps
 
 
 /* *********************************************************************** */
@@ -250,13 +334,32 @@ double LIN_Reconstruct(double *F, double dx, int j)
  *
  ************************************************************************* */
 {
+  double f, *Fs[3];
+
+  Fs[0] = F + j - 1; Fs[1] = F + j; Fs[2] = F + j + 1;
+  LIN_ReconstructFields (Fs + 1, dx, 1, &f);
+  return f;
+}
+
+/* *********************************************************************** */
+void LIN_ReconstructFields(double **F, double dx, int n, double *fr)
+/*  
+ *
+ *  Same as LIN_Reconstruct() for the n fields F[s][0..n-1],
+ *  s = -1,0,1.
+ *
+ ************************************************************************* */
+{
+  int k;
   double dFp, dFm, dF;
 
-  dFp = F[j+1] - F[j];
-  dFm = F[j] - F[j-1];
+  for (k = 0; k < n; k++){
+    dFp = F[1][k] - F[0][k];
+    dFm = F[0][k] - F[-1][k];
 
-  dF = MINMOD(dFp, dFm);
-  return (F[j] + 0.5*dF);
+    dF = MINMOD(dFp, dFm);
+    fr[k] = F[0][k] + 0.5*dF;
+  }
 }
 
 
@@ -0,0 +1,220 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Static internal boundary stored as a list of row spans.
+
+  When ::INTERNAL_BOUNDARY_STATIC is set to \c YES, the internal
+  boundary region and the values imposed inside it are declared only
+  once: the first time Boundary() is invoked on a given grid,
+  UserDefBoundary() is called with \c side == 0 as usual and the zones
+  flagged with ::FLAG_INTERNAL_BOUNDARY are collected by
+  InternalBoundaryStore() into spans <tt> [ib,ie] </tt> of contiguous
+  zones along the \f$x_1\f$ direction, one or more per \c (k,j) row.
+  The variables assigned by UserDefBoundary() in these zones are
+  saved as well: they are found by calling UserDefBoundary() a second
+  time with the flagged zones filled with a sentinel value, so
+  UserDefBoundary() must not depend on the values it overwrites.
+  Variables left untouched (e.g. tracers or magnetic field components
+  not prescribed by the wind) keep evolving as with the non-static
+  internal boundary.
+
+  At subsequent calls, InternalBoundaryImpose() re-imposes the
+  saved values and the flag by copying one span at a time, without
+  calling UserDefBoundary() and without repeating the geometrical
+  tests on every zone of the local domain.
+
+  This is appropriate whenever the flagged region and the values
+  assigned therein do not change in time (e.g. a stellar wind
+  injected at constant rate).
+  Values assigned by UserDefBoundary() outside the flagged zones are
+  only set at the first call.
+  A separate mask is kept for each grid (e.g. for every level of
+  nested grids).
+  Static masks cannot be used with Chombo, where the patch grid
+  structure is re-defined at every regrid.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#if (INTERNAL_BOUNDARY == YES) && (INTERNAL_BOUNDARY_STATIC == YES)
+
+#ifdef STAGGERED_MHD
+ #error INTERNAL_BOUNDARY_STATIC not available with STAGGERED_MHD
+#endif
+
+#ifdef CHOMBO
+ #error INTERNAL_BOUNDARY_STATIC not available with CHOMBO
+#endif
+
+#define IB_SENTINEL  (-1.234567890123e300)  /**< marks zones not yet
+                                                 assigned */
+
+typedef struct IB_MASK{
+  const Grid *grid;   /**< the grid the mask refers to */
+  int    nspan;       /**< number of spans */
+  int    ncell;       /**< total number of zones in the spans */
+  int   *k, *j;       /**< row indices of each span */
+  int   *ib, *ie;     /**< first and last x1-index of each span */
+  int    nq;          /**< number of variables set by UserDefBoundary() */
+  int    var[NVAR];   /**< indices of these variables */
+  double **q;         /**< saved values, q[n][ncell] for var[n] */
+  struct IB_MASK *next;
+} IB_Mask;
+
+static IB_Mask *ib_list = NULL;
+
+static IB_Mask *GetMask (const Grid *);
+
+/* ********************************************************************* */
+int InternalBoundaryIsSet (const Grid *grid)
+/*!
+ * Return 1 if the internal boundary mask for \c grid has already
+ * been stored, 0 otherwise.
+ *
+ *********************************************************************** */
+{
+  return GetMask(grid) != NULL;
+}
+
+/* ********************************************************************* */
+void InternalBoundaryStore (const Data *d, const Grid *grid)
+/*!
+ * Collect zones flagged with ::FLAG_INTERNAL_BOUNDARY in the whole
+ * local domain (ghost zones included) into spans and save the
+ * variables that UserDefBoundary() assigns in them.
+ * Must be called right after UserDefBoundary() with \c side == 0.
+ *
+ * \param [in] d     pointer to Data structure
+ * \param [in] grid  pointer to an array of Grid structures
+ *
+ *********************************************************************** */
+{
+  int  i, j, k, nv, n, s, m;
+  int  set[NVAR];
+  unsigned char ***flag = d->flag;
+  IB_Mask *M;
+
+/* --------------------------------------------------------
+    1. Count spans and zones
+   -------------------------------------------------------- */
+
+  M = (IB_Mask *) malloc (sizeof(IB_Mask));
+  M->grid  = grid;
+  M->nspan = M->ncell = 0;
+  KTOT_LOOP(k) JTOT_LOOP(j) ITOT_LOOP(i){
+    if (!(flag[k][j][i] & FLAG_INTERNAL_BOUNDARY)) continue;
+    M->ncell++;
+    if (i == 0 || !(flag[k][j][i-1] & FLAG_INTERNAL_BOUNDARY)) M->nspan++;
+  }
+
+  n = MAX(M->nspan, 1);
+  M->k  = ARRAY_1D(n, int);
+  M->j  = ARRAY_1D(n, int);
+  M->ib = ARRAY_1D(n, int);
+  M->ie = ARRAY_1D(n, int);
+  M->q  = ARRAY_2D(NVAR, MAX(M->ncell, 1), double);
+
+/* --------------------------------------------------------
+    2. Fill span indices, save values and replace them
+       with the sentinel
+   -------------------------------------------------------- */
+
+  s = -1;
+  m = 0;
+  KTOT_LOOP(k) JTOT_LOOP(j) ITOT_LOOP(i){
+    if (!(flag[k][j][i] & FLAG_INTERNAL_BOUNDARY)) continue;
+    if (i == 0 || !(flag[k][j][i-1] & FLAG_INTERNAL_BOUNDARY)){
+      s++;
+      M->k[s]  = k;
+      M->j[s]  = j;
+      M->ib[s] = i;
+    }
+    M->ie[s] = i;
+    NVAR_LOOP(nv) {
+      M->q[nv][m] = d->Vc[nv][k][j][i];
+      d->Vc[nv][k][j][i] = IB_SENTINEL;
+    }
+    m++;
+  }
+
+/* --------------------------------------------------------
+    3. Find which variables are assigned by calling
+       UserDefBoundary() again, then restore all values
+   -------------------------------------------------------- */
+
+  UserDefBoundary (d, NULL, 0, (Grid *) grid);
+
+  for (nv = 0; nv < NVAR; nv++) set[nv] = 0;
+  m = 0;
+  for (s = 0; s < M->nspan; s++){
+    k = M->k[s];
+    j = M->j[s];
+    for (i = M->ib[s]; i <= M->ie[s]; i++, m++) NVAR_LOOP(nv){
+      if (d->Vc[nv][k][j][i] != IB_SENTINEL) set[nv] = 1;
+      d->Vc[nv][k][j][i] = M->q[nv][m];
+    }
+  }
+
+/* --------------------------------------------------------
+    4. Keep only the assigned variables
+   -------------------------------------------------------- */
+
+  M->nq = 0;
+  for (nv = 0; nv < NVAR; nv++){
+    if (!set[nv]) continue;
+    M->var[M->nq] = nv;
+    if (M->nq != nv) memcpy (M->q[M->nq], M->q[nv], M->ncell*sizeof(double));
+    M->nq++;
+  }
+
+  M->next = ib_list;
+  ib_list = M;
+}
+
+/* ********************************************************************* */
+void InternalBoundaryImpose (const Data *d, const Grid *grid)
+/*!
+ * Re-impose the values saved by InternalBoundaryStore() and turn
+ * the ::FLAG_INTERNAL_BOUNDARY bit on in the masked zones.
+ *
+ * \param [in,out] d     pointer to Data structure
+ * \param [in]     grid  pointer to an array of Grid structures
+ *
+ *********************************************************************** */
+{
+  int  i, j, k, n, nv, s, m, len;
+  IB_Mask *M = GetMask(grid);
+
+  m = 0;
+  for (s = 0; s < M->nspan; s++){
+    k   = M->k[s];
+    j   = M->j[s];
+    len = M->ie[s] - M->ib[s] + 1;
+    for (n = 0; n < M->nq; n++){
+      nv = M->var[n];
+      memcpy (d->Vc[nv][k][j] + M->ib[s], M->q[n] + m, len*sizeof(double));
+    }
+    for (i = M->ib[s]; i <= M->ie[s]; i++){
+      d->flag[k][j][i] |= FLAG_INTERNAL_BOUNDARY;
+    }
+    m += len;
+  }
+}
+
+/* ********************************************************************* */
+IB_Mask *GetMask (const Grid *grid)
+/*!
+ * Return the mask associated with \c grid or NULL if none exists.
+ *
+ *********************************************************************** */
+{
+  IB_Mask *M;
+
+  for (M = ib_list; M != NULL; M = M->next){
+    if (M->grid == grid) return M;
+  }
+  return NULL;
+}
+#endif
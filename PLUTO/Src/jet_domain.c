@@ -1,7 +1,8 @@
 /* ///////////////////////////////////////////////////////////////////// */
 /*!
   \file
-  \brief Adjust the effective domain size when the -xNjet option is given.
+  \brief Adjust the effective domain size when the -xNjet or 
+         -active-domain options are given.
 
   The SetJetDomain() function shortens the domain integration index in the 
   direction specified by either '\c -x1jet', '\c -x2jet' or '\c -x3jet' to save 
@@ -13,8 +14,26 @@
   size.
   Useful for problems involving jet propagation.
 
+  SetActiveDomain() generalizes this approach to disturbances expanding
+  in any direction (e.g. blast waves or wind bubbles propagating in a
+  uniform medium): the integration range is reduced, in every
+  direction, to the bounding box of the zones where any primitive
+  variable differs from its neighbours (ActiveDomainDisturbed()),
+  enlarged by ::ACTIVE_DOMAIN_GUARD ghost-zone widths.
+  Zones outside the box are neither updated nor used for the time step
+  and physical boundaries are not applied on sides that have not yet
+  been reached.
+  The bounding box is computed independently by each processor, so that
+  processors owning pristine portions of the domain do (almost) no work.
+  UnsetActiveDomain() restores the full domain before output.
+  Since zones outside the box are frozen, a uniform medium must be
+  an exact stationary solution: -active-domain is rejected by
+  ParseCmdLineArgs() when cooling, body forces or a rotating frame
+  are enabled.
+
   \note In parallel, the domain is \e not decomposed along the
-        propagation direction (see ParseCmdLineArgs()).
+        propagation direction (see ParseCmdLineArgs()) when -xNjet is
+        used.
   
   \author A. Mignone (mignone@ph.unito.it)
   \date   Dec 24, 2014
@@ -22,9 +41,30 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
 
+/* ---------------------------------------------------------------
+    ACTIVE_DOMAIN_EPS is the relative jump between neighbour zones
+    above which a zone is considered disturbed.
+    ACTIVE_DOMAIN_GUARD is the number of ghost-zone widths added on
+    each side of the disturbed region: it must cover the distance
+    travelled by a perturbation during one step (one stencil per
+    stage) plus one stage of lag in the parallel ghost zones.
+   --------------------------------------------------------------- */
+
+#ifndef ACTIVE_DOMAIN_EPS
+ #define ACTIVE_DOMAIN_EPS    1.e-5
+#endif
+
+#ifndef ACTIVE_DOMAIN_GUARD
+ #define ACTIVE_DOMAIN_GUARD  4
+#endif
+
 static int jd_nbeg, jd_nend, jd_npt, jd_ntot, rbound;
 static int GetRightmostIndex(int, double ***);
 
+static int ad_beg[3], ad_end[3], ad_npt[3], ad_ntot[3];
+static int ad_lbound[3], ad_rbound[3];
+static int ActiveDomainDisturbed (double ****, int, int, int);
+
 /* ********************************************************************* */
 void SetJetDomain (const Data *d, int dir, int log_freq, Grid *grid)
 /*!
@@ -246,3 +286,152 @@ int GetRightmostIndex (int dir, double ***q)
 
   return(-1);
 }
+
+/* ********************************************************************* */
+void SetActiveDomain (const Data *d, Grid *grid)
+/*!
+ * Restrict the integration range to the bounding box of the 
+ * disturbed region (plus guard zones) in all directions.
+ * The first call only saves the original index ranges, so that the
+ * first step (where static arrays are allocated) is taken on the full
+ * domain.
+ *
+ * \param [in]      d     pointer to Data structure
+ * \param [in,out]  grid  pointer to array of Grid structures
+ * 
+ *********************************************************************** */
+{
+  int i, j, k, dir, ngh, guard;
+  int lo[3], hi[3], il, ir;
+  static int first_call = 1;
+  double ****V = d->Vc;
+
+  if (first_call){
+    for (dir = 0; dir < 3; dir++){
+      ad_beg[dir]    = grid[dir].lbeg;
+      ad_end[dir]    = grid[dir].lend;
+      ad_lbound[dir] = grid[dir].lbound;
+      ad_rbound[dir] = grid[dir].rbound;
+    }
+    ad_npt[IDIR] = NX1; ad_ntot[IDIR] = NX1_TOT;
+    ad_npt[JDIR] = NX2; ad_ntot[JDIR] = NX2_TOT;
+    ad_npt[KDIR] = NX3; ad_ntot[KDIR] = NX3_TOT;
+    first_call = 0;
+    return;
+  }
+
+/* ----------------------------------------------------
+    1. Find the bounding box of disturbed zones.
+       Each row is scanned from both ends up to the
+       first disturbed zone only.
+   ---------------------------------------------------- */
+
+  for (dir = 0; dir < 3; dir++){
+    lo[dir] = ad_end[dir] + 1;
+    hi[dir] = ad_beg[dir] - 1;
+  }
+
+  for (k = ad_beg[KDIR]; k <= ad_end[KDIR]; k++){
+  for (j = ad_beg[JDIR]; j <= ad_end[JDIR]; j++){
+    for (il = ad_beg[IDIR]; il <= ad_end[IDIR]; il++){
+      if (ActiveDomainDisturbed (V, k, j, il)) break;
+    }
+    if (il > ad_end[IDIR]) continue;  /* -- pristine row -- */
+    for (ir = ad_end[IDIR]; ir > il; ir--){
+      if (ActiveDomainDisturbed (V, k, j, ir)) break;
+    }
+    lo[IDIR] = MIN(lo[IDIR], il); hi[IDIR] = MAX(hi[IDIR], ir);
+    lo[JDIR] = MIN(lo[JDIR], j);  hi[JDIR] = MAX(hi[JDIR], j);
+    lo[KDIR] = MIN(lo[KDIR], k);  hi[KDIR] = MAX(hi[KDIR], k);
+  }}
+
+/* ----------------------------------------------------
+    2. Add guard zones. An empty box (entirely pristine
+       local domain) is replaced by a minimal one.
+   ---------------------------------------------------- */
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    ngh   = grid[dir].nghost;
+    guard = ACTIVE_DOMAIN_GUARD*ngh;
+    if (hi[dir] < lo[dir]){
+      lo[dir] = ad_beg[dir];
+      hi[dir] = MIN(ad_beg[dir] + ngh - 1, ad_end[dir]);
+    }else{
+      lo[dir] = MAX(lo[dir] - guard, ad_beg[dir]);
+      hi[dir] = MIN(hi[dir] + guard, ad_end[dir]);
+    }
+
+    grid[dir].lbeg   = lo[dir];
+    grid[dir].lend   = hi[dir];
+    grid[dir].lbound = (lo[dir] == ad_beg[dir] ? ad_lbound[dir]:0);
+    grid[dir].rbound = (hi[dir] == ad_end[dir] ? ad_rbound[dir]:0);
+  }
+
+/* ------------------------------------------------------------------
+    3. Change global integer variables giving the integration range
+   ------------------------------------------------------------------ */
+
+  D_EXPAND(IBEG = grid[IDIR].lbeg; IEND = grid[IDIR].lend;
+           NX1  = IEND - IBEG + 1; 
+           NX1_TOT = IEND + grid[IDIR].nghost + 1;            ,
+
+           JBEG = grid[JDIR].lbeg; JEND = grid[JDIR].lend;
+           NX2  = JEND - JBEG + 1; 
+           NX2_TOT = JEND + grid[JDIR].nghost + 1;            ,
+
+           KBEG = grid[KDIR].lbeg; KEND = grid[KDIR].lend;
+           NX3  = KEND - KBEG + 1; 
+           NX3_TOT = KEND + grid[KDIR].nghost + 1;)
+
+  SetRBox();
+}
+
+/* ********************************************************************* */
+void UnsetActiveDomain (Grid *grid)
+/*!
+ *  Restore original (full domain) indexes.
+ *
+ *********************************************************************** */
+{
+  int dir;
+
+  for (dir = 0; dir < 3; dir++){
+    grid[dir].lbeg   = ad_beg[dir];
+    grid[dir].lend   = ad_end[dir];
+    grid[dir].lbound = ad_lbound[dir];
+    grid[dir].rbound = ad_rbound[dir];
+  }
+  IBEG = ad_beg[IDIR]; IEND = ad_end[IDIR];
+  JBEG = ad_beg[JDIR]; JEND = ad_end[JDIR];
+  KBEG = ad_beg[KDIR]; KEND = ad_end[KDIR];
+  NX1 = ad_npt[IDIR]; NX1_TOT = ad_ntot[IDIR];
+  NX2 = ad_npt[JDIR]; NX2_TOT = ad_ntot[JDIR];
+  NX3 = ad_npt[KDIR]; NX3_TOT = ad_ntot[KDIR];
+
+  SetRBox();
+}
+
+/* ********************************************************************* */
+int ActiveDomainDisturbed (double ****V, int k, int j, int i)
+/*!
+ * Return 1 if any primitive variable in zone (i,j,k) has a relative
+ * jump larger than ::ACTIVE_DOMAIN_EPS between its left and right 
+ * neighbours in any direction (variables vanishing in the ambient 
+ * medium, such as the velocity, are disturbed as soon as they
+ * differ from zero).
+ *
+ *********************************************************************** */
+{
+  int    nv;
+  double a, b;
+
+  for (nv = 0; nv < NVAR; nv++){
+    D_EXPAND(a = V[nv][k][j][i+1]; b = V[nv][k][j][i-1];
+             if (fabs(a - b) > ACTIVE_DOMAIN_EPS*(fabs(a) + fabs(b))) return 1;  ,
+             a = V[nv][k][j+1][i]; b = V[nv][k][j-1][i];
+             if (fabs(a - b) > ACTIVE_DOMAIN_EPS*(fabs(a) + fabs(b))) return 1;  ,
+             a = V[nv][k+1][j][i]; b = V[nv][k-1][j][i];
+             if (fabs(a - b) > ACTIVE_DOMAIN_EPS*(fabs(a) + fabs(b))) return 1;)
+  }
+  return 0;
+}
@@ -133,6 +133,13 @@ int main (int argc, char *argv[])
   Dts.Nsts     = Dts.Nrkc = 0;
   
   Solver = SetSolver (ini.solv_type);
+
+  #if INCLUDE_PARTICLES == YES
+   Particles_Init (&data, &ini, cmd_line.restart || cmd_line.h5restart, grd);
+  #endif
+  #if NESTED_LEVELS > 0
+   Nested_Init (&data, &ini, grd);
+  #endif
   
   time (&tbeg);
   g_stepNumber = 0;
@@ -144,11 +151,20 @@ int main (int argc, char *argv[])
    
   if (cmd_line.restart == YES) {
     RestartFromFile (&ini, cmd_line.nrestart, DBL_OUTPUT, grd);
+    #if INCLUDE_PARTICLES == YES
+     Particles_Restart (&data, &ini, grd);
+    #endif
   }else if (cmd_line.h5restart == YES){
     RestartFromFile (&ini, cmd_line.nrestart, DBL_H5_OUTPUT, grd);
+    #if INCLUDE_PARTICLES == YES
+     Particles_Restart (&data, &ini, grd);
+    #endif
   }else if (cmd_line.write){
     CheckForOutput (&data, &ini, grd);
     CheckForAnalysis (&data, &ini, grd);
+    #if INCLUDE_PARTICLES == YES
+     Particles_CheckForOutput (&ini, grd);
+    #endif
     #ifdef USE_ASYNC_IO
      Async_EndWriteData (&ini);
     #endif
@@ -203,6 +219,9 @@ int main (int argc, char *argv[])
     if (!first_step && !last_step && cmd_line.write) {
       CheckForOutput  (&data, &ini, grd);
       CheckForAnalysis(&data, &ini, grd);
+      #if INCLUDE_PARTICLES == YES
+       Particles_CheckForOutput (&ini, grd);
+      #endif
     }
 
   /* ------------------------------------------------------
@@ -210,22 +229,36 @@ int main (int argc, char *argv[])
       g_dt = dt(n)
      ------------------------------------------------------ */
 
+    #if FAILSAFE == YES
+     FailSafe_Save (&data, &Dts);
+     for (;;){
+    #endif
     if (cmd_line.jet != -1) SetJetDomain (&data, cmd_line.jet, ini.log_freq, grd); 
-    err = Integrate (&data, Solver, &Dts, grd);
+    if (cmd_line.active) SetActiveDomain (&data, grd);
+    #if NESTED_LEVELS > 0
+     err = Nested_Integrate (&data, Solver, &Dts, grd, Integrate);
+    #else
+     err = Integrate (&data, Solver, &Dts, grd);
+    #endif
     if (cmd_line.jet != -1) UnsetJetDomain (&data, cmd_line.jet, grd); 
+    if (cmd_line.active) UnsetActiveDomain (grd);
 
   /* ------------------------------------------------------
        Integration didn't go through. Step must
-       be redone from previously saved solution.
+       be redone from previously saved solution, with 
+       zones where it failed tagged with FLAG_MINMOD
+       and FLAG_HLL and a halved time step.
      ------------------------------------------------------ */
-/*
-    if (err != 0){
-      print1 ("! Step failed. Re-trying\n");
-      zones with problems must be tagged with MINMOD_FLAG and HLL_FLAG
-      time step should be halved
-      GET_SOL(&data);
-    }
-*/
+
+    #if FAILSAFE == YES
+      if (FailSafe_Check (&data, err, &Dts, &ini, grd) == 0) break;
+      FailSafe_Retry (&data, &Dts);
+      last_step = (g_stepNumber == cmd_line.maxsteps && cmd_line.maxsteps > 0);
+     }
+    #endif
+    #if INCLUDE_PARTICLES == YES
+     Particles_Update (&data, g_dt, grd);
+    #endif
 
   /* ------------------------------------------------------
       Increment time, t(n+1) = t(n) + dt(n)
@@ -319,6 +352,9 @@ int main (int argc, char *argv[])
     if (!first_step && !last_step && cmd_line.write) {
       CheckForOutput  (&data, &ini, grd);
       CheckForAnalysis(&data, &ini, grd);
+      #if INCLUDE_PARTICLES == YES
+       Particles_CheckForOutput (&ini, grd);
+      #endif
     }
 
   /* ------------------------------------------------------
@@ -390,22 +426,36 @@ int main (int argc, char *argv[])
       g_dt = dt(n)
      ------------------------------------------------------ */
 
+    #if FAILSAFE == YES
+     FailSafe_Save (&data, &Dts);
+     for (;;){
+    #endif
     if (cmd_line.jet != -1) SetJetDomain (&data, cmd_line.jet, ini.log_freq, grd); 
-    err = Integrate (&data, Solver, &Dts, grd);
+    if (cmd_line.active) SetActiveDomain (&data, grd);
+    #if NESTED_LEVELS > 0
+     err = Nested_Integrate (&data, Solver, &Dts, grd, Integrate);
+    #else
+     err = Integrate (&data, Solver, &Dts, grd);
+    #endif
     if (cmd_line.jet != -1) UnsetJetDomain (&data, cmd_line.jet, grd); 
+    if (cmd_line.active) UnsetActiveDomain (grd);
 
   /* ------------------------------------------------------
        Integration didn't go through. Step must
-       be redone from previously saved solution.
+       be redone from previously saved solution, with 
+       zones where it failed tagged with FLAG_MINMOD
+       and FLAG_HLL and a halved time step.
      ------------------------------------------------------ */
-/*
-    if (err != 0){
-      print1 ("! Step failed. Re-trying\n");
-      zones with problems must be tagged with MINMOD_FLAG and HLL_FLAG
-      time step should be halved
-      GET_SOL(&data);
-    }
-*/
+
+    #if FAILSAFE == YES
+      if (FailSafe_Check (&data, err, &Dts, &ini, grd) == 0) break;
+      FailSafe_Retry (&data, &Dts);
+      last_step = (g_stepNumber == cmd_line.maxsteps && cmd_line.maxsteps > 0);
+     }
+    #endif
+    #if INCLUDE_PARTICLES == YES
+     Particles_Update (&data, g_dt, grd);
+    #endif
   /* ------------------------------------------------------
       Increment time, t(n+1) = t(n) + dt(n)
      ------------------------------------------------------ */
@@ -429,6 +479,9 @@ int main (int argc, char *argv[])
   if (cmd_line.write){
     CheckForOutput (&data, &ini, grd);
     CheckForAnalysis (&data, &ini, grd);
+    #if INCLUDE_PARTICLES == YES
+     Particles_CheckForOutput (&ini, grd);
+    #endif
     #ifdef USE_ASYNC_IO
      Async_EndWriteData (&ini);
     #endif
@@ -482,12 +535,13 @@ int Integrate (Data *d, Riemann_Solver *Solver, Time_Step *Dts, Grid *grid)
   g_maxRootIter    = 0;
 
 /* -------------------------------------------------------
-    Initialize max propagation speed in Dedner's approach
+    Initialize max propagation speed in Dedner's approach.
+    The damping of psi is applied by the last conversion
+    to primitive variables in AdvanceStep().
    ------------------------------------------------------- */
 
   #ifdef GLM_MHD  /* -- initialize glm_ch -- */
    GLM_Init (d, Dts, grid);   
-   GLM_Source (d->Vc, 0.5*g_dt, grid);
   #endif
 
   /* ---------------------------------------------
@@ -496,6 +550,9 @@ int Integrate (Data *d, Riemann_Solver *Solver, Time_Step *Dts, Grid *grid)
      --------------------------------------------- */
 
   TOT_LOOP(k,j,i) d->flag[k][j][i] = 0;
+  #if FAILSAFE == YES
+   FailSafe_SetFlags (d);
+  #endif
 
   #ifdef FARGO
    FARGO_ComputeVelocity(d, grid);
@@ -524,10 +581,6 @@ int Integrate (Data *d, Riemann_Solver *Solver, Time_Step *Dts, Grid *grid)
     #endif
   }       
 
-  #ifdef GLM_MHD  /* -- GLM source for dt/2 -- */
-   GLM_Source (d->Vc, 0.5*g_dt, grid);
-  #endif
-
   return (0); /* -- ok, step achieved -- */
 }
 
@@ -604,8 +657,8 @@ double NextTimeStep (Time_Step *Dts, Runtime *ini, Grid *grid)
   dtnext  = dt_adv;
 
 /* -------------------------------------------------------
-   3. Maximum propagation speed for the local processor.
-      Global glm_ch will be computed later in GLM_Init.
+   3. Maximum propagation speed, from the global time step
+      and minimum cell length (same value on all processors).
    ------------------------------------------------------- */
 
   #ifdef GLM_MHD
@@ -19,6 +19,8 @@ void ConsToPrim3D (Data_Arr U, Data_Arr V, unsigned char ***flag, RBox *box)
  *  an array of primitive variables \c V.
  *  Note that <tt>[nv]</tt> is the fastest running index for \c U 
  *  while it is the slowest running index for \c V.
+ *  With GLM divergence cleaning, \f$\psi\f$ is also multiplied by
+ *  ::glm_damping, which is then reset to 1.
  *
  * \param [in]     U      pointer to 3D array of conserved variables,
  *                        with array indexing <tt>[k][j][i][nv]</tt>
@@ -76,10 +78,18 @@ void ConsToPrim3D (Data_Arr U, Data_Arr V, unsigned char ***flag, RBox *box)
     for (i = ibeg; i <= iend; i++) NVAR_LOOP(nv) U[nv][k][j][i] = u[i][nv];
 #else
     err = ConsToPrim (U[k][j], v, ibeg, iend, flag[k][j]);
+#endif
+#ifdef GLM_MHD
+    if (glm_damping != 1.0){   /* -- GLM source term, see GLM_Damping() -- */
+      for (i = ibeg; i <= iend; i++) v[i][PSI_GLM] *= glm_damping;
+    }
 #endif
     for (i = ibeg; i <= iend; i++) NVAR_LOOP(nv) V[nv][k][j][i] = v[i][nv];
   }}
   g_dir = current_dir;
+#ifdef GLM_MHD
+  glm_damping = 1.0;
+#endif
 
 }
 /* ********************************************************************* */
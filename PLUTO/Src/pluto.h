@@ -291,6 +291,11 @@
  #define CHAR_LIMITING  NO
 #endif
 
+#ifndef CHAR_LIMITING_HYBRID
+ #define CHAR_LIMITING_HYBRID  NO  /* limit in characteristic variables
+                                      only where the flow is not smooth */
+#endif
+
 #ifdef CH_SPACEDIM
  #define CHOMBO  1
 
@@ -339,10 +344,36 @@
  #define EOS  -1
 #endif
 
+#ifndef FAILSAFE
+ #define FAILSAFE  NO  /**< When set to YES, a failed step is redone
+                            from a saved copy of the solution with a
+                            smaller time step (see failsafe.c). */
+#endif
+
+#if (FAILSAFE == YES) && defined(CH_SPACEDIM)
+ #error FAILSAFE not available with AMR
+#endif
+
+#if FAILSAFE == YES
+ #define FLAG_RESCUE  FLAG_BIT8  /**< ConsToPrim() could not recover a
+                                      physical state and the step must be
+                                      redone (see failsafe.c). */
+#endif
+
 #ifndef INCLUDE_PARTICLES
  #define INCLUDE_PARTICLES NO
 #endif
 
+#ifndef INTERNAL_BOUNDARY_STATIC
+ #define INTERNAL_BOUNDARY_STATIC  NO  /**< When set to YES, the internal
+                                          boundary is declared only once
+                                          (see internal_boundary.c). */
+#endif
+
+#ifndef NESTED_LEVELS
+ #define NESTED_LEVELS  0
+#endif
+
 #ifndef RECONSTRUCT_4VEL
   #define RECONSTRUCT_4VEL   NO  /**< When set to YES, reconstruct 4-velocity
                                       rather than 3-velocity (only for RHD and
@@ -357,6 +388,12 @@
  #define ROTATING_FRAME NO
 #endif
 
+#ifndef SELF_GRAVITY
+ #define SELF_GRAVITY  NO  /**< When set to YES, the gravitational potential
+                                of the fluid is added to BodyForcePotential()
+                                (see self_gravity.c). */
+#endif
+
 #ifndef THERMAL_CONDUCTION
  #define THERMAL_CONDUCTION NO
 #endif
@@ -373,6 +410,24 @@
  #define UNIT_VELOCITY (1.e5)  /**< Unit velocity in cm/sec. */
 #endif
 
+#ifndef SELF_GRAVITY_G
+ #define SELF_GRAVITY_G  (CONST_G*UNIT_DENSITY*UNIT_LENGTH*UNIT_LENGTH/ \
+                          (UNIT_VELOCITY*UNIT_VELOCITY))  /**< Gravitational
+                                        constant in code units. */
+#endif
+
+#if SELF_GRAVITY == YES
+ #if !(BODY_FORCE & POTENTIAL)
+  #error SELF_GRAVITY requires BODY_FORCE to include POTENTIAL
+ #endif
+ #if (PHYSICS != HD) && (PHYSICS != MHD)
+  #error SELF_GRAVITY only available with HD or MHD
+ #endif
+ #if GEOMETRY != CARTESIAN
+  #error SELF_GRAVITY only available in CARTESIAN geometry
+ #endif
+#endif
+
 #ifndef UPDATE_VECTOR_POTENTIAL
  #define UPDATE_VECTOR_POTENTIAL  NO
 #endif
@@ -485,6 +540,7 @@ typedef double real;
 typedef void Riemann_Solver (const State_1D *, int, int, double *, Grid *);
 typedef void Limiter        (double *, double *, double *, int, int, Grid *);
 typedef double Reconstruct  (double *, double, int);
+typedef void Reconstruct_Fields (double **, double, int, double *);
 typedef double ****Data_Arr;
 
 /* ********************************************************
@@ -518,6 +574,14 @@ typedef double ****Data_Arr;
  #include "Viscosity/viscosity.h"   /* Viscosity header file */
 #endif
 
+#if INCLUDE_PARTICLES == YES
+ #include "Particles/particles.h"   /* Tracer particles header file */
+#endif
+
+#if NESTED_LEVELS > 0
+ #include "Nested/nested.h"         /* Nested static grids header file */
+#endif
+
 #include "States/plm_coeffs.h"      /* PLM header file */
 #if RECONSTRUCTION == PARABOLIC 
  #include "States/ppm_coeffs.h"     /* PPM header file */
@@ -30,6 +30,7 @@ void   BodyForceVector(double *, double *, double, double, double);
 
 void  ChangeDumpVar ();
 void  CharTracingStep(const State_1D *, int, int, Grid *);
+void  CharToPrim (double **, double *, double *);
 void  CheckPrimStates (double **, double **, double **, int, int);
 int   CheckNaN (double **, int, int, int);
 int   CloseBinaryFile (FILE *, int);
@@ -39,6 +40,8 @@ float ***Convert_dbl2flt (double ***, double, int);
 void ConsToPrim3D(Data_Arr, Data_Arr, unsigned char ***, RBox *);
 void CreateImage (char *);
 
+void EmissionMaps (const Data *, int, Grid *);
+
 void ComputeEntropy      (const Data *, Grid *);
 void EntropySwitch       (const Data *, Grid *);
 void EntropyOhmicHeating (const Data *, Data_Arr, double, Grid *);
@@ -56,19 +59,31 @@ void FreeArrayCharMap(unsigned char ***);
 #ifdef FINITE_DIFFERENCE  
  Riemann_Solver FD_Flux;
  Reconstruct MP5_Reconstruct, PPM_Reconstruct, LIMO3_Reconstruct,
-             WENOZ_Reconstruct, WENO3_Reconstruct;
+             WENOZ_Reconstruct, WENO3_Reconstruct, LIN_Reconstruct;
+ Reconstruct_Fields MP5_ReconstructFields, LIMO3_ReconstructFields,
+                    WENOZ_ReconstructFields, WENO3_ReconstructFields,
+                    LIN_ReconstructFields;
  void FD_GetMaxEigenvalues (const Data *d, State_1D *state, Grid *grid);
 #endif
 
+#if FAILSAFE == YES
+ int  FailSafe_Check (Data *, int, Time_Step *, Runtime *, Grid *);
+ void FailSafe_Retry (Data *, Time_Step *);
+ void FailSafe_Save (const Data *, const Time_Step *);
+ void FailSafe_SetFlags (Data *);
+#endif
+
 void FindShock (const Data *, Grid *);
 void FlagShock (const Data *, Grid *);
 void Flatten (const State_1D *, int, int, Grid *);
+void FlagSmoothZones (const State_1D *, int, int, int, unsigned char *);
 void FreeGrid (Grid *);
 
 void     GetAreaFlux (const State_1D *, double **, double **, int, int, Grid *);
 void     GetCGSUnits (double *u);
 Image   *GetImage (char *);
 double  *GetInverse_dl (const Grid *);
+double ***GetInverseTimeStep (int);
 int      GetNghost (void);
 void     GetOutputFrequency(Output *, const char *);
 RBox    *GetRBox(int, int);
@@ -81,7 +96,10 @@ int LocateIndex(double *, int, int, double);
 void Init (double *, double, double, double);
 void Initialize(int argc, char *argv[], Data *, Runtime *, Grid *, Cmd_Line *);
 
+void InternalBoundaryImpose (const Data *, const Grid *);
+int  InternalBoundaryIsSet  (const Grid *);
 void InternalBoundaryReset (const State_1D *, Time_Step *, int, int, Grid *);
+void InternalBoundaryStore  (const Data *, const Grid *);
 
 void InputDataFree (void);
 void InputDataInterpolate (double *, double, double, double);
@@ -125,6 +143,12 @@ Runtime *RuntimeGet(void);
 int      RuntimeSetup  (Runtime *, Cmd_Line *, char *);
 void     RuntimeSet(Runtime *runtime);
 
+#if SELF_GRAVITY == YES
+void      SelfGravityAddPotential (double *, int, int);
+double ***SelfGravityPotential (void);
+void      SelfGravitySetPotential (double ***);
+void      SelfGravitySolve (const Data *, Grid *);
+#endif
 void SetColorMap (unsigned char *, unsigned char *, unsigned char *, char *);
 void SetDefaultVarNames(Output *);
 int  SetDumpVar (char *, int, int);
@@ -134,6 +158,7 @@ void SetOutput (Data *d, Runtime *input);
 void SetRBox(void);
 Riemann_Solver *SetSolver (const char *);
 void SetGrid (Runtime *, Grid *);
+void SetActiveDomain (const Data *, Grid *);
 void SetJetDomain   (const Data *, int, int, Grid *);
 void Show (double **, int);
 void ShowMatrix(double **, int n, double);
@@ -149,6 +174,7 @@ void Startup (Data *, Grid *);
 void States (const State_1D *, int, int, Grid *);
 void SwapEndian (void *, const int); 
 
+void UnsetActiveDomain (Grid *);
 void UnsetJetDomain (const Data *, int, Grid *);
 void UpdateStage(const Data *, Data_Arr, double **, Riemann_Solver *,
                  double, Time_Step *, Grid *);
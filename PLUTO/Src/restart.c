@@ -92,6 +92,9 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
     #ifdef USE_HDF5
      ReadHDF5 (output, grid);
     #endif
+    #if NESTED_LEVELS > 0
+     Nested_Restart (NULL, 0);
+    #endif
     return;
   }
 
@@ -169,6 +172,9 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
       CloseBinaryFile (fbin, sz);
     }
   }
+  #if NESTED_LEVELS > 0
+   Nested_Restart (output, swap_endian);
+  #endif
 }
 
 static int counter = -1;
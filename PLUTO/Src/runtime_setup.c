@@ -365,6 +365,31 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
     runtime->anl_dt = -1.0;   /* -- defaults -- */
     runtime->anl_dn = -1;
   }
+
+ /* -- tracer particles -- */
+
+  if (ParamExist ("particles")){
+    runtime->part_np = atoi(ParamFileGet("particles", 1));
+    runtime->part_dt = atof(ParamFileGet("particles", 2));
+    runtime->part_dn = atoi(ParamFileGet("particles", 3));
+  }else{
+    runtime->part_np = 0;     /* -- defaults -- */
+    runtime->part_dt = -1.0;
+    runtime->part_dn = -1;
+  }
+
+ /* -- nested grids center (default: center of the domain) -- */
+
+  for (idim = 0; idim < 3; idim++){
+    ip = runtime->npatch[idim];
+    runtime->nest_center[idim] = 0.5*(  runtime->patch_left_node[idim][1] 
+                                      + runtime->patch_left_node[idim][ip+1]);
+  }
+  if (ParamExist ("nested_center")){
+    for (idim = 0; idim < DIMENSIONS; idim++){
+      runtime->nest_center[idim] = atof(ParamFileGet("nested_center", idim+1));
+    }
+  }
 #endif
 
 #ifdef CHOMBO
@@ -0,0 +1,714 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Gravitational potential of the fluid (self-gravity).
+
+  When ::SELF_GRAVITY is set to \c YES, the solution of Poisson's
+  equation
+  \f[
+     \nabla^2\Phi_{sg} = 4\pi G\rho
+  \f]
+  is added to the user-supplied BodyForcePotential() wherever the
+  latter is used, so ::BODY_FORCE must include ::POTENTIAL
+  (the user function may simply return 0).
+  The gravitational constant \f$G\f$ is given, in code units, by
+  ::SELF_GRAVITY_G.
+
+  On the static grid, SelfGravitySolve() is called at the beginning of
+  every stage and computes the potential with a distributed fast
+  Fourier transform:
+  - when all boundaries are periodic, the transform of the density is
+    divided by the eigenvalues of the discrete (3-, 5- or 7-point)
+    Laplacian; the mean density does not contribute (Jeans swindle);
+  - when no boundary is periodic, the potential of the isolated mass
+    distribution is obtained by convolving the mass of each zone with
+    the Green's function \f$-G/r\f$ (\f$2G\ln r\f$ in 2D,
+    \f$2\pi G|x|\f$ in 1D) on a grid padded with zeroes to twice its
+    size (Hockney & Eastwood).
+    The self-contribution of a zone is its exact average over a cube
+    (square, segment) of the same volume.
+    The padded size is rounded up to a product of powers of 2
+    and 3.
+
+  The grid must be Cartesian and uniform.
+  The three-dimensional transform is done on slabs along the last
+  dimension (transforms in the other ones) and on pencils along the
+  last dimension, the data being exchanged between the ArrayLib
+  decomposition, the slabs and the pencils with MPI_Alltoallv().
+  The potential is also computed in the ghost zones, so no boundary
+  condition is needed.
+
+  With AMR, the potential is computed by AMRLevelPluto with Chombo's
+  AMRMultiGrid and handed over one patch at a time through
+  SelfGravitySetPotential().
+
+  \b Reference
+     - "Computer Simulation Using Particles",
+       Hockney & Eastwood (1988), Sect. 6-5
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#if SELF_GRAVITY == YES
+
+static double ***Phi;  /**< potential in the local domain (ghost zones
+                            included) */
+
+#ifndef CH_SPACEDIM
+
+#if NESTED_LEVELS > 0
+ #error SELF_GRAVITY not available with NESTED_LEVELS
+#endif
+
+typedef struct SG_BOX{
+  int beg[3], end[3];  /**< first and last zone in the index space of
+                            the transform (end < beg if empty) */
+} SG_Box;
+
+static int nprocs, isolated;
+static int N[3];         /**< size of the transform */
+static SG_Box *dom_box;  /**< interior of every processor */
+static SG_Box *tot_box;  /**< same, including ghost zones */
+static SG_Box *slab_box; /**< slabs along the last dimension */
+static SG_Box *pncl_box; /**< pencils along the last dimension */
+static double *rho_buf, *slab_r, *slab_c, *pncl_c, *green;
+
+static void   SelfGravityInit (Grid *);
+static long   BoxSize (SG_Box *);
+static long   BoxWalk (SG_Box *, SG_Box *, double *, double *, int, int);
+static void   Redistribute (double *, SG_Box *, double *, SG_Box *, int);
+static void   FFTLines (double *, SG_Box *, int, int);
+static int    FFTSize (int);
+static void   FFT (double *, double *, int, int, int, int, double *);
+
+/* ********************************************************************* */
+void SelfGravitySolve (const Data *d, Grid *grid)
+/*!
+ * Solve Poisson's equation for the density in d->Vc[RHO].
+ *
+ * \param [in] d     pointer to Data structure
+ * \param [in] grid  pointer to array of Grid structures
+ *
+ *********************************************************************** */
+{
+  int  i, j, k, dir;
+  long m, nslab, npncl;
+
+  if (Phi == NULL) SelfGravityInit (grid);
+
+  nslab = BoxSize (slab_box + prank);
+  npncl = BoxSize (pncl_box + prank);
+
+/* --------------------------------------------------------
+    1. Copy density to slabs
+   -------------------------------------------------------- */
+
+  m = 0;
+  DOM_LOOP(k,j,i) rho_buf[m++] = d->Vc[RHO][k][j][i];
+
+  for (m = 0; m < nslab; m++) slab_r[m] = 0.0;
+  Redistribute (rho_buf, dom_box, slab_r, slab_box, 1);
+  for (m = 0; m < nslab; m++){
+    slab_c[2*m]     = slab_r[m];
+    slab_c[2*m + 1] = 0.0;
+  }
+
+/* --------------------------------------------------------
+    2. Forward transform, multiply by the Green's function
+       and transform back
+   -------------------------------------------------------- */
+
+  for (dir = 0; dir < DIMENSIONS - 1; dir++){
+    FFTLines (slab_c, slab_box + prank, dir, -1);
+  }
+  Redistribute (slab_c, slab_box, pncl_c, pncl_box, 2);
+  FFTLines (pncl_c, pncl_box + prank, DIMENSIONS - 1, -1);
+
+  for (m = 0; m < npncl; m++){
+    pncl_c[2*m]     *= green[m];
+    pncl_c[2*m + 1] *= green[m];
+  }
+
+  FFTLines (pncl_c, pncl_box + prank, DIMENSIONS - 1, 1);
+  Redistribute (pncl_c, pncl_box, slab_c, slab_box, 2);
+  for (dir = 0; dir < DIMENSIONS - 1; dir++){
+    FFTLines (slab_c, slab_box + prank, dir, 1);
+  }
+
+/* --------------------------------------------------------
+    3. Copy the potential back to the local domain
+   -------------------------------------------------------- */
+
+  for (m = 0; m < nslab; m++) slab_r[m] = slab_c[2*m];
+  Redistribute (slab_r, slab_box, Phi[0][0], tot_box, 1);
+}
+
+/* ********************************************************************* */
+void SelfGravityInit (Grid *grid)
+/*!
+ * Check boundary conditions and grid, set up the decompositions
+ * and compute the Green's function in Fourier space.
+ *
+ *********************************************************************** */
+{
+  int  i, j, k, dir, q, np, ib[3];
+  long m, nslab, npncl;
+  double h[3], r[3], rr, dV, lambda, norm;
+  Runtime *ini = RuntimeGet();
+
+/* --------------------------------------------------------
+    1. Boundaries must be all periodic or none
+   -------------------------------------------------------- */
+
+  np = 0;
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    np += (ini->left_bound[dir] == PERIODIC);
+    np += (ini->right_bound[dir] == PERIODIC);
+    if (!grid[dir].uniform){
+      print1 ("! SelfGravityInit(): grid must be uniform\n");
+      QUIT_PLUTO(1);
+    }
+  }
+  if (np != 0 && np != 2*DIMENSIONS){
+    print1 ("! SelfGravityInit(): boundaries must be either all periodic ");
+    print1 ("or all non-periodic\n");
+    QUIT_PLUTO(1);
+  }
+  isolated = (np == 0);
+
+  nprocs = 1;
+  #ifdef PARALLEL
+   MPI_Comm_size (MPI_COMM_WORLD, &nprocs);
+  #endif
+
+  dV = 1.0;
+  for (dir = 0; dir < 3; dir++){
+    N[dir] = 1;
+    h[dir] = 1.0;
+    if (dir >= DIMENSIONS) continue;
+    N[dir] = grid[dir].np_int_glob;
+    if (isolated) N[dir] = FFTSize (2*(N[dir] + grid[dir].nghost));
+    h[dir] = grid[dir].dx_glob[grid[dir].gbeg];
+    dV    *= h[dir];
+  }
+
+/* --------------------------------------------------------
+    2. Boxes of the local domains (gathered from all
+       processors), slabs and pencils
+   -------------------------------------------------------- */
+
+  dom_box  = (SG_Box *) malloc (nprocs*sizeof(SG_Box));
+  tot_box  = (SG_Box *) malloc (nprocs*sizeof(SG_Box));
+  slab_box = (SG_Box *) malloc (nprocs*sizeof(SG_Box));
+  pncl_box = (SG_Box *) malloc (nprocs*sizeof(SG_Box));
+
+  for (dir = 0; dir < 3; dir++){
+    ib[dir] = 0;
+    dom_box[prank].beg[dir] = dom_box[prank].end[dir] = 0;
+    if (dir >= DIMENSIONS) continue;
+    ib[dir] = grid[dir].nghost;
+    dom_box[prank].beg[dir] = grid[dir].beg - grid[dir].gbeg;
+    dom_box[prank].end[dir] = grid[dir].end - grid[dir].gbeg;
+  }
+  #ifdef PARALLEL
+   MPI_Allgather (MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, dom_box,
+                  sizeof(SG_Box), MPI_BYTE, MPI_COMM_WORLD);
+  #endif
+
+  for (q = 0; q < nprocs; q++){
+    for (dir = 0; dir < 3; dir++){
+      tot_box[q].beg[dir]  = dom_box[q].beg[dir] - ib[dir];
+      tot_box[q].end[dir]  = dom_box[q].end[dir] + ib[dir];
+      slab_box[q].beg[dir] = pncl_box[q].beg[dir] = 0;
+      slab_box[q].end[dir] = pncl_box[q].end[dir] = N[dir] - 1;
+    }
+
+  /* -- split the last dimension among slabs and the first
+        one among pencils (all on the first processor in 1D) -- */
+
+    dir = DIMENSIONS - 1;
+    slab_box[q].beg[dir] = (int)((long)q*N[dir]/nprocs);
+    slab_box[q].end[dir] = (int)((long)(q + 1)*N[dir]/nprocs) - 1;
+    pncl_box[q].beg[0] = (int)((long)q*N[0]/nprocs);
+    pncl_box[q].end[0] = (int)((long)(q + 1)*N[0]/nprocs) - 1;
+    #if DIMENSIONS == 1
+     slab_box[q].beg[0] = pncl_box[q].beg[0] = 0;
+     slab_box[q].end[0] = pncl_box[q].end[0] = (q == 0 ? N[0]:0) - 1;
+    #endif
+  }
+
+  nslab = BoxSize (slab_box + prank);
+  npncl = BoxSize (pncl_box + prank);
+
+  Phi     = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+  rho_buf = ARRAY_1D(MAX(BoxSize(dom_box + prank), 1), double);
+  slab_r  = ARRAY_1D(MAX(nslab, 1), double);
+  slab_c  = ARRAY_1D(MAX(2*nslab, 1), double);
+  pncl_c  = ARRAY_1D(MAX(2*npncl, 1), double);
+  green   = ARRAY_1D(MAX(npncl, 1), double);
+  TOT_LOOP(k,j,i) Phi[k][j][i] = 0.0;
+
+/* --------------------------------------------------------
+    3. Green's function in Fourier space, including the
+       normalization of the inverse transform
+   -------------------------------------------------------- */
+
+  norm = 1.0/((double)N[0]*N[1]*N[2]);
+  if (!isolated){
+    m = 0;
+    for (k = pncl_box[prank].beg[2]; k <= pncl_box[prank].end[2]; k++){
+    for (j = pncl_box[prank].beg[1]; j <= pncl_box[prank].end[1]; j++){
+    for (i = pncl_box[prank].beg[0]; i <= pncl_box[prank].end[0]; i++){
+      lambda = D_EXPAND(  2.0*(cos(2.0*CONST_PI*i/N[0]) - 1.0)/(h[0]*h[0]),
+                        + 2.0*(cos(2.0*CONST_PI*j/N[1]) - 1.0)/(h[1]*h[1]),
+                        + 2.0*(cos(2.0*CONST_PI*k/N[2]) - 1.0)/(h[2]*h[2]));
+      green[m++] = (lambda < 0.0 ? 4.0*CONST_PI*SELF_GRAVITY_G*norm/lambda:0.0);
+    }}}
+    print1 ("> SelfGravity: periodic FFT solver (%d x %d x %d)\n",
+            N[0], N[1], N[2]);
+    return;
+  }
+
+  m = 0;
+  for (k = slab_box[prank].beg[2]; k <= slab_box[prank].end[2]; k++){
+  for (j = slab_box[prank].beg[1]; j <= slab_box[prank].end[1]; j++){
+  for (i = slab_box[prank].beg[0]; i <= slab_box[prank].end[0]; i++){
+    r[0] = h[0]*MIN(i, N[0] - i);
+    r[1] = h[1]*MIN(j, N[1] - j);
+    r[2] = h[2]*MIN(k, N[2] - k);
+    rr   = sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+    #if DIMENSIONS == 1
+     if (rr == 0.0) rr = 0.25*h[0];
+     slab_c[2*m] = 2.0*CONST_PI*SELF_GRAVITY_G*rr;
+    #elif DIMENSIONS == 2
+     if (rr == 0.0) rr = sqrt(dV)*exp(0.5*log(0.5) - 1.5 + 0.25*CONST_PI);
+     slab_c[2*m] = 2.0*SELF_GRAVITY_G*log(rr);
+    #elif DIMENSIONS == 3
+     if (rr == 0.0) rr = pow(dV, 1.0/3.0)/2.380077363979554;
+     slab_c[2*m] = -SELF_GRAVITY_G/rr;
+    #endif
+    slab_c[2*m + 1] = 0.0;
+    m++;
+  }}}
+
+  for (dir = 0; dir < DIMENSIONS - 1; dir++){
+    FFTLines (slab_c, slab_box + prank, dir, -1);
+  }
+  Redistribute (slab_c, slab_box, pncl_c, pncl_box, 2);
+  FFTLines (pncl_c, pncl_box + prank, DIMENSIONS - 1, -1);
+
+/* -- the kernel is even, so its transform is real -- */
+
+  for (m = 0; m < npncl; m++) green[m] = pncl_c[2*m]*dV*norm;
+  print1 ("> SelfGravity: isolated FFT solver (%d x %d x %d)\n",
+          N[0], N[1], N[2]);
+}
+
+/* ********************************************************************* */
+long BoxSize (SG_Box *box)
+/*!
+ * Return the number of zones in a box.
+ *
+ *********************************************************************** */
+{
+  int  dir;
+  long n = 1;
+
+  for (dir = 0; dir < 3; dir++){
+    n *= MAX(box->end[dir] - box->beg[dir] + 1, 0);
+  }
+  return n;
+}
+
+/* ********************************************************************* */
+long BoxWalk (SG_Box *a, SG_Box *b, double *arr, double *buf,
+              int nc, int mode)
+/*!
+ * Visit, in a fixed order, the zones of box \c b that are covered by
+ * box \c a or by one of its periodic images (period ::N).
+ *
+ * \param [in] a     the source box (inside the transform domain)
+ * \param [in] b     the destination box
+ * \param [in,out] arr  array defined on \c a (mode 1) or on \c b
+ *                      (mode 2), with \c nc values per zone
+ * \param [in,out] buf  contiguous buffer
+ * \param [in] nc    number of values per zone
+ * \param [in] mode  0 = count only; 1 = copy \c arr to \c buf;
+ *                   2 = copy \c buf to \c arr.
+ *
+ * \return the number of values visited.
+ *********************************************************************** */
+{
+  int  dir, s[3], smax[3], lo[3], hi[3], j, k, len;
+  long m = 0, na[2], nb[2], ia, ib;
+
+  for (dir = 0; dir < 3; dir++) smax[dir] = (dir < DIMENSIONS ? 1:0);
+  na[0] = a->end[0] - a->beg[0] + 1;
+  na[1] = a->end[1] - a->beg[1] + 1;
+  nb[0] = b->end[0] - b->beg[0] + 1;
+  nb[1] = b->end[1] - b->beg[1] + 1;
+
+  for (s[2] = -smax[2]; s[2] <= smax[2]; s[2]++){
+  for (s[1] = -smax[1]; s[1] <= smax[1]; s[1]++){
+  for (s[0] = -smax[0]; s[0] <= smax[0]; s[0]++){
+    for (dir = 0; dir < 3; dir++){
+      lo[dir] = MAX(b->beg[dir], a->beg[dir] + s[dir]*N[dir]);
+      hi[dir] = MIN(b->end[dir], a->end[dir] + s[dir]*N[dir]);
+      if (lo[dir] > hi[dir]) break;
+    }
+    if (dir < 3) continue;
+
+    len = (hi[0] - lo[0] + 1)*nc;
+    for (k = lo[2]; k <= hi[2]; k++){
+    for (j = lo[1]; j <= hi[1]; j++){
+      if (mode == 1){
+        ia = ((k - s[2]*N[2] - a->beg[2])*na[1] + j - s[1]*N[1] - a->beg[1])*na[0]
+             + lo[0] - s[0]*N[0] - a->beg[0];
+        memcpy (buf + m, arr + ia*nc, len*sizeof(double));
+      }else if (mode == 2){
+        ib = ((k - b->beg[2])*nb[1] + j - b->beg[1])*nb[0] + lo[0] - b->beg[0];
+        memcpy (arr + ib*nc, buf + m, len*sizeof(double));
+      }
+      m += len;
+    }}
+  }}}
+  return m;
+}
+
+/* ********************************************************************* */
+void Redistribute (double *src, SG_Box *sbox, double *dst, SG_Box *dbox,
+                   int nc)
+/*!
+ * Move data from the decomposition \c sbox (one box per processor)
+ * to the decomposition \c dbox.
+ * Zones of \c dst not covered by \c sbox are left untouched.
+ *
+ *********************************************************************** */
+{
+  int  q;
+  long n;
+  static long nbuf = 0;
+  static double *sbuf, *rbuf;
+  #ifdef PARALLEL
+   static int *scnt, *sdsp, *rcnt, *rdsp;
+
+   if (scnt == NULL){
+     scnt = ARRAY_1D(nprocs, int);
+     sdsp = ARRAY_1D(nprocs, int);
+     rcnt = ARRAY_1D(nprocs, int);
+     rdsp = ARRAY_1D(nprocs, int);
+   }
+  #endif
+
+/* -- size the buffers -- */
+
+  n = 0;
+  for (q = 0; q < nprocs; q++){
+    n += BoxWalk (sbox + prank, dbox + q, NULL, NULL, nc, 0);
+    n += BoxWalk (sbox + q, dbox + prank, NULL, NULL, nc, 0);
+  }
+  if (n > nbuf){
+    if (nbuf > 0){
+      FreeArray1D((void *) sbuf);
+      FreeArray1D((void *) rbuf);
+    }
+    nbuf = n;
+    sbuf = ARRAY_1D(nbuf, double);
+    rbuf = ARRAY_1D(nbuf, double);
+  }
+
+  #ifdef PARALLEL
+   n = 0;
+   for (q = 0; q < nprocs; q++){
+     sdsp[q] = n;
+     scnt[q] = BoxWalk (sbox + prank, dbox + q, src, sbuf + n, nc, 1);
+     n += scnt[q];
+   }
+   n = 0;
+   for (q = 0; q < nprocs; q++){
+     rdsp[q] = n;
+     rcnt[q] = BoxWalk (sbox + q, dbox + prank, NULL, NULL, nc, 0);
+     n += rcnt[q];
+   }
+   MPI_Alltoallv (sbuf, scnt, sdsp, MPI_DOUBLE, rbuf, rcnt, rdsp,
+                  MPI_DOUBLE, MPI_COMM_WORLD);
+   for (q = 0; q < nprocs; q++){
+     BoxWalk (sbox + q, dbox + prank, dst, rbuf + rdsp[q], nc, 2);
+   }
+  #else
+   BoxWalk (sbox, dbox, src, sbuf, nc, 1);
+   BoxWalk (sbox, dbox, dst, sbuf, nc, 2);
+  #endif
+}
+
+/* ********************************************************************* */
+void FFTLines (double *a, SG_Box *box, int dir, int sign)
+/*!
+ * Fourier transform the complex array \c a, defined on \c box,
+ * along direction \c dir.
+ *
+ * \param [in,out] a     complex array (real and imaginary parts
+ *                       interleaved)
+ * \param [in]     box   the box where \c a is defined
+ * \param [in]     dir   the direction of the transform
+ * \param [in]     sign  -1 for the forward, +1 for the inverse
+ *                       (unnormalized) transform
+ *
+ *********************************************************************** */
+{
+  int  n[3], l, p, q, len, i1, i2;
+  long stride, base, m;
+  static int nw[3] = {0, 0, 0};
+  static double *w[3], *x, *y;
+
+  for (l = 0; l < 3; l++) n[l] = box->end[l] - box->beg[l] + 1;
+  if (n[0] <= 0 || n[1] <= 0 || n[2] <= 0) return;
+  len = n[dir];
+
+/* -- table of roots of unity, one per direction -- */
+
+  if (nw[dir] != len){
+    if (nw[dir] > 0) FreeArray1D((void *) w[dir]);
+    nw[dir] = len;
+    w[dir]  = ARRAY_1D(2*len, double);
+    for (l = 0; l < len; l++){
+      w[dir][2*l]     = cos(2.0*CONST_PI*l/len);
+      w[dir][2*l + 1] = sin(2.0*CONST_PI*l/len);
+    }
+  }
+  if (x == NULL){
+    x = ARRAY_1D(2*MAX(MAX(N[0], N[1]), N[2]), double);
+    y = ARRAY_1D(2*MAX(MAX(N[0], N[1]), N[2]), double);
+  }
+
+  stride = (dir == 0 ? 1:(dir == 1 ? n[0]:(long)n[0]*n[1]));
+  i1 = (dir == 0 ? 1:0);
+  i2 = (dir == 2 ? 1:2);
+  for (q = 0; q < n[i2]; q++){
+  for (p = 0; p < n[i1]; p++){
+    base = (dir == 0 ? (long)q*n[0]*n[1] + (long)p*n[0]:
+           (dir == 1 ? (long)q*n[0]*n[1] + p:(long)q*n[0] + p));
+    for (l = 0; l < len; l++){
+      m = base + l*stride;
+      x[2*l]     = a[2*m];
+      x[2*l + 1] = a[2*m + 1];
+    }
+    FFT (x, y, len, 1, sign, len, w[dir]);
+    for (l = 0; l < len; l++){
+      m = base + l*stride;
+      a[2*m]     = y[2*l];
+      a[2*m + 1] = y[2*l + 1];
+    }
+  }}
+}
+
+/* ********************************************************************* */
+int FFTSize (int n)
+/*!
+ * Return the smallest integer >= \c n with no prime factors other
+ * than 2 and 3.
+ *
+ *********************************************************************** */
+{
+  int m;
+
+  for (;; n++){
+    m = n;
+    while (m % 2 == 0) m /= 2;
+    while (m % 3 == 0) m /= 3;
+    if (m == 1) return n;
+  }
+}
+
+/* ********************************************************************* */
+void FFT (double *x, double *y, int n, int s, int sign, int nw,
+          double *w)
+/*!
+ * Recursive mixed-radix Cooley-Tukey transform
+ * \f$ y_k = \sum_j x_{js} e^{\pm 2\pi i jk/n} \f$.
+ * A factor \c p of \c n (4 when possible, the smallest prime
+ * factor otherwise) is split off at every level; radix 2, 3 and 4
+ * butterflies are written out, other factors (and prime lengths)
+ * are transformed directly.
+ *
+ * \param [in]  x      input sequence (complex, stride \c s)
+ * \param [out] y      output sequence (complex, contiguous)
+ * \param [in]  n      length of the transform
+ * \param [in]  s      stride of the input sequence
+ * \param [in]  sign   sign of the exponent
+ * \param [in]  nw     length of the top-level transform
+ * \param [in]  w      the \c nw roots of unity
+ *
+ *********************************************************************** */
+{
+  int  p, m, r, q, k, step;
+  long iw;
+  double tr, ti, wr, wi, *y0, *y1, *y2, *y3;
+  double a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+  static double *t;
+
+  if (t == NULL) t = ARRAY_1D(2*MAX(MAX(N[0], N[1]), N[2]), double);
+
+  if (n % 4 == 0) p = 4;
+  else {
+    for (p = 2; p*p <= n && n % p; p++);
+    if (n % p) p = n;
+  }
+  m    = n/p;
+  step = nw/n;
+
+/* -- p transforms of length m (copies when m = 1) -- */
+
+  if (m == 1){
+    for (r = 0; r < p; r++){
+      y[2*r]     = x[2*r*s];
+      y[2*r + 1] = x[2*r*s + 1];
+    }
+  }else{
+    for (r = 0; r < p; r++) FFT (x + 2*r*s, y + 2*r*m, m, s*p, sign, nw, w);
+  }
+
+/* -- butterflies of radix p -- */
+
+  if (p == 2){
+    y1 = y + 2*m;
+    for (k = 0; k < m; k++){
+      wr = w[2*k*step];
+      wi = sign*w[2*k*step + 1];
+      tr = y1[2*k]*wr - y1[2*k + 1]*wi;
+      ti = y1[2*k]*wi + y1[2*k + 1]*wr;
+      y1[2*k]     = y[2*k] - tr;
+      y1[2*k + 1] = y[2*k + 1] - ti;
+      y[2*k]     += tr;
+      y[2*k + 1] += ti;
+    }
+    return;
+  }
+
+  if (p == 3){
+    y1 = y + 2*m; y2 = y + 4*m;
+    for (k = 0; k < m; k++){
+      iw = (long)k*step;
+      wr = w[2*iw]; wi = sign*w[2*iw + 1];
+      a1r = y1[2*k]*wr - y1[2*k + 1]*wi;
+      a1i = y1[2*k]*wi + y1[2*k + 1]*wr;
+      wr = w[4*iw]; wi = sign*w[4*iw + 1];
+      a2r = y2[2*k]*wr - y2[2*k + 1]*wi;
+      a2i = y2[2*k]*wi + y2[2*k + 1]*wr;
+
+      tr  = a1r + a2r;  ti  = a1i + a2i;
+      a3r = sign*0.8660254037844386*(a1r - a2r);
+      a3i = sign*0.8660254037844386*(a1i - a2i);
+      a0r = y[2*k] - 0.5*tr;  a0i = y[2*k + 1] - 0.5*ti;
+
+      y[2*k]  += tr;          y[2*k + 1]  += ti;
+      y1[2*k]  = a0r - a3i;   y1[2*k + 1]  = a0i + a3r;
+      y2[2*k]  = a0r + a3i;   y2[2*k + 1]  = a0i - a3r;
+    }
+    return;
+  }
+
+  if (p == 4){
+    y0 = y; y1 = y + 2*m; y2 = y + 4*m; y3 = y + 6*m;
+    for (k = 0; k < m; k++){
+      iw = (long)k*step;
+      wr = w[2*iw]; wi = sign*w[2*iw + 1];
+      a1r = y1[2*k]*wr - y1[2*k + 1]*wi;
+      a1i = y1[2*k]*wi + y1[2*k + 1]*wr;
+      wr = w[4*iw]; wi = sign*w[4*iw + 1];
+      a2r = y2[2*k]*wr - y2[2*k + 1]*wi;
+      a2i = y2[2*k]*wi + y2[2*k + 1]*wr;
+      wr = w[6*iw]; wi = sign*w[6*iw + 1];
+      a3r = y3[2*k]*wr - y3[2*k + 1]*wi;
+      a3i = y3[2*k]*wi + y3[2*k + 1]*wr;
+
+      a0r = y0[2*k] + a2r; a0i = y0[2*k + 1] + a2i;
+      a2r = y0[2*k] - a2r; a2i = y0[2*k + 1] - a2i;
+      tr  = a1r + a3r;     ti  = a1i + a3i;
+      a3r = a1r - a3r;     a3i = a1i - a3i;   /* times sign*i below */
+
+      y0[2*k] = a0r + tr;        y0[2*k + 1] = a0i + ti;
+      y2[2*k] = a0r - tr;        y2[2*k + 1] = a0i - ti;
+      y1[2*k] = a2r - sign*a3i;  y1[2*k + 1] = a2i + sign*a3r;
+      y3[2*k] = a2r + sign*a3i;  y3[2*k + 1] = a2i - sign*a3r;
+    }
+    return;
+  }
+
+  for (k = 0; k < m; k++){
+    for (r = 0; r < p; r++){
+      iw = (long)r*k*step;
+      wr = w[2*iw];
+      wi = sign*w[2*iw + 1];
+      t[2*r]     = y[2*(r*m + k)]*wr - y[2*(r*m + k) + 1]*wi;
+      t[2*r + 1] = y[2*(r*m + k)]*wi + y[2*(r*m + k) + 1]*wr;
+    }
+    for (q = 0; q < p; q++){
+      tr = ti = 0.0;
+      for (r = iw = 0; r < p; r++){  /* iw = r*q mod p */
+        wr = w[2*iw*(nw/p)];
+        wi = sign*w[2*iw*(nw/p) + 1];
+        tr += t[2*r]*wr - t[2*r + 1]*wi;
+        ti += t[2*r]*wi + t[2*r + 1]*wr;
+        iw += q;
+        if (iw >= p) iw -= p;
+      }
+      y[2*(q*m + k)]     = tr;
+      y[2*(q*m + k) + 1] = ti;
+    }
+  }
+}
+#endif /* CH_SPACEDIM */
+
+/* ********************************************************************* */
+double ***SelfGravityPotential (void)
+/*!
+ * Return the cell-centered potential in the local domain (or in
+ * the current patch with AMR).
+ *
+ *********************************************************************** */
+{
+  return Phi;
+}
+
+#ifdef CH_SPACEDIM
+/* ********************************************************************* */
+void SelfGravitySetPotential (double ***phi)
+/*!
+ * Set the potential of the patch being integrated (AMR only).
+ *
+ *********************************************************************** */
+{
+  Phi = phi;
+}
+#endif
+
+/* ********************************************************************* */
+void SelfGravityAddPotential (double *phi_p, int beg, int end)
+/*!
+ * Add the potential at the interfaces \c beg ... \c end
+ * (<tt> i+1/2 </tt>) of the current sweep, taken as the average
+ * of the two adjacent zones, to \c phi_p.
+ *
+ *********************************************************************** */
+{
+  int i, j, k, n;
+
+  i = g_i; j = g_j; k = g_k;
+  if (g_dir == IDIR){
+    n = MIN(end, NX1_TOT - 2);
+    for (i = beg; i <= n; i++) phi_p[i] += 0.5*(Phi[k][j][i] + Phi[k][j][i+1]);
+    for (     ; i <= end; i++) phi_p[i] += Phi[k][j][i];
+  }else if (g_dir == JDIR){
+    n = MIN(end, NX2_TOT - 2);
+    for (j = beg; j <= n; j++) phi_p[j] += 0.5*(Phi[k][j][i] + Phi[k][j+1][i]);
+    for (     ; j <= end; j++) phi_p[j] += Phi[k][j][i];
+  }else if (g_dir == KDIR){
+    n = MIN(end, NX3_TOT - 2);
+    for (k = beg; k <= n; k++) phi_p[k] += 0.5*(Phi[k][j][i] + Phi[k+1][j][i]);
+    for (     ; k <= end; k++) phi_p[k] += Phi[k][j][i];
+  }
+}
+#endif
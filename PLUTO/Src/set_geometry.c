@@ -44,6 +44,8 @@ void MakeGeometry (Grid *GXYZ)
     (GXYZ + idim)->dV      = ARRAY_1D (GXYZ[idim].np_tot, double);
     (GXYZ + idim)->r_1     = ARRAY_1D (GXYZ[idim].np_tot, double);
     (GXYZ + idim)->ct      = ARRAY_1D (GXYZ[idim].np_tot, double);
+    (GXYZ + idim)->st      = ARRAY_1D (GXYZ[idim].np_tot, double);
+    (GXYZ + idim)->st_1    = ARRAY_1D (GXYZ[idim].np_tot, double);
     (GXYZ + idim)->inv_dx  = ARRAY_1D (GXYZ[idim].np_tot, double);
     (GXYZ + idim)->inv_dxi = ARRAY_1D (GXYZ[idim].np_tot, double);
   }
@@ -116,6 +118,8 @@ void MakeGeometry (Grid *GXYZ)
      GG->xgc[j]  = (sin(xr) - sin(xl) + xl*cos(xl) - xr*cos(xr));
      GG->xgc[j] /= cos(xl) - cos(xr);
      GG->ct[j]   = 1.0/tan(x);  /* (sin(xr) - sin(xl))/(cos(xl) - cos(xr)); */
+     GG->st[j]   = sin(x);
+     GG->st_1[j] = 1.0/GG->st[j];
     #endif
   }
 
@@ -265,8 +269,7 @@ double *GetInverse_dl (const Grid *grid)
     return inv_dl2;
   }else if (g_dir == KDIR){
     r_1 = grid[IDIR].r_1[g_i];
-    s   = grid[JDIR].x[g_j];
-    s   = sin(s);
+    s   = grid[JDIR].st[g_j];
     KTOT_LOOP(k) inv_dl3[k] = grid[KDIR].inv_dx[k]*r_1/s;
     return inv_dl3;
   }
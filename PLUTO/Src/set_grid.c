@@ -206,6 +206,8 @@ void FreeGrid (Grid *grid)
     FreeArray1D(grid[dir].A-1);
     FreeArray1D(grid[dir].r_1);
     FreeArray1D(grid[dir].ct);
+    FreeArray1D(grid[dir].st);
+    FreeArray1D(grid[dir].st_1);
     FreeArray1D(grid[dir].inv_dx);
     FreeArray1D(grid[dir].inv_dxi);
   }
@@ -182,6 +182,7 @@ void ResetState (const Data *d, State_1D *state, Grid *grid)
   for (i = 0; i < NMAX_POINT; i++){
     for (j = NVAR; j--;  ) state->src[i][j] = 0.0;
 
+    if (state->Lp == NULL) continue;
     for (j = NFLX; j--;  ){
     for (k = NFLX; k--;  ){
       state->Lp[i][j][k] = state->Rp[i][j][k] = 0.0;
@@ -15,6 +15,10 @@
   
   The function GetUserVar() returns the memory address to a 
   user-defined 3D array.
+  Variable names are looked up through a small hash table built
+  once by SetOutput() (the list of names is the same for all
+  output types), so that repeated calls at output time do not
+  scan the whole list.
 
   \note Starting with PLUTO 4.1 velocity and magnetic field components 
         will be saved as scalars when writing VTK output. 
@@ -32,7 +36,16 @@
  #define VTK_VECTOR_DUMP NO
 #endif
 
+#define VAR_HASH_SIZE  256  /* must be a power of 2 larger than the
+                                 max number of output variables (64) */
+
 static Output *all_outputs;
+static int var_hash[VAR_HASH_SIZE];
+
+static unsigned int VarHashKey (const char *);
+static void BuildVarHash (Output *);
+static int  VarIndex (const char *);
+
 /* ********************************************************************* */
 void SetOutput (Data *d, Runtime *runtime)
 /*!
@@ -182,6 +195,8 @@ void SetOutput (Data *d, Runtime *runtime)
     #endif
   }
  
+  BuildVarHash (all_outputs);
+
 /* -- exclude stag components from all output except .dbl -- */
 
   #ifdef STAGGERED_MHD
@@ -230,16 +245,15 @@ int SetDumpVar (char *var_name, int out_type, int flag)
     if (output->type == out_type) break;
   }
 
-  for (nv = output->nvar; nv--; ) { 
-    if (strcmp(output->var_name[nv], var_name) == 0) { 
-      output->dump_var[nv] = flag;
-      if (flag == YES){
-        if (out_type == PPM_OUTPUT || out_type == PNG_OUTPUT){
-          CreateImage (var_name);
-        }
+  nv = VarIndex (var_name);
+  if (nv >= 0) { 
+    output->dump_var[nv] = flag;
+    if (flag == YES){
+      if (out_type == PPM_OUTPUT || out_type == PNG_OUTPUT){
+        CreateImage (var_name);
       }
-      return(0);
     }
+    return(0);
   }
 
   print1 ("! var_name '%s' cannot be set/unset for writing\n",var_name);
@@ -255,13 +269,65 @@ double ***GetUserVar (char *var_name)
  *
  *********************************************************************** */
 {
-  int indx = -1;
+  int indx;
   
-  while (strcmp(all_outputs->var_name[++indx], var_name)){
-    if (all_outputs->V[indx] == NULL){
-      print1 ("! Error: uservar '%s' is not allocated\n"); 
-      QUIT_PLUTO(1);
-    }
+  indx = VarIndex (var_name);
+  if (indx < 0 || all_outputs->V[indx] == NULL){
+    print1 ("! Error: uservar '%s' is not allocated\n", var_name); 
+    QUIT_PLUTO(1);
   }
   return (all_outputs->V[indx]);
 }
+
+/* ********************************************************************* */
+unsigned int VarHashKey (const char *var_name)
+/*!
+ *  Return the (djb2) hash key of a variable name.
+ *
+ *********************************************************************** */
+{
+  unsigned int key = 5381;
+
+  while (*var_name) key = 33*key + (unsigned char)(*var_name++);
+  return key & (VAR_HASH_SIZE - 1);
+}
+
+/* ********************************************************************* */
+void BuildVarHash (Output *output)
+/*!
+ *  Fill the hash table with the indices of the variable names of 
+ *  \c output (open addressing with linear probing).
+ *
+ *********************************************************************** */
+{
+  int nv;
+  unsigned int h;
+
+  for (h = 0; h < VAR_HASH_SIZE; h++) var_hash[h] = -1;
+  for (nv = 0; nv < output->nvar; nv++){
+    h = VarHashKey (output->var_name[nv]);
+    while (var_hash[h] >= 0) h = (h + 1) & (VAR_HASH_SIZE - 1);
+    var_hash[h] = nv;
+  }
+}
+
+/* ********************************************************************* */
+int VarIndex (const char *var_name)
+/*!
+ *  Return the index of the variable named 'var_name' in the 
+ *  output arrays or -1 if no such variable exists.
+ *
+ *********************************************************************** */
+{
+  int n;
+  unsigned int h;
+
+  h = VarHashKey (var_name);
+  for (n = 0; n < VAR_HASH_SIZE && var_hash[h] >= 0; n++){
+    if (strcmp(all_outputs->var_name[var_hash[h]], var_name) == 0) {
+      return var_hash[h];
+    }
+    h = (h + 1) & (VAR_HASH_SIZE - 1);
+  }
+  return -1;
+}
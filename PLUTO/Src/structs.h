@@ -20,7 +20,7 @@ typedef struct CMD_LINE {
   int nproc[3];  /* -- user supplied number of processors -- */
   int show_dec; /* -- show domain decomposition ? -- */
   int xres; /* -- change the resolution via command line -- */
-  int fill; /* useless, it makes the struct a power of 2 */ 
+  int active; /* -- restrict integration to the disturbed region -- */
 } Cmd_Line;
    
 /* ********************************************************************* */
@@ -87,6 +87,8 @@ typedef struct GRID{
   double *A;            /**< Right interface area, A[i] = \f$A_{i+\HALF}\f$. */
   double *r_1;          /**< Geometrical factor 1/r.  */
   double *ct;           /**< Geometrical factor cot(theta).  */
+  double *st;           /**< Geometrical factor sin(theta).  */
+  double *st_1;         /**< Geometrical factor 1/sin(theta).  */
   double *inv_dx;       /**<      */
   double *inv_dxi;      /**< inverse of the distance between the center of 
                              two cells, inv_dxi = \f$\DS \frac{2}{\Delta x_i +
@@ -120,7 +122,7 @@ typedef struct GRID{
   int nproc;       /**< number of processors for this grid. */
   int rank_coord;  /**< Parallel coordinate in a Cartesian topology. */
   int level;       /**< The current refinement level (chombo only). */
-  char fill[40];   /* useless, just to make the structure size a power of 2 */
+  char fill[24];   /* useless, just to make the structure size a power of 2 */
 } Grid;
    
 /* ********************************************************************* */
@@ -152,7 +154,8 @@ typedef struct STATE_1D{
   double **tc_flux;   /**< Thermal conduction flux    */
   double **res_flux;  /**< Resistive flux (current)   */
                           
-  double ***Lp, ***Rp; /**< Left and right primitive eigenvectors */
+  double ***Lp, ***Rp; /**< Left and right primitive eigenvectors (NULL
+                            when no characteristic projection is used) */
   double **lambda;     /**< Characteristic speed associated to Lp and Rp */
   double *lmax;   /**< Define the maximum k-characteristic speed over the domain */
   double *a2;     /**< Sound speed squared */ 
@@ -264,6 +267,8 @@ typedef struct RUNTIME{
   int    user_var;            /**< The number of additional user-variables being
                                  held in memory and written to disk */
   int    anl_dn;               /*  number of step increment for ANALYSIS */
+  int    part_np;             /**< Number of tracer particles (\c particles) */
+  int    part_dn;             /**< Step increment for particle output */
   char   solv_type[64];         /**< The Riemann solver (\c Solver) */
   char   user_var_name[128][128];
   char   output_dir[256];         /**< The name of the output directory
@@ -281,6 +286,10 @@ typedef struct RUNTIME{
   double  first_dt;        /**< The initial time step (\c first_dt) */
   double  anl_dt;          /**< Time step increment for Analysis()
                                 ( <tt> analysis (double) </tt> )*/
+  double  part_dt;         /**< Time increment for particle output
+                                ( <tt> particles (int) (double) </tt> )*/
+  double  nest_center[3];  /**< Center of the nested grids 
+                                (\c nested_center) */
   double  aux[32];         /* we keep aux inside this structure, 
                               since in parallel execution it has
                               to be comunicated to all processors  */
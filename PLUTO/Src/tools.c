@@ -77,10 +77,15 @@ void MakeState (State_1D *state)
   state->SL      = ARRAY_1D(NMAX_POINT, double);
   state->SR      = ARRAY_1D(NMAX_POINT, double);
 
-/* -- eigenvectors -- */
+/* -- eigenvectors (only when the projection is used) -- */
 
-  state->Lp      = ARRAY_3D(NMAX_POINT, NFLX, NFLX, double);
-  state->Rp      = ARRAY_3D(NMAX_POINT, NFLX, NFLX, double);
+  #if CHAR_LIMITING == YES || TIME_STEPPING == CHARACTERISTIC_TRACING \
+      || defined FINITE_DIFFERENCE
+   state->Lp      = ARRAY_3D(NMAX_POINT, NFLX, NFLX, double);
+   state->Rp      = ARRAY_3D(NMAX_POINT, NFLX, NFLX, double);
+  #else
+   state->Lp = state->Rp = NULL;
+  #endif
   state->lambda  = ARRAY_2D(NMAX_POINT, NFLX, double);
   state->lmax    = ARRAY_1D(NVAR, double);
 
@@ -164,6 +164,9 @@ void WriteData (const Data *d, Output *output, Grid *grid)
         CloseBinaryFile (fbin, sz);
       }
     }
+    #if NESTED_LEVELS > 0
+     Nested_WriteData (output);
+    #endif
 
   } else if (output->type == FLT_OUTPUT) {
 
@@ -147,9 +147,10 @@ void GetSlice (double ***Vdbl, Image *image, Grid *grid)
  * PURPOSE
  *
  *  get a 2D slice from the 3D array Vdbl.
- *  The array is actually written to disk and
- *  re-open for reading immediately after by
- *  proc #0. 
+ *  Only the processors whose local domain is cut by
+ *  the slice plane extract their part of the slice
+ *  (in single precision); the tiles are then gathered
+ *  by proc #0. 
  *  Store its content as 2D rgb structure inside 
  *  image->rgb.
  *   
@@ -158,42 +159,59 @@ void GetSlice (double ***Vdbl, Image *image, Grid *grid)
  ************************************************************* */
 {
   int i, j, k;
-  int nx, ny, nz;
-  int col_offset, row_offset;
+  int dn, dc, dr, sl, idx[3];
+  int col0, row0, ncl, nrw;
   int offset, ir, ic;
-  char filename[256];
   float xflt, slice_min, slice_max;
+  float *tile;
   static float **slice;
   static RGB **rgb;
-  FILE *fl;
-  size_t dsize = sizeof(float);
 
   #if DIMENSIONS == 1
    print1 ("! PPM output disabled in 1-D\n");
    return;    
   #endif    
 
-/* ------------------------------------------------ 
-    Write the whole array in single precision
-    Slice are post-processed later 
+/* ------------------------------------------------
+    Normal (dn), column (dc) and row (dr) 
+    directions of the slice plane
    ------------------------------------------------ */
-  
-  fl = OpenBinaryFile ("tmp_file.out", SZ_float, "w");
-  WriteBinaryArray ((Convert_dbl2flt(Vdbl,1.0, 0))[0][0], dsize, SZ_float, fl, -1); 
-  CloseBinaryFile (fl, SZ_float);
-  #ifdef PARALLEL
-   MPI_Barrier (MPI_COMM_WORLD);
-  #endif
 
-  if (prank != 0) return; /* -- rank 0 will do the rest -- */
+  if (image->slice_plane == X13_PLANE){
+    dn = JDIR; dc = IDIR; dr = KDIR;
+  }else if (image->slice_plane == X23_PLANE){
+    dn = IDIR; dc = JDIR; dr = KDIR;
+  }else{
+    dn = KDIR; dc = IDIR; dr = JDIR;
+  }
+
+  image->ncol = grid[dc].gend + 1 - grid[dc].nghost;
+  image->nrow = grid[dr].gend + 1 - grid[dr].nghost;
 
 /* ------------------------------------------------
-          get global dimensions
+    Extract the local tile, if any: sl is the 
+    local index of the slice along dn
    ------------------------------------------------ */
 
-  nx = grid[IDIR].gend + 1 - grid[IDIR].nghost;
-  ny = grid[JDIR].gend + 1 - grid[JDIR].nghost;
-  nz = grid[KDIR].gend + 1 - grid[KDIR].nghost;
+  sl   = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid)
+         - (grid[dn].beg - grid[dn].nghost);
+  col0 = grid[dc].beg - grid[dc].nghost;
+  row0 = grid[dr].beg - grid[dr].nghost;
+  ncl  = nrw = 0;
+  if (sl >= 0 && sl < grid[dn].np_int){
+    ncl = grid[dc].np_int;
+    nrw = grid[dr].np_int;
+  }
+
+  tile = ARRAY_1D(MAX(ncl*nrw,1), float);
+  idx[dn] = grid[dn].lbeg + sl;
+  for (ir = 0; ir < nrw; ir++){
+    idx[dr] = grid[dr].lbeg + ir;
+    for (ic = 0; ic < ncl; ic++){
+      idx[dc] = grid[dc].lbeg + ic;
+      tile[ir*ncl + ic] = (float)Vdbl[idx[KDIR]][idx[JDIR]][idx[IDIR]];
+    }
+  }
 
 /* -----------------------------------------
      Allocate memory: make slices big
@@ -201,67 +219,67 @@ void GetSlice (double ***Vdbl, Image *image, Grid *grid)
      sizes.
    ----------------------------------------- */
 
-  if (slice == NULL) {
-    ic = MAX(nx,ny); 
-    ir = MAX(ny,nz);
+  if (prank == 0 && slice == NULL) {
+    i = grid[IDIR].gend + 1 - grid[IDIR].nghost;
+    j = grid[JDIR].gend + 1 - grid[JDIR].nghost;
+    k = grid[KDIR].gend + 1 - grid[KDIR].nghost;
+    ic = MAX(i,j); 
+    ir = MAX(j,k);
     slice = ARRAY_2D(ir, ic, float);
     rgb   = ARRAY_2D(ir, ic, RGB);
   }
 
-/* --------------------------------------------
-       set offsets for slice reading
-   -------------------------------------------- */
-
-  fl = fopen ("tmp_file.out", "rb");
-  if (image->slice_plane == X12_PLANE){
-
-    k = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
-    offset = k*nx*ny*dsize; 
-    fseek (fl, offset, SEEK_SET);
-    col_offset = 0;
-    row_offset = 0;
-    image->ncol = nx;
-    image->nrow = ny;
-
-  } else if (image->slice_plane == X13_PLANE){
-
-    j = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
-    offset = j*nx*dsize;
-    fseek (fl, offset, SEEK_CUR);
-    col_offset = 0;
-    row_offset = nx*(ny - 1)*dsize; 
-    image->ncol = nx;
-    image->nrow = nz;
-
-  } else if (image->slice_plane == X23_PLANE){
-    
-    i = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
-    offset = i*dsize;
-    fseek (fl, offset, SEEK_CUR);
-    col_offset = (nx - 1)*dsize; 
-    row_offset = 0;
-    image->ncol = ny;
-    image->nrow = nz;
-
-  }
-
-/* -----------------------------------------
-            Read slice  
-   ----------------------------------------- */
+/* -----------------------------------------------------
+    Gather the tiles on proc #0 and copy them 
+    into the slice, swapping row order
+   ----------------------------------------------------- */
 
-  for (ir = 0; ir < image->nrow; ir++) {
-    for (ic = 0; ic < image->ncol; ic++) {     
-      fread (&xflt, dsize, 1, fl);
-      if (feof(fl)){
-         printf (" ! end of file reached\n");
-         QUIT_PLUTO(1);
+  #ifdef PARALLEL
+  {
+    int n, nproc, meta[4], *all, *cnt, *displ;
+    float *buf;
+
+    MPI_Comm_size (MPI_COMM_WORLD, &nproc);
+    meta[0] = col0; meta[1] = row0; meta[2] = ncl; meta[3] = nrw;
+    all   = ARRAY_1D(4*nproc, int);
+    cnt   = ARRAY_1D(nproc, int);
+    displ = ARRAY_1D(nproc, int);
+    MPI_Gather (meta, 4, MPI_INT, all, 4, MPI_INT, 0, MPI_COMM_WORLD);
+    offset = 0;
+    if (prank == 0){
+      for (n = 0; n < nproc; n++){
+        cnt[n]   = all[4*n + 2]*all[4*n + 3];
+        displ[n] = offset;
+        offset  += cnt[n];
+      }
+    }
+    buf = ARRAY_1D(MAX(offset,1), float);
+    MPI_Gatherv (tile, ncl*nrw, MPI_FLOAT, buf, cnt, displ, MPI_FLOAT,
+                 0, MPI_COMM_WORLD);
+    if (prank == 0){
+      for (n = 0; n < nproc; n++){
+        col0 = all[4*n];     row0 = all[4*n + 1];
+        ncl  = all[4*n + 2]; nrw  = all[4*n + 3];
+        for (ir = 0; ir < nrw; ir++){
+          memcpy (slice[image->nrow - 1 - row0 - ir] + col0,
+                  buf + displ[n] + ir*ncl, ncl*sizeof(float));
+        }
       }
-      slice[image->nrow - 1 - ir][ic] = xflt;  /* -- swap row order -- */
-      if (col_offset > 0) fseek(fl, col_offset, SEEK_CUR);
     }
-    if (row_offset > 0) fseek(fl, row_offset, SEEK_CUR);
+    FreeArray1D ((void *) buf);
+    FreeArray1D ((void *) all);
+    FreeArray1D ((void *) cnt);
+    FreeArray1D ((void *) displ);
   }
-  fclose(fl);
+  #else
+   for (ir = 0; ir < nrw; ir++){
+     memcpy (slice[image->nrow - 1 - row0 - ir] + col0,
+             tile + ir*ncl, ncl*sizeof(float));
+   }
+  #endif
+  FreeArray1D ((void *) tile);
+
+  if (prank != 0) return; /* -- rank 0 will do the rest -- */
 
 /* -----------------------------------------------------------
          Get slice max and min 
@@ -5,9 +5,9 @@ using std::string;
 #include "PatchPluto.H"
 #include "LoHiSide.H"
 
-static void computeRefVar(double ***UU[], double ***q, double, RBox *Ubox);
+static void computeRefVar(double *UU[], double *q, double, RBox *Ubox);
 
-#if (EOS != ISOTHERMAL) && (CHOMBO_EN_SWITCH == NO)
+#if (EOS != ISOTHERMAL) && (ENTROPY_SWITCH == NO)
  #ifndef CHOMBO_REF_VAR  
   #define CHOMBO_REF_VAR ENG 
  #endif
@@ -17,10 +17,64 @@ static void computeRefVar(double ***UU[], double ***q, double, RBox *Ubox);
  #endif
 #endif
 
-// #define CHOMBO_REF_VAR -1  /* means user-defined */
-
 #define REF_CRIT 2   /* 1 == first derivative, 2 == second derivative */
 
+/* ********************************************************************* */
+static inline double GradientNorm (const double *q, int sy, int sz,
+                                   double eps,
+                                   double dqx_p, double dqx_m,
+                                   double dqy_p, double dqy_m,
+                                   double dqz_p, double dqz_m)
+/*!
+ * Return the normalized 1st (REF_CRIT == 1) or 2nd (REF_CRIT == 2)
+ * derivative error norm at the zone pointed to by q, given the
+ * right (_p) and left (_m) undivided differences in each direction.
+ * sy and sz are the strides of the x2 and x3 directions.
+ *
+ *********************************************************************** */
+{
+  double den_x, den_y, den_z, gr;
+
+#if REF_CRIT == 1
+  double dqx, dqy, dqz;
+
+  D_EXPAND(dqx = dqx_p + dqx_m;  ,
+           dqy = dqy_p + dqy_m;  ,
+           dqz = dqz_p + dqz_m;)
+
+  D_EXPAND(den_x = fabs(q[1])  + fabs(q[-1]);   ,
+           den_y = fabs(q[sy]) + fabs(q[-sy]);  ,
+           den_z = fabs(q[sz]) + fabs(q[-sz]);)
+
+  gr  = D_EXPAND(dqx*dqx, + dqy*dqy, + dqz*dqz);
+  gr /= D_EXPAND(den_x*den_x, + den_y*den_y, + den_z*den_z);
+#endif
+
+#if REF_CRIT == 2
+  double d2qx, d2qy, d2qz;
+
+  D_EXPAND(d2qx = dqx_p - dqx_m;  ,
+           d2qy = dqy_p - dqy_m;  ,
+           d2qz = dqz_p - dqz_m;)
+
+  D_EXPAND(
+    den_x = 2.0*fabs(q[0]) + fabs(q[1])  + fabs(q[-1]);
+    den_x = fabs(dqx_p) + fabs(dqx_m) + eps*den_x;    ,
+
+    den_y = 2.0*fabs(q[0]) + fabs(q[sy]) + fabs(q[-sy]);
+    den_y = fabs(dqy_p) + fabs(dqy_m) + eps*den_y;    ,
+
+    den_z = 2.0*fabs(q[0]) + fabs(q[sz]) + fabs(q[-sz]);
+    den_z = fabs(dqz_p) + fabs(dqz_m) + eps*den_z;
+  )
+
+  gr  = D_EXPAND(d2qx*d2qx,   + d2qy*d2qy,   + d2qz*d2qz);
+  gr /= D_EXPAND(den_x*den_x, + den_y*den_y, + den_z*den_z);
+#endif
+
+  return sqrt(gr);
+}
+
 /* ************************************************************************* */
 void PatchPluto::computeRefGradient(FArrayBox& gFab, FArrayBox& UFab, 
                                     const FArrayBox& a_dV, const Box& b)
@@ -43,8 +97,14 @@ void PatchPluto::computeRefGradient(FArrayBox& gFab, FArrayBox& UFab,
  * U[CHOMBO_REF_VAR] 
  * where CHOMBO_REF_VAR is taken to be energy density (default).
  * However, by setting CHOMBO_REF_VAR = -1, you can provide your own 
- * physical variable through the function computeRefVar().
- * 
+ * physical variable (possibly a combination of several conserved
+ * variables) through the function computeRefVar().
+ *
+ * The data are accessed as contiguous rows along x1 so that the 
+ * innermost loop carries no branches or divisions other than those
+ * of the error norm itself and can be vectorized by the compiler.
+ * Physical boundaries in x2 and x3 are handled once per row.
+ *
  * \authors C. Zanni   (zanni@oato.inaf.it)\n
  *          A. Mignone (mignone@ph.unito.it)
  * \date    Oct 11, 2012
@@ -53,22 +113,19 @@ void PatchPluto::computeRefGradient(FArrayBox& gFab, FArrayBox& UFab,
   CH_assert(m_isDefined);
 
   int nv, i, j, k;
-  double x1, dqx_p, dqx_m, dqx, d2qx, den_x;
-  double x2, dqy_p, dqy_m, dqy, d2qy, den_y;
-  double x3, dqz_p, dqz_m, dqz, d2qz, den_z;
-  double gr1, gr2, eps = 0.01;
- #if CHOMBO_REF_VAR == -1
-  double ***UU[NVAR];
- #endif
-  double ***q, ***grad;
+  int nxU, nyU, sy, sz, nxG;
+  int ibeg, iend, iL, iR;
+  int jlo, jhi, klo, khi;
+  double eps = 0.01;
+  double *q, *grad;
   RBox  Ubox, Gbox;
 
 /* -- check ref criterion -- */
 
-  #if REF_CRIT != 1 && REF_CRIT != 2
-   print ("! TagCells.cpp: Refinement criterion not valid\n");
-   QUIT_PLUTO(1);
-  #endif
+#if REF_CRIT != 1 && REF_CRIT != 2
+  print ("! TagCells.cpp: Refinement criterion not valid\n");
+  QUIT_PLUTO(1);
+#endif
 
 /* -----------------------------------------------------
    1. The solution array U is defined on the box 
@@ -90,227 +147,211 @@ void PatchPluto::computeRefGradient(FArrayBox& gFab, FArrayBox& UFab,
 
 /* --------------------------------------------------------
    2. Input solution array (UFab.dataPtr(nv)) is defined 
-      as dV*U/dx, where U is an array of conservative 
+      as dV*U/dx^3, where U is an array of conservative 
       variables and dV is the zone volume. 
       To obtain U we must divide by volume.
+      When no rescaling is needed, U[CHOMBO_REF_VAR] is
+      used in place.
    -------------------------------------------------------- */
- 
-  #if GEOMETRY != CARTESIAN
-
-   #if CHOMBO_REF_VAR  >= 0
-    UFab.divide(a_dV,0,CHOMBO_REF_VAR);
-   #else
-    for (nv = 0; nv < NVAR; nv++) UFab.divide(a_dV,0,nv); 
-   #endif
-
-   #if (CHOMBO_CONS_AM == YES) && \
-       ((CHOMBO_REF_VAR == iMPHI) ||  (CHOMBO_REF_VAR == -1))
-    #if ROTATING_FRAME == YES
-     Box curBox = UFab.box();
-     for(BoxIterator bit(curBox); bit.ok(); ++bit) {
-       const IntVect& iv = bit();
-       UFab(iv,iMPHI) /= a_dV(iv,1);
-       UFab(iv,iMPHI) -= UFab(iv,RHO)*a_dV(iv,1)*g_OmegaZ;
-     }
-    #else
-     UFab.divide(a_dV,1,iMPHI);
+
+#if CHOMBO_REF_VAR == -1
+  FArrayBox tmpU(UFab.box(),NVAR);
+  tmpU.copy(UFab);
+#else
+  FArrayBox tmpU;
+  q = UFab.dataPtr(CHOMBO_REF_VAR);
+ #if GEOMETRY == CARTESIAN
+  if (g_stretch_fact != 1.)
+ #endif
+  {
+    tmpU.define(UFab.box(),1);
+    tmpU.copy(UFab,CHOMBO_REF_VAR,0);
+    q = tmpU.dataPtr(0);
+  }
+#endif 
+
+#if GEOMETRY != CARTESIAN
+
+  #if CHOMBO_REF_VAR == -1
+
+    for (nv = 0; nv < NVAR; nv++) tmpU.divide(a_dV,0,nv);
+    #if CHOMBO_CONS_AM == YES
+      #if ROTATING_FRAME == YES
+        Box curBox = UFab.box();
+        for(BoxIterator bit(curBox); bit.ok(); ++bit) {
+          const IntVect& iv = bit();
+          tmpU(iv,iMPHI) /= a_dV(iv,1);
+          tmpU(iv,iMPHI) -= tmpU(iv,RHO)*a_dV(iv,1)*g_OmegaZ;
+        }
+      #else
+        tmpU.divide(a_dV,1,iMPHI);
+      #endif
     #endif
-   #endif
 
   #else
 
-   #if CHOMBO_REF_VAR  >= 0
-    if (g_stretch_fact != 1.) UFab.divide(g_stretch_fact,CHOMBO_REF_VAR);
-   #else
-    if (g_stretch_fact != 1.) UFab.divide(g_stretch_fact);
-   #endif
+    tmpU.divide(a_dV,0,0);
 
   #endif
 
+#else
+
+   if (g_stretch_fact != 1.) tmpU /= g_stretch_fact;
+
+#endif // GEOMETRY == CARTESIAN
+
 /* ---------------------------------------------
    3. Set refinement variable
    --------------------------------------------- */
 
-  #if CHOMBO_REF_VAR >= 0
-   q = ArrayBoxMap(Ubox.kb, Ubox.ke,
-                   Ubox.jb, Ubox.je,
-                   Ubox.ib, Ubox.ie, UFab.dataPtr(CHOMBO_REF_VAR));
-  #else
-   for (nv = 0; nv < NVAR; nv++)
-     UU[nv] = ArrayBoxMap(Ubox.kb, Ubox.ke,
-                          Ubox.jb, Ubox.je,
-                          Ubox.ib, Ubox.ie, UFab.dataPtr(nv));
-   q = ArrayBox(Ubox.kb, Ubox.ke, Ubox.jb, Ubox.je, Ubox.ib, Ubox.ie);
-   computeRefVar(UU, q, m_dx, &Ubox);
-  #endif
-  
-  grad = ArrayBoxMap(Gbox.kb, Gbox.ke, 
-                     Gbox.jb, Gbox.je, 
-                     Gbox.ib, Gbox.ie, gFab.dataPtr(0));
+#if CHOMBO_REF_VAR == -1
+  double *UU[NVAR];
+  FArrayBox qFab(UFab.box(),1);
+  for (nv = 0; nv < NVAR; nv++) UU[nv] = tmpU.dataPtr(nv);
+  q = qFab.dataPtr(0);
+  computeRefVar(UU, q, m_dx, &Ubox);
+#endif
+  grad = gFab.dataPtr(0);
 
 /* ----------------------------------------------------------------
    4. Main spatial loop for zone tagging based on 1st 
      (REF_CRIT = 1) or 2nd (REF_CRIT = 2) derivative error norm. 
-   ---------------------------------------------------------------- */
-
-  BOX_LOOP(&Gbox, k, j, i){
-    x3 = (k + 0.5)*m_dx*g_x3stretch + g_domBeg[KDIR];
-    x2 = (j + 0.5)*m_dx*g_x2stretch + g_domBeg[JDIR];
-   #if CHOMBO_LOGR == NO
-    x1 = (i + 0.5)*m_dx          + g_domBeg[IDIR];
-   #else
-    double xl = g_domBeg[IDIR] + i*m_dx;
-    double xr = xl + m_dx;
-    x1 = g_domBeg[IDIR]*0.5*(exp(xr)+exp(xl));
-   #endif 
-
-    D_EXPAND(dqx_p =    q[k][j][i+1] - q[k][j][i];
-             dqx_m = - (q[k][j][i-1] - q[k][j][i]);  ,
-             dqy_p =    q[k][j+1][i] - q[k][j][i];
-             dqy_m = - (q[k][j-1][i] - q[k][j][i]);  ,
-             dqz_p =    q[k+1][j][i] - q[k][j][i];
-             dqz_m = - (q[k-1][j][i] - q[k][j][i]);)
-
-  /* --------------------------------------------------------------
-      Physical boundary values are not up to date and should be 
-      excluded from gradient computation. 
-      In this case, left and right derivatives are set equal to 
-      each other. This will not trigger refinement in the leftmost 
-      and rightmost internal zones (using 2nd derivative) but we 
-      really don't care since buffer size will do the job.
-     -------------------------------------------------------------- */
-      
-    D_EXPAND(if (i == 0) dqx_m = dqx_p;  ,
-             if (j == 0) dqy_m = dqy_p;  ,
-             if (k == 0) dqz_m = dqz_p;)
-
-    D_EXPAND(if (i == m_domain.size(IDIR)-1) dqx_p = dqx_m;  ,
-             if (j == m_domain.size(JDIR)-1) dqy_p = dqy_m;  ,
-             if (k == m_domain.size(KDIR)-1) dqz_p = dqz_m;)
-
-  /* -----------------------------------------------
-         Compute gradient using 1st derivative 
-      ---------------------------------------------- */
-
-    #if REF_CRIT == 1
-     D_EXPAND(dqx = dqx_p + dqx_m;  ,
-              dqy = dqy_p + dqy_m;  ,
-              dqz = dqz_p + dqz_m;)
-
-     D_EXPAND(den_x = fabs(q[k][j][i+1]) + fabs(q[k][j][i-1]);  ,
-              den_y = fabs(q[k][j+1][i]) + fabs(q[k][j-1][i]);  ,
-              den_z = fabs(q[k+1][j][i]) + fabs(q[k-1][j][i]);)
-
-     gr1  = D_EXPAND(dqx*dqx, + dqy*dqy, + dqz*dqz);
-     gr1 /= D_EXPAND(den_x*den_x, + den_y*den_y, + den_z*den_z);
-
-     grad[k][j][i] = sqrt(gr1);
-    #endif
-
-  /* -----------------------------------------------
-         Compute gradient using 2nd derivative 
-      ---------------------------------------------- */
-
-    #if REF_CRIT == 2
-     D_EXPAND(d2qx = dqx_p - dqx_m;  ,
-              d2qy = dqy_p - dqy_m;  ,
-              d2qz = dqz_p - dqz_m;)
-
-     D_EXPAND(
-       den_x = 2.0*fabs(q[k][j][i]) + fabs(q[k][j][i+1]) + fabs(q[k][j][i-1]);
-       den_x = fabs(dqx_p) + fabs(dqx_m) + eps*den_x;    ,
-
-       den_y = 2.0*fabs(q[k][j][i]) + fabs(q[k][j+1][i]) + fabs(q[k][j-1][i]);
-       den_y = fabs(dqy_p) + fabs(dqy_m) + eps*den_y;    ,
-
-       den_z = 2.0*fabs(q[k][j][i]) + fabs(q[k+1][j][i]) + fabs(q[k-1][j][i]);
-       den_z = fabs(dqz_p) + fabs(dqz_m) + eps*den_z;
-     )
-
-     gr2  = D_EXPAND(d2qx*d2qx,   + d2qy*d2qy,   + d2qz*d2qz);
-     gr2 /= D_EXPAND(den_x*den_x, + den_y*den_y, + den_z*den_z);
-
-     grad[k][j][i] = sqrt(gr2);
-    #endif
-
- /* space-dependent refinement */
-    double x = x1*cos(x2), xc = 1.0/sqrt(2.0);
-    double y = x1*sin(x2), yc = 1.0/sqrt(2.0);
-    double r0 = 0.2;
-    double r = sqrt((x-xc)*(x-xc) + (y-yc)*(y-yc));
-    if (r < r0) grad[k][j][i] = 1.0;
-    else        grad[k][j][i] = 0.0;
-   
-  }
 
-/* --------------------------------------------------------------
-   5. Multiply U times volume again.
-   -------------------------------------------------------------- */
-
-  #if GEOMETRY != CARTESIAN
-
-   #if (CHOMBO_CONS_AM == YES) && ((CHOMBO_REF_VAR == iMPHI) || (CHOMBO_REF_VAR == -1))
-    #if ROTATING_FRAME == YES
-     for(BoxIterator bit(curBox); bit.ok(); ++bit) {
-       const IntVect& iv = bit();
-       UFab(iv,iMPHI) += UFab(iv,RHO)*a_dV(iv,1)*g_OmegaZ;
-       UFab(iv,iMPHI) *= a_dV(iv,1);
-     }
-    #else
-     UFab.mult(a_dV,1,iMPHI);
-    #endif
-   #endif
-
-   #if CHOMBO_REF_VAR >= 0
-    UFab.mult(a_dV,0,CHOMBO_REF_VAR);
-   #else
-    for (nv = 0; nv < NVAR; nv++) UFab.mult(a_dV,0,nv);
-   #endif
-
-  #else
+     Physical boundary values are not up to date and should be 
+     excluded from gradient computation. 
+     In this case, left and right derivatives are set equal to 
+     each other. This will not trigger refinement in the leftmost 
+     and rightmost internal zones (using 2nd derivative) but we 
+     really don't care since buffer size will do the job.
+     The x1 boundary zones, if any, are treated after each row. 
+   ---------------------------------------------------------------- */
 
-   #if CHOMBO_REF_VAR  >= 0
-    if (g_stretch_fact != 1.) UFab.mult(g_stretch_fact,CHOMBO_REF_VAR);
-   #else
-    if (g_stretch_fact != 1.) UFab.mult(g_stretch_fact);
-   #endif
+  nxU = Ubox.ie - Ubox.ib + 1;
+  nyU = Ubox.je - Ubox.jb + 1;
+  nxG = Gbox.ie - Gbox.ib + 1;
+  sy  = D_SELECT(0, nxU, nxU);
+  sz  = D_SELECT(0, 0, nxU*nyU);
+
+  iL = 0;
+  iR = m_domain.size(IDIR) - 1;
+  ibeg = (Gbox.ib == iL ? 1:0);            /* local index range of the */
+  iend = (Gbox.ie == iR ? nxG - 2:nxG - 1); /* zones away from x1 walls */
+
+  for (k = Gbox.kb; k <= Gbox.ke; k++){
+  for (j = Gbox.jb; j <= Gbox.je; j++){
+    double *qc = q + (k - Ubox.kb)*sz + (j - Ubox.jb)*sy + (Gbox.ib - Ubox.ib);
+    double *gr = grad + ((k - Gbox.kb)*(Gbox.je - Gbox.jb + 1) 
+                       + (j - Gbox.jb))*nxG;
+
+    jlo = khi = klo = jhi = 0;
+    D_EXPAND(                                              ,
+      jlo = (j == 0); jhi = (j == m_domain.size(JDIR)-1);  ,
+      klo = (k == 0); khi = (k == m_domain.size(KDIR)-1);)
+
+    for (i = ibeg; i <= iend; i++){
+      double dqx_p = 0.0, dqx_m = 0.0;
+      double dqy_p = 0.0, dqy_m = 0.0;
+      double dqz_p = 0.0, dqz_m = 0.0;
+
+      D_EXPAND(dqx_p =    qc[i+1]  - qc[i];
+               dqx_m = - (qc[i-1]  - qc[i]);     ,
+               dqy_p =    qc[i+sy] - qc[i];
+               dqy_m = - (qc[i-sy] - qc[i]);     ,
+               dqz_p =    qc[i+sz] - qc[i];
+               dqz_m = - (qc[i-sz] - qc[i]);)
+
+      D_EXPAND(                                ,
+               dqy_m = (jlo ? dqy_p:dqy_m);
+               dqy_p = (jhi ? dqy_m:dqy_p);    ,
+               dqz_m = (klo ? dqz_p:dqz_m);
+               dqz_p = (khi ? dqz_m:dqz_p);)
+
+      gr[i] = GradientNorm (qc + i, sy, sz, eps, dqx_p, dqx_m,
+                                                 dqy_p, dqy_m,
+                                                 dqz_p, dqz_m);
+    }
+
+  /* -- zones next to x1 physical boundaries -- */
+
+    for (i = 0; i < nxG; i += (nxG > 1 ? nxG - 1:1)){
+      double dqx_p = 0.0, dqx_m = 0.0;
+      double dqy_p = 0.0, dqy_m = 0.0;
+      double dqz_p = 0.0, dqz_m = 0.0;
+      int  iglob = Gbox.ib + i;
+
+      if (iglob != iL && iglob != iR) continue;
+
+      D_EXPAND(dqx_p =    qc[i+1]  - qc[i];
+               dqx_m = - (qc[i-1]  - qc[i]);     ,
+               dqy_p =    qc[i+sy] - qc[i];
+               dqy_m = - (qc[i-sy] - qc[i]);     ,
+               dqz_p =    qc[i+sz] - qc[i];
+               dqz_m = - (qc[i-sz] - qc[i]);)
+
+      D_EXPAND(if (iglob == iL) dqx_m = dqx_p;  ,
+               if (jlo) dqy_m = dqy_p;          ,
+               if (klo) dqz_m = dqz_p;)
+
+      D_EXPAND(if (iglob == iR) dqx_p = dqx_m;  ,
+               if (jhi) dqy_p = dqy_m;          ,
+               if (khi) dqz_p = dqz_m;)
+
+      gr[i] = GradientNorm (qc + i, sy, sz, eps, dqx_p, dqx_m,
+                                                 dqy_p, dqy_m,
+                                                 dqz_p, dqz_m);
+    }
+  }}
 
-  #endif
+/* ----------------------------------------------------------------
+   5. Space-dependent refinement around the planet: this
+      replaces the gradient criterion
+   ---------------------------------------------------------------- */
 
-/* --------------------------------------------------------------
-   6. Free array
-   -------------------------------------------------------------- */
-   
-  FreeArrayBoxMap(grad, Gbox.kb, Gbox.ke, Gbox.jb, Gbox.je, Gbox.ib, Gbox.ie);
-
-  #if CHOMBO_REF_VAR >= 0
-   FreeArrayBoxMap(q, Ubox.kb, Ubox.ke, Ubox.jb, Ubox.je, Ubox.ib, Ubox.ie);
-  #else
-   for (nv = 0; nv < NVAR; nv++){
-     FreeArrayBoxMap(UU[nv], Ubox.kb, Ubox.ke, 
-                             Ubox.jb, Ubox.je, Ubox.ib, Ubox.ie);
-   }
-   FreeArrayBox(q, Ubox.kb, Ubox.jb, Ubox.ib);
-  #endif
+  for (k = Gbox.kb; k <= Gbox.ke; k++){
+  for (j = Gbox.jb; j <= Gbox.je; j++){
+    double x1, x2, x3;
+    double *gr = grad + ((k - Gbox.kb)*(Gbox.je - Gbox.jb + 1) 
+                       + (j - Gbox.jb))*nxG - Gbox.ib;
 
+    x3 = (k + 0.5)*m_dx*g_x3stretch + g_domBeg[KDIR];
+    x2 = (j + 0.5)*m_dx*g_x2stretch + g_domBeg[JDIR];
+    for (i = Gbox.ib; i <= Gbox.ie; i++){
+#if CHOMBO_LOGR == NO
+      x1 = (i + 0.5)*m_dx          + g_domBeg[IDIR];
+#else
+      double xl = g_domBeg[IDIR] + i*m_dx;
+      double xr = xl + m_dx;
+      x1 = g_domBeg[IDIR]*0.5*(exp(xr)+exp(xl));
+#endif 
+
+      double x = x1*cos(x2), xc = 1.0/sqrt(2.0);
+      double y = x1*sin(x2), yc = 1.0/sqrt(2.0);
+      double r0 = 0.2;
+      double r = sqrt((x-xc)*(x-xc) + (y-yc)*(y-yc));
+      if (r < r0) gr[i] = 1.0;
+      else        gr[i] = 0.0;
+    }
+  }}
 }
 
 /* ********************************************************************* */
-void computeRefVar(double ***UU[], double ***q, double dx, RBox *Ubox)
+void computeRefVar(double *UU[], double *q, double dx, RBox *Ubox)
 /*!
  * Compute a user-defined array q(U) function of the conserved
  * variables.
- *
+ * UU[nv] and q are stored contiguously on the box Ubox, with the
+ * x1 index running fastest, i.e. zone (i,j,k) has offset
+ * (i - ib) + nx*((j - jb) + ny*(k - kb)). Writing the criterion as 
+ * a single loop over all zones allows it to be vectorized.
  *
  *********************************************************************** */
 {
-  int nv, i, j, k;
-  double us[NVAR], vs[NVAR];
+  int n, npt;
 
-  BOX_LOOP(Ubox, k, j, i) {
-    VAR_LOOP(nv) us[nv] = UU[nv][k][j][i]; 
-    q[k][j][i] = us[RHO];
+  npt = (Ubox->ie - Ubox->ib + 1)*(Ubox->je - Ubox->jb + 1)
+                                 *(Ubox->ke - Ubox->kb + 1);
+  for (n = 0; n < npt; n++) {
+    q[n] = UU[RHO][n];
   }
-
 }
 #undef REF_CRIT
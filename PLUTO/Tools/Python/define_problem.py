@@ -473,6 +473,10 @@ class DefineProblem(object):
 
         if 'EXPLICIT' in self.mod_default:
             self.additional_files.append('parabolic_flux.o')
+
+        if 'SELF_GRAVITY' in self.udef_const:
+            if self.udef_const_vals[self.udef_const.index('SELF_GRAVITY')] == 'YES':
+                self.additional_files.append('self_gravity.o')
         
         
     def AppendPlutoPathAndFlags(self):
@@ -519,6 +523,14 @@ class DefineProblem(object):
             else:
                 self.pluto_path.append('Cooling/'+ cool_mode +'/')
 
+        if 'INCLUDE_PARTICLES' in self.udef_const:
+            if self.udef_const_vals[self.udef_const.index('INCLUDE_PARTICLES')] == 'YES':
+                self.pluto_path.append('Particles/')
+
+        if 'NESTED_LEVELS' in self.udef_const:
+            if self.udef_const_vals[self.udef_const.index('NESTED_LEVELS')] != '0':
+                self.pluto_path.append('Nested/')
+
         if 'EOS' in self.mod_entries:
             if 'PVTE_LAW' in self.mod_default:
                 tmp1 = 'PVTE'